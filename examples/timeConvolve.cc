@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <ctime>
 
 #include "lsst/utils/Utils.h"
@@ -31,9 +32,12 @@
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/KernelFunctions.h"
+#include "lsst/afw/math/ConvolveImage.h"
+#include "lsst/afw/math/detail/ConvolveRows.h"
 
 namespace afwImage = lsst::afw::image;
 namespace afwMath = lsst::afw::math;
+namespace afwMathDetail = lsst::afw::math::detail;
 
 typedef float ImageType;
 typedef double KernelType;
@@ -44,59 +48,87 @@ const unsigned MinKernelSize = 5;
 const unsigned MaxKernelSize = 15;
 const unsigned DeltaKernelSize = 5;
 
-template <class ImageClass>
-void timeConvolution(ImageClass &image, unsigned int nIter) {
-    typedef double KernelType;
+/*
+ * Return the time to perform one convolution (sec)
+ */
+template <class ImageClass, class KernelClass>
+double timeOneConvolution(ImageClass &resImage, ImageClass const &image, KernelClass const &kernel,
+                          unsigned int nIter) {
+    clock_t startTime = clock();
+    for (unsigned int iter = 0; iter < nIter; ++iter) {
+        // convolve
+        afwMath::convolve(resImage, image, kernel, true);
+    }
+    // separate casts for CLOCKS_PER_SEC and nIter avoids incorrect results, perhaps due to overflow
+    return (clock() - startTime) / (static_cast<double>(CLOCKS_PER_SEC) * static_cast<double>(nIter));
+}
 
+/*
+ * Time convolution with one kernel, with and without SIMD instructions, and print the results
+ */
+template <class ImageClass, class KernelClass>
+void timeKernel(ImageClass &resImage, ImageClass const &image, KernelClass const &kernel,
+                unsigned int nIter) {
     unsigned imWidth = image.getWidth();
     unsigned imHeight = image.getHeight();
+    unsigned kWidth = kernel.getWidth();
+    unsigned kHeight = kernel.getHeight();
+
+    afwMathDetail::setConvolveRowsSimdEnabled(false);
+    double scalarSecPerIter = timeOneConvolution(resImage, image, kernel, nIter);
+    afwMathDetail::setConvolveRowsSimdEnabled(true);
+    double secPerIter = timeOneConvolution(resImage, image, kernel, nIter);
+
+    double mOps =
+            static_cast<double>((imHeight + 1 - kHeight) * (imWidth + 1 - kWidth) * kWidth * kHeight) / 1.0e6;
+    double mOpsPerSec = mOps / secPerIter;
+    std::cout << imWidth << "\t" << imHeight << "\t" << kWidth << "\t" << kHeight << "\t" << mOps << "\t"
+              << secPerIter << "\t" << mOpsPerSec << "\t" << scalarSecPerIter << "\t"
+              << scalarSecPerIter / secPerIter << std::endl;
+}
+
+template <class ImageClass>
+void timeConvolution(ImageClass &image, unsigned int nIter) {
+    typedef double KernelType;
 
     ImageClass resImage(image.getDimensions());
 
+    std::string const header = "ImWid\tImHt\tKerWid\tKerHt\tMOps\tCnvSec\tMOpsPerSec\tScalarSec\tSpeedup";
+
     std::cout << std::endl << "Analytic Kernel" << std::endl;
-    std::cout << "ImWid\tImHt\tKerWid\tKerHt\tMOps\tCnvSec\tMOpsPerSec" << std::endl;
+    std::cout << header << std::endl;
 
     for (unsigned kSize = MinKernelSize; kSize <= MaxKernelSize; kSize += DeltaKernelSize) {
         // construct kernel
         afwMath::GaussianFunction2<KernelType> gaussFunc(Sigma, Sigma, 0);
         afwMath::AnalyticKernel analyticKernel(kSize, kSize, gaussFunc);
 
-        clock_t startTime = clock();
-        for (unsigned int iter = 0; iter < nIter; ++iter) {
-            // convolve
-            afwMath::convolve(resImage, image, analyticKernel, true);
-        }
-        // separate casts for CLOCKS_PER_SEC and nIter avoids incorrect results, perhaps due to overflow
-        double secPerIter =
-                (clock() - startTime) / (static_cast<double>(CLOCKS_PER_SEC) * static_cast<double>(nIter));
-        double mOps =
-                static_cast<double>((imHeight + 1 - kSize) * (imWidth + 1 - kSize) * kSize * kSize) / 1.0e6;
-        double mOpsPerSec = mOps / secPerIter;
-        std::cout << imWidth << "\t" << imHeight << "\t" << kSize << "\t" << kSize << "\t" << mOps << "\t"
-                  << secPerIter << "\t" << mOpsPerSec << std::endl;
+        timeKernel(resImage, image, analyticKernel, nIter);
+    }
+
+    std::cout << std::endl << "Fixed Kernel" << std::endl;
+    std::cout << header << std::endl;
+
+    for (unsigned kSize = MinKernelSize; kSize <= MaxKernelSize; kSize += DeltaKernelSize) {
+        // construct kernel
+        afwMath::GaussianFunction2<KernelType> gaussFunc(Sigma, Sigma, 0);
+        afwMath::AnalyticKernel analyticKernel(kSize, kSize, gaussFunc);
+        afwImage::Image<KernelType> kernelImage(analyticKernel.getDimensions());
+        analyticKernel.computeImage(kernelImage, true);
+        afwMath::FixedKernel fixedKernel(kernelImage);
+
+        timeKernel(resImage, image, fixedKernel, nIter);
     }
 
     std::cout << std::endl << "Separable Kernel" << std::endl;
-    std::cout << "ImWid\tImHt\tKerWid\tKerHt\tMOps\tCnvSec\tMOpsPerSec" << std::endl;
+    std::cout << header << std::endl;
 
     for (unsigned kSize = MinKernelSize; kSize <= MaxKernelSize; kSize += DeltaKernelSize) {
         // construct kernel
         afwMath::GaussianFunction1<KernelType> gaussFunc(Sigma);
         afwMath::SeparableKernel separableKernel(kSize, kSize, gaussFunc, gaussFunc);
 
-        clock_t startTime = clock();
-        for (unsigned int iter = 0; iter < nIter; ++iter) {
-            // convolve
-            afwMath::convolve(resImage, image, separableKernel, true);
-        }
-        double secPerIter =
-                (clock() - startTime) / (static_cast<double>(CLOCKS_PER_SEC) * static_cast<double>(nIter));
-
-        double mOps =
-                static_cast<double>((imHeight + 1 - kSize) * (imWidth + 1 - kSize) * kSize * kSize) / 1.0e6;
-        double mOpsPerSec = mOps / secPerIter;
-        std::cout << imWidth << "\t" << imHeight << "\t" << kSize << "\t" << kSize << "\t" << mOps << "\t"
-                  << secPerIter << "\t" << mOpsPerSec << std::endl;
+        timeKernel(resImage, image, separableKernel, nIter);
     }
 }
 
@@ -131,6 +163,10 @@ int main(int argc, char **argv) {
     std::cout << "  * one OR (for the mask)" << std::endl;
     std::cout << "  * four pixel pointer increments (for image, variance, mask and kernel)" << std::endl;
     std::cout << "* CnvSec: time to perform one convolution (sec)" << std::endl;
+    std::cout << "* ScalarSec: time to perform one convolution without SIMD instructions (sec)" << std::endl;
+    std::cout << "* Speedup: ScalarSec / CnvSec; SIMD instructions are only used for Images" << std::endl;
+    std::cout << "  of float or double pixels convolved with a spatially invariant kernel" << std::endl;
+    std::cout << "SIMD instruction set: " << afwMathDetail::getConvolveRowsInstructionSet() << std::endl;
 
     std::cout << std::endl << "Image " << inImagePath << std::endl;
     afwImage::Image<ImageType> image(inImagePath);
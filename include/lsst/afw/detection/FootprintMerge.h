@@ -49,8 +49,8 @@ class FootprintMerge;
  *  existing FootprintMerge, the Footprint will be added to it.  If not, then a new FootprintMerge will be
  *  created and added to the vector.
  *
- *  The search algorithm uses a brute force approach over the current list.  This should be fine if we
- *  are operating on smallish number of objects, such as at the tract level.
+ *  Candidate overlaps are found with an R-tree of the (bounding boxes of the) current merges, so adding
+ *  a catalog costs O(N log M) bounding box comparisons for N new and M existing objects.
  *
  */
 class FootprintMergeList final {
@@ -102,10 +102,14 @@ public:
      *  that are farther away than minNewPeakDist to the nearest existing peak.
      *
      *  The SourceTable is used to create new SourceRecords that store the filter information.
+     *
+     *  The overlap tests between the new objects and the existing FootprintMerges are done with up to
+     *  nThreads threads; the objects are then added in order, so the result does not depend on nThreads.
      */
     void addCatalog(std::shared_ptr<afw::table::SourceTable> sourceTable,
                     afw::table::SourceCatalog const &inputCat, std::string const &filter,
-                    float minNewPeakDist = -1., bool doMerge = true, float maxSamePeakDist = -1.);
+                    float minNewPeakDist = -1., bool doMerge = true, float maxSamePeakDist = -1.,
+                    int nThreads = 1);
 
     /**
      *  Clear entries in the current vector
@@ -62,10 +62,12 @@ public:
      * @param threshold threshold to find objects
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
+     * @param nThreads maximum number of threads to use; 0 for one per hardware thread.
+     *                 The result does not depend on the number of threads.
      */
     template <typename ImagePixelT>
     FootprintSet(image::Image<ImagePixelT> const& img, Threshold const& threshold, int const npixMin = 1,
-                 bool const setPeaks = true);
+                 bool const setPeaks = true, int const nThreads = 1);
 
     /**
      * Find a FootprintSet given a Mask and a threshold
@@ -73,9 +75,12 @@ public:
      * @param img Image to search for objects
      * @param threshold threshold to find objects
      * @param npixMin minimum number of pixels in an object
+     * @param nThreads maximum number of threads to use; 0 for one per hardware thread.
+     *                 The result does not depend on the number of threads.
      */
     template <typename MaskPixelT>
-    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1);
+    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1,
+                 int const nThreads = 1);
 
     /**
      * Find a FootprintSet given a MaskedImage and a threshold
@@ -94,10 +99,13 @@ public:
      * @param planeName mask plane to set (if != "")
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
+     * @param nThreads maximum number of threads to use; 0 for one per hardware thread.
+     *                 The result does not depend on the number of threads.
      */
     template <typename ImagePixelT, typename MaskPixelT>
     FootprintSet(image::MaskedImage<ImagePixelT, MaskPixelT> const& img, Threshold const& threshold,
-                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true);
+                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true,
+                 int const nThreads = 1);
 
     /**
      * Construct an empty FootprintSet given a region that its footprints would have lived in
@@ -111,7 +119,18 @@ public:
      * @param rhs the input FootprintSet
      */
     FootprintSet(FootprintSet const& rhs);
-    FootprintSet(FootprintSet const& set, int rGrow, FootprintControl const& ctrl);
+    /**
+     * Grow all the Footprints in the input FootprintSet, returning a new FootprintSet
+     *
+     * The output FootprintSet may contain fewer Footprints, as some may well have been merged
+     *
+     * @param set the input FootprintSet
+     * @param rGrow Grow Footprints by r pixels
+     * @param ctrl Control the shape of the grow
+     * @param nThreads Maximum number of threads to use; 0 for one per hardware thread.  The result
+     *                 is the same for any number of threads
+     */
+    FootprintSet(FootprintSet const& set, int rGrow, FootprintControl const& ctrl, int nThreads = 1);
     FootprintSet(FootprintSet&& rhs);
     ~FootprintSet();
     /**
@@ -122,10 +141,12 @@ public:
      * @param set the input FootprintSet
      * @param rGrow Grow Footprints by r pixels
      * @param isotropic Grow isotropically (as opposed to a Manhattan metric)
+     * @param nThreads Maximum number of threads to use; 0 for one per hardware thread.  The result
+     *                 is the same for any number of threads
      *
      * @note Isotropic grows are significantly slower
      */
-    FootprintSet(FootprintSet const& set, int rGrow, bool isotropic = true);
+    FootprintSet(FootprintSet const& set, int rGrow, bool isotropic = true, int nThreads = 1);
     /**
      * Return the FootprintSet corresponding to the merge of two input FootprintSets
      *
@@ -220,12 +241,17 @@ public:
      * @param tGrow No. of pixels to grow this Footprints
      * @param rGrow No. of pixels to grow rhs Footprints
      * @param isotropic Use (expensive) isotropic grow
+     * @param nThreads Maximum number of threads to use; 0 for one per hardware thread
      */
-    void merge(FootprintSet const& rhs, int tGrow = 0, int rGrow = 0, bool isotropic = true);
+    void merge(FootprintSet const& rhs, int tGrow = 0, int rGrow = 0, bool isotropic = true,
+               int nThreads = 1);
 
     /**
      * Convert all the Footprints in the FootprintSet to be HeavyFootprint%s
      *
+     * The pixels of all the HeavyFootprints are held in a single buffer for each plane; see
+     * makeHeavyFootprints.
+     *
      * @param mimg the image providing pixel values
      * @param ctrl Control how we manipulate HeavyFootprints
      */
@@ -107,6 +107,15 @@ private:
     lsst::geom::Box2I doComputeBBox(lsst::geom::Point2D const& position,
                                     image::Color const& color) const override;
 
+    // A GaussianPsf is the same everywhere, so these just fill in the single-position results
+    ndarray::Array<double, 1, 1> doComputeApertureFluxes(
+            double radius, std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors) const override;
+
+    std::vector<geom::ellipses::Quadrupole> doComputeShapes(
+            std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors) const override;
+
     lsst::geom::Extent2I _dimensions;
     double _sigma;
 };
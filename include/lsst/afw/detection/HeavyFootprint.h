@@ -31,6 +31,7 @@
 #include <list>
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "lsst/afw/detection/Footprint.h"
 
 namespace lsst {
@@ -74,6 +75,23 @@ public:
      */
     explicit HeavyFootprint(Footprint const& foot, HeavyFootprintCtrl const* ctrl = NULL);
 
+    /**
+     * Create a HeavyFootprint from a regular Footprint and arrays holding its pixel values
+     *
+     * The arrays are shared, not copied, so they may be views into a larger buffer holding the
+     * pixels of many HeavyFootprints.
+     *
+     * @param foot The Footprint defining the pixels
+     * @param image The image pixel values, in the order of foot's Spans
+     * @param mask The mask pixel values, in the order of foot's Spans
+     * @param variance The variance pixel values, in the order of foot's Spans
+     *
+     * @throws lsst::pex::exceptions::LengthError if the size of any array is not foot.getArea()
+     */
+    HeavyFootprint(Footprint const& foot, ndarray::Array<ImagePixelT, 1, 1> const& image,
+                   ndarray::Array<MaskPixelT, 1, 1> const& mask,
+                   ndarray::Array<VariancePixelT, 1, 1> const& variance);
+
     /**
      * Default constructor for HeavyFootprint. Most common use for this will be in combination
      * with the assignment operator
@@ -152,6 +170,23 @@ HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> makeHeavyFootprint(
     return HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>(foot, img, ctrl);
 }
 
+/**
+ * Create HeavyFootprints for a list of Footprints, with pixel values from the given MaskedImage.
+ *
+ * Rather than allocating arrays for each HeavyFootprint, the pixels of all of them are stored in a single
+ * buffer for each plane, in the order of the input Footprints; each HeavyFootprint holds a view into
+ * those buffers.
+ *
+ * @param footprints The Footprints defining the pixels to set
+ * @param mimage The pixel values
+ * @param ctrl Control how we manipulate HeavyFootprints
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> > > makeHeavyFootprints(
+        std::vector<std::shared_ptr<Footprint> > const& footprints,
+        lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage,
+        HeavyFootprintCtrl const* ctrl = NULL);
+
 /**
  * Sum the two given HeavyFootprints *h1* and *h2*, returning a
  * HeavyFootprint with the union footprint, and summed pixels where
@@ -25,11 +25,12 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <memory>
 
+#include "ndarray.h"
 #include "lsst/daf/base/Citizen.h"
-#include "lsst/utils/CacheFwd.h"
 #include "lsst/afw/geom/ellipses/Quadrupole.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/Color.h"
@@ -40,9 +41,12 @@ namespace afw {
 namespace detection {
 namespace detail {
 
-/// Key for caching PSFs with lsst::utils::Cache
+/// Key for caching PSFs with PsfCache
 struct PsfCacheKey;
 
+/// Thread-safe cache of PSF images
+class PsfCache;
+
 }  // namespace detail
 
 /**
@@ -68,6 +72,13 @@ struct PsfCacheKey;
  *  passed around and shared between objects without concern for whether they will be
  *  unexpectedly modified.
  *
+ *  The images returned by computeImage() and computeKernelImage() are cached, and the caches may be
+ *  used from multiple threads at once, so one Psf may be shared by threads measuring the same
+ *  exposure; derived classes must then make their doCompute* member functions safe to call
+ *  concurrently (as they should be, being const).  Images returned with INTERNAL are shared with
+ *  other threads, so they must not be copied (nor their arrays) while other threads may use the Psf;
+ *  use COPY to get an image that can be.
+ *
  *  In most cases, Psf derived classes should inherit from meas::algorithms::ImagePsf
  *  or meas::algorithms::KernelPsf, as these will provide default implementions for
  *  several member functions.
@@ -92,6 +103,13 @@ public:
                       */
     };
 
+    /// Counts of the uses of a Psf's image and kernel image caches, summed over both caches
+    struct CacheStatistics {
+        std::size_t hits;       ///< Number of images found in a cache
+        std::size_t misses;     ///< Number of images that had to be computed
+        std::size_t evictions;  ///< Number of images removed from a cache to make room for others
+    };
+
     Psf(Psf const&);
     Psf& operator=(Psf const&) = delete;
     Psf& operator=(Psf&&) = delete;
@@ -132,7 +150,7 @@ public:
      *  @param[in]  owner        Whether to copy the return value or return an internal image that
      *                           must be handled with care (see ImageOwnerEnum).
      *
-     *  The Psf class caches the most recent return value of computeImage, so repeated calls
+     *  The Psf class caches recent return values of computeImage, so repeated calls
      *  with the same arguments will be highly optimized.
      *
      *  @note The real work is done in the virtual private member function Psf::doComputeImage;
@@ -158,7 +176,7 @@ public:
      *  @param[in]  owner        Whether to copy the return value or return an internal image that
      *                           must be handled with care (see ImageOwnerEnum).
      *
-     *  The Psf class caches the most recent return value of computeKernelImage, so repeated calls
+     *  The Psf class caches recent return values of computeKernelImage, so repeated calls
      *  with the same arguments will be highly optimized.
      *
      *  @note The real work is done in the virtual private member function Psf::doComputeKernelImage;
@@ -209,6 +227,50 @@ public:
     geom::ellipses::Quadrupole computeShape(lsst::geom::Point2D position = makeNullPoint(),
                                             image::Color color = image::Color()) const;
 
+    /**
+     *  Return Images of the PSF at many positions, in a form suitable for convolution.
+     *
+     *  This is equivalent to calling computeKernelImage for each position, but the images that are
+     *  not already cached are computed by a single call to the virtual member function
+     *  doComputeKernelImages, which derived classes may override to share work between positions.
+     *
+     *  @param[in]  positions    Positions to evaluate the PSF at; NaN positions are replaced by
+     *                           getAveragePosition().
+     *  @param[in]  colors       Colors of the sources, one for each position; if empty,
+     *                           getAverageColor() is used for all of them.
+     *  @param[in]  owner        Whether to copy the returned images or return internal images that
+     *                           must be handled with care (see ImageOwnerEnum).
+     *
+     *  @throws lsst::pex::exceptions::LengthError if colors is not empty and its size differs from
+     *          that of positions.
+     */
+    std::vector<std::shared_ptr<Image>> computeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors = std::vector<image::Color>(),
+            ImageOwnerEnum owner = COPY) const;
+
+    /**
+     *  Compute the "flux" of the Psf model within a circular aperture at many positions.
+     *
+     *  This is equivalent to calling computeApertureFlux for each position, but is implemented by a
+     *  single call to the virtual member function doComputeApertureFluxes.  The arguments are as for
+     *  computeKernelImages.
+     */
+    ndarray::Array<double, 1, 1> computeApertureFluxes(
+            double radius, std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors = std::vector<image::Color>()) const;
+
+    /**
+     *  Compute the ellipses corresponding to the second moments of the Psf at many positions.
+     *
+     *  This is equivalent to calling computeShape for each position, but is implemented by a single
+     *  call to the virtual member function doComputeShapes.  The arguments are as for
+     *  computeKernelImages.
+     */
+    std::vector<geom::ellipses::Quadrupole> computeShapes(
+            std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors = std::vector<image::Color>()) const;
+
     /**
      *  Return a FixedKernel corresponding to the Psf image at the given point.
      *
@@ -270,9 +332,17 @@ public:
     /** Set the capacity of the caches
      *
      * Both the image and kernel image caches will be set to this capacity.
+     *
+     * Unlike the other member functions, this must not be called while other threads are using the Psf.
      */
     void setCacheCapacity(std::size_t capacity);
 
+    /// Return the counts of cache hits, misses and evictions since construction or the last reset
+    CacheStatistics getCacheStatistics() const;
+
+    /// Reset the counts returned by getCacheStatistics to zero
+    void resetCacheStatistics();
+
 protected:
     /**
      *  Main constructor for subclasses.
@@ -304,10 +374,26 @@ private:
                                             image::Color const& color) const = 0;
     //@}
 
+    //@{
+    /**
+     *  Batch versions of the above, called by computeKernelImages, computeApertureFluxes and
+     *  computeShapes with positions and colors of the same size (with defaults already applied).
+     *
+     *  The default implementations call the single-position member functions for each position;
+     *  derived classes may override them to share work between positions.
+     */
+    virtual std::vector<std::shared_ptr<Image>> doComputeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions, std::vector<image::Color> const& colors) const;
+    virtual ndarray::Array<double, 1, 1> doComputeApertureFluxes(
+            double radius, std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors) const;
+    virtual std::vector<geom::ellipses::Quadrupole> doComputeShapes(
+            std::vector<lsst::geom::Point2D> const& positions, std::vector<image::Color> const& colors) const;
+    //@}
+
     bool const _isFixed;
-    using PsfCache = utils::Cache<detail::PsfCacheKey, std::shared_ptr<Image>>;
-    std::unique_ptr<PsfCache> _imageCache;
-    std::unique_ptr<PsfCache> _kernelImageCache;
+    std::unique_ptr<detail::PsfCache> _imageCache;
+    std::unique_ptr<detail::PsfCache> _kernelImageCache;
 };
 }  // namespace detection
 }  // namespace afw
@@ -15,6 +15,7 @@
 
 #include <climits>
 #include <string>
+#include <vector>
 
 #include <boost/format.hpp>
 
@@ -244,6 +245,8 @@ struct ImageWriteOptions {
     /// * compression.columns (int): number of columns per tile (0 = entire dimension)
     /// * compression.rows (int): number of rows per tile (0 = 1 row; that's what cfitsio does)
     /// * compression.quantizeLevel (float): cfitsio quantization level
+    /// * compression.nThreads (int): maximum number of threads for compressing tiles (0 = one per hardware
+    ///   thread)
     /// * scaling.scheme (string): scaling algorithm to use
     /// * scaling.bitpix (int): bits per pixel (0, 8,16,32,64,-32,-64)
     /// * scaling.fuzz (bool): fuzz the values when quantising floating-point values?
@@ -256,9 +259,10 @@ struct ImageWriteOptions {
     ///
     /// Use the 'validate' method to set default values for the above.
     ///
-    /// 'scaling.maskPlanes' is the only entry that is allowed to be missing
-    /// (because PropertySet can't represent an empty array); when it is missing,
-    /// it is interpreted as an empty array.
+    /// 'scaling.maskPlanes' and 'compression.nThreads' are the only entries that
+    /// are allowed to be missing; a missing 'scaling.maskPlanes' (which PropertySet
+    /// can't represent when empty) is interpreted as an empty array, and a missing
+    /// 'compression.nThreads' as a single thread.
     ///
     /// @param[in] config  Configuration of image write options
     ImageWriteOptions(daf::base::PropertySet const& config);
@@ -585,6 +589,9 @@ public:
     /// Write a string to a binary table.
     void writeTableScalar(std::size_t row, int col, std::string const& value);
 
+    /// Write strings to consecutive rows of a fixed-length string column, starting at the given row.
+    void writeTableStrings(std::size_t row, int col, std::vector<std::string> const& values);
+
     /// Read an array value from a binary table.
     template <typename T>
     void readTableArray(std::size_t row, int col, int nElements, T* value);
@@ -604,6 +611,14 @@ public:
     /// Return the size of an variable-length array field.
     long getTableArraySize(std::size_t row, int col);
 
+    /**
+     *  Return the sizes of a variable-length array column in every row of the table.
+     *
+     *  This reads all the array descriptors at once, which is much faster than calling
+     *  getTableArraySize(row, col) for each row.
+     */
+    std::vector<long> getTableArraySizes(int col);
+
     /// Default constructor; set all data members to 0.
     Fits() : fptr(0), status(0), behavior(0) {}
 
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 
 #include "boost/cstdfloat.hpp"
 
@@ -174,6 +175,16 @@ std::shared_ptr<PixelArrayBase> makePixelArray(int bitpix, ndarray::Array<T, 1,
 /// * the compression algorithm
 /// * the tile size
 /// * the quantization level (for quantization applied by cfitsio; for floating-point images)
+/// * the number of threads to use for compressing tiles
+///
+/// cfitsio compresses the tiles one after another. If more than one thread is requested,
+/// the tiles are instead compressed independently in parallel (using cfitsio's own
+/// compression routines, so the file is the same as cfitsio would write) and the
+/// compressed tiles are then written to the file. This is supported for GZIP,
+/// GZIP_SHUFFLE and RICE compression of 8, 16 and 32-bit integer pixels (including
+/// floating-point images quantised through the ImageScalingOptions), and for GZIP and
+/// GZIP_SHUFFLE compression of unquantised floating-point pixels; other cases are left
+/// to cfitsio.
 ///
 /// Due to bugs, cfitsio may require setting the quantizeLevel to a value other than
 /// zero when compressing integer data, but in this case it should have no effect.
@@ -196,15 +207,22 @@ struct ImageCompressionOptions {
     CompressionAlgorithm algorithm;  ///< Compresion algorithm to use
     Tiles tiles;          ///< Tile size; a dimension with 0 means infinite (e.g., to specify one row: 0,1)
     float quantizeLevel;  ///< quantization level: 0.0 = none requires use of GZIP or GZIP_SHUFFLE
+    int nThreads;         ///< Maximum number of threads for compressing tiles; 0 for one per hardware thread
 
     /// Custom compression
     explicit ImageCompressionOptions(CompressionAlgorithm algorithm_, Tiles tiles_,
-                                     float quantizeLevel_ = 0.0)
-            : algorithm(algorithm_), tiles(ndarray::copy(tiles_)), quantizeLevel(quantizeLevel_) {}
+                                     float quantizeLevel_ = 0.0, int nThreads_ = 1)
+            : algorithm(algorithm_),
+              tiles(ndarray::copy(tiles_)),
+              quantizeLevel(quantizeLevel_),
+              nThreads(nThreads_) {}
 
     explicit ImageCompressionOptions(CompressionAlgorithm algorithm_, std::vector<long> tiles_,
-                                     float quantizeLevel_ = 0.0)
-            : algorithm(algorithm_), tiles(ndarray::allocate(tiles_.size())), quantizeLevel(quantizeLevel_) {
+                                     float quantizeLevel_ = 0.0, int nThreads_ = 1)
+            : algorithm(algorithm_),
+              tiles(ndarray::allocate(tiles_.size())),
+              quantizeLevel(quantizeLevel_),
+              nThreads(nThreads_) {
         std::copy(tiles_.cbegin(), tiles_.cend(), tiles.begin());
     }
 
@@ -213,8 +231,9 @@ struct ImageCompressionOptions {
     /// @param[in] algorithm_  Compression algorithm to use
     /// @param[in] rows  Number of rows per tile (0 = entire image)
     /// @param[in] quantizeLevel_  cfitsio quantization level
+    /// @param[in] nThreads_  Maximum number of threads for compressing tiles; 0 for one per hardware thread
     explicit ImageCompressionOptions(CompressionAlgorithm algorithm_, int rows = 1,
-                                     float quantizeLevel_ = 0.0);
+                                     float quantizeLevel_ = 0.0, int nThreads_ = 1);
 
     /// Default compression for a particular style of image
     ///
@@ -249,6 +268,41 @@ ImageCompressionOptions::CompressionAlgorithm compressionAlgorithmFromCfitsio(in
 /// Convert ImageCompressionOptions::CompressionAlgorithm to cfitsio
 int compressionAlgorithmToCfitsio(ImageCompressionOptions::CompressionAlgorithm algorithm);
 
+namespace detail {
+
+/// Return the dimensions of the compression tiles for an image, as cfitsio would choose them
+///
+/// A tile width of zero (or less) means the full width of the image; a tile height of zero means
+/// a single row, and less than zero the full height of the image. Tiles are no larger than the image.
+///
+/// @param[in] tiles  Requested tile dimensions (ImageCompressionOptions::tiles).
+/// @param[in] width  Width of the image.
+/// @param[in] height  Height of the image.
+/// @return Tile width and height.
+ndarray::Vector<long, 2> computeTileShape(ndarray::Array<long, 1> const& tiles, long width, long height);
+
+/// Return whether compressTiles supports the compression options for pixels with the given BITPIX
+///
+/// @param[in] options  Compression options.
+/// @param[in] bitpix  Bits per pixel (8,16,32,64,-32,-64) of the pixels to compress.
+bool isTileCompressionSupported(ImageCompressionOptions const& options, int bitpix);
+
+/// Compress the tiles of an image
+///
+/// The tiles are compressed independently, using up to options.nThreads threads, exactly as cfitsio
+/// compresses them when writing a tile-compressed image.
+///
+/// @param[in] options  Compression options; must be supported for bitpix (see isTileCompressionSupported).
+/// @param[in] bitpix  Bits per pixel (8,16,32,-32,-64) of the pixels.
+/// @param[in] pixels  Pixel values, of the type corresponding to bitpix, in row-major order.
+/// @param[in] width  Width of the image.
+/// @param[in] height  Height of the image.
+/// @return The compressed bytes of each tile, in the order of the rows of a tile-compressed image HDU.
+std::vector<std::vector<unsigned char>> compressTiles(ImageCompressionOptions const& options, int bitpix,
+                                                      PixelArrayBase const& pixels, long width, long height);
+
+}  // namespace detail
+
 /// Scale to apply to image
 ///
 /// Images are scaled to the type implied by the provided BITPIX
@@ -0,0 +1,193 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
+#define LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "ndarray.h"
+
+#include "lsst/geom/Angle.h"
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Point.h"
+#include "lsst/geom/SpherePoint.h"
+#include "lsst/afw/geom/SkyWcs.h"
+
+namespace lsst { namespace afw { namespace geom {
+
+/**
+ *  A fast approximation to a SkyWcs over a bounding box, with a bounded maximum error.
+ *
+ *  Evaluating a SkyWcs calls its AST mapping, which is expensive for each point.  This class
+ *  evaluates the exact pixelToSky on a regular grid of points covering a bounding box and projects
+ *  the results onto the gnomonic (tangent) plane at the center of the box, where the mapping is
+ *  smooth.  Positions are then computed by bicubic (4x4 point Lagrange) interpolation of the tangent
+ *  plane coordinates and an exact deprojection.
+ *
+ *  The angular error of the approximation is measured at the center of every grid cell and the
+ *  midpoint of every cell edge, and the grid is refined (the grid step halved) until twice the largest
+ *  of these errors is no greater than the requested maximum error.  For a mapping that is smooth on the
+ *  scale of the grid, the interpolation error inside a cell is at most slightly larger than at these
+ *  points (by about 7% on a fine grid, in the cells at its edge where the stencil is off-center, and by
+ *  less than 40% on the coarsest grids), so twice the measured error bounds the error at any point
+ *  inside the bounding box.  Mappings with structure on smaller scales than the grid step can violate
+ *  this bound.  Points outside the bounding box are extrapolated, with no guarantee of accuracy.
+ *
+ *  skyToPixel is computed by Newton iteration on the approximate pixelToSky, so it is consistent with
+ *  the approximate pixelToSky to rounding error; its error with respect to the exact SkyWcs is the
+ *  angular error divided by the local pixel scale.
+ */
+class SkyWcsApproximation final {
+public:
+
+    /**
+     *  Construct an approximation to a SkyWcs.
+     *
+     *  @param[in]  wcs             The SkyWcs to approximate.
+     *  @param[in]  bbox            Pixel-coordinate bounding box over which the approximation
+     *                              should be accurate.
+     *  @param[in]  maxError        Maximum allowed angular error of pixelToSky.
+     *  @param[in]  maxGridSize     Maximum number of grid points along either axis.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError Thrown if bbox has zero area,
+     *      maxError is not positive or maxGridSize < 5.
+     *  @throws lsst::pex::exceptions::RuntimeError Thrown if the requested accuracy cannot be
+     *      reached without exceeding maxGridSize, or if the bounding box covers too large an area
+     *      of the sky to be projected onto a tangent plane.
+     */
+    SkyWcsApproximation(
+        SkyWcs const & wcs,
+        lsst::geom::Box2D const & bbox,
+        lsst::geom::Angle const & maxError = 0.001*lsst::geom::arcseconds,
+        int maxGridSize = 1025
+    );
+
+    SkyWcsApproximation(SkyWcsApproximation const &) = default;
+    SkyWcsApproximation(SkyWcsApproximation &&) = default;
+    SkyWcsApproximation & operator=(SkyWcsApproximation const &) = default;
+    SkyWcsApproximation & operator=(SkyWcsApproximation &&) = default;
+    ~SkyWcsApproximation() = default;
+
+    /**
+     *  Compute sky position(s) from pixel position(s)
+     *
+     *  Non-finite pixel positions give NaN sky positions.
+     */
+    //@{
+    lsst::geom::SpherePoint pixelToSky(lsst::geom::Point2D const & pixel) const;
+    std::vector<lsst::geom::SpherePoint> pixelToSky(std::vector<lsst::geom::Point2D> const & pixels) const;
+    //@}
+
+    /**
+     *  Compute sky positions from arrays of pixel positions.
+     *
+     *  @param[in]  x       Pixel x positions.
+     *  @param[in]  y       Pixel y positions; must have the same size as x.
+     *  @param[out] ra      Right ascension (or other longitude) in radians, in [0, 2 pi);
+     *                      must have the same size as x.
+     *  @param[out] dec     Declination (or other latitude) in radians; must have the same size as x.
+     *
+     *  @throws lsst::pex::exceptions::LengthError Thrown if the array sizes do not match.
+     */
+    void pixelToSky(
+        ndarray::Array<double const, 1> const & x,
+        ndarray::Array<double const, 1> const & y,
+        ndarray::Array<double, 1> const & ra,
+        ndarray::Array<double, 1> const & dec
+    ) const;
+
+    /**
+     *  Compute pixel position(s) from sky position(s)
+     *
+     *  Sky positions that cannot be inverted (because they are on the far side of the sky from the
+     *  bounding box, or the iteration does not converge) give NaN pixel positions.
+     */
+    //@{
+    lsst::geom::Point2D skyToPixel(lsst::geom::SpherePoint const & sky) const;
+    std::vector<lsst::geom::Point2D> skyToPixel(std::vector<lsst::geom::SpherePoint> const & sky) const;
+    //@}
+
+    /**
+     *  Compute pixel positions from arrays of sky positions.
+     *
+     *  @param[in]  ra      Right ascension (or other longitude) in radians.
+     *  @param[in]  dec     Declination (or other latitude) in radians; must have the same size as ra.
+     *  @param[out] x       Pixel x positions; must have the same size as ra.
+     *  @param[out] y       Pixel y positions; must have the same size as ra.
+     *
+     *  @throws lsst::pex::exceptions::LengthError Thrown if the array sizes do not match.
+     */
+    void skyToPixel(
+        ndarray::Array<double const, 1> const & ra,
+        ndarray::Array<double const, 1> const & dec,
+        ndarray::Array<double, 1> const & x,
+        ndarray::Array<double, 1> const & y
+    ) const;
+
+    /// Return the bounding box over which the approximation is accurate.
+    lsst::geom::Box2D getBBox() const { return _bbox; }
+
+    /// Return the number of grid points in x and y.
+    lsst::geom::Extent2I getGridShape() const { return lsst::geom::Extent2I(_nx, _ny); }
+
+    /**
+     *  Return the bound on the angular error of pixelToSky inside the bounding box.
+     *
+     *  This is twice the largest error measured when the grid was built, and is no greater than the
+     *  maxError passed to the constructor.
+     */
+    lsst::geom::Angle getMaxError() const { return _maxError*lsst::geom::radians; }
+
+private:
+
+    // Compute tangent plane coordinates (and optionally their derivatives with respect to pixel
+    // position) at a finite pixel position.
+    Eigen::Vector2d _interpolate(double x, double y, Eigen::Matrix2d * jacobian=nullptr) const;
+
+    // Compute tangent plane coordinates of a sky position; returns false if it cannot be projected.
+    bool _project(double ra, double dec, Eigen::Vector2d & tangent) const;
+
+    // Convert tangent plane coordinates to a sky position in radians.
+    void _deproject(Eigen::Vector2d const & tangent, double & ra, double & dec) const;
+
+    void _pixelToSky(double x, double y, double & ra, double & dec) const;
+
+    void _skyToPixel(double ra, double dec, double & x, double & y) const;
+
+    lsst::geom::Box2D _bbox;
+    int _nx;
+    int _ny;
+    double _xStep;
+    double _yStep;
+    double _maxError;                       // bound on the error (twice the measured error), radians
+    Eigen::Vector3d _center;                // unit vector at the tangent point
+    Eigen::Vector3d _xiAxis;                // unit vector along increasing longitude at the tangent point
+    Eigen::Vector3d _etaAxis;               // unit vector along increasing latitude at the tangent point
+    std::vector<double> _xi;                // tangent plane coordinates at grid points; x varies fastest
+    std::vector<double> _eta;
+};
+
+}}}  // namespace lsst::afw::geom
+
+#endif // !LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
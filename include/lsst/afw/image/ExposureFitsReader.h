@@ -235,6 +235,17 @@ public:
      *                       this file.
      * @param  allowUnsafe   Permit reading into the requested pixel type even
      *                       when on-disk values may overflow or truncate.
+     * @param  nThreads      Maximum number of threads to use; 0 for one per
+     *                       hardware thread.
+     *
+     * When more than one thread is used, the whole file is read into memory
+     * and the image, mask, and variance planes are then read (and
+     * decompressed) from it concurrently, each through its own handle.  This
+     * is only done when the reader was constructed from the name of a file
+     * on disk that is not compressed as a whole (nor named like one, e.g.
+     * ".gz" or ".fz") and has no filter, the planes are in their standard
+     * HDUs, and cfitsio was built thread-safe; otherwise the planes are read
+     * serially.  The result does not depend on the number of threads.
      *
      * In Python, this templated method is wrapped with an additional `dtype`
      * argument to provide the type to read (for the image plane).  This
@@ -243,7 +254,7 @@ public:
     template <typename ImagePixelT, typename MaskPixelT=MaskPixel, typename VariancePixelT=VariancePixel>
     MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> readMaskedImage(
         lsst::geom::Box2I const & bbox=lsst::geom::Box2I(), ImageOrigin origin=PARENT,
-        bool conformMasks=false, bool allowUnsafe=false
+        bool conformMasks=false, bool allowUnsafe=false, int nThreads=1
     );
 
     /**
@@ -256,6 +267,13 @@ public:
      *                       this file.
      * @param  allowUnsafe   Permit reading into the requested pixel type even
      *                       when on-disk values may overflow or truncate.
+     * @param  nThreads      Maximum number of threads to use; 0 for one per
+     *                       hardware thread.
+     *
+     * When more than one thread is used, the archive HDU holding the Psf,
+     * Wcs, CoaddInputs, and other persisted components is read concurrently
+     * with the three planes, as described for readMaskedImage.  This is most
+     * useful for tile-compressed files, for which decompression dominates.
      *
      * In Python, this templated method is wrapped with an additional `dtype`
      * argument to provide the type to read (for the image plane).  This
@@ -264,7 +282,7 @@ public:
     template <typename ImagePixelT, typename MaskPixelT=MaskPixel, typename VariancePixelT=VariancePixel>
     Exposure<ImagePixelT, MaskPixelT, VariancePixelT> read(
         lsst::geom::Box2I const & bbox=lsst::geom::Box2I(), ImageOrigin origin=PARENT,
-        bool conformMasks=false, bool allowUnsafe=false
+        bool conformMasks=false, bool allowUnsafe=false, int nThreads=1
     );
 
     /**
@@ -279,8 +297,18 @@ private:
 
     void _ensureReaders();
 
+    // Read the three planes (and, if loadArchive is true, the archive HDU) through independent handles
+    // on the file's contents in memory, one per thread; falls back to _maskedImageReader when that is not
+    // possible.
+    template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+    MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> _readMaskedImage(
+        lsst::geom::Box2I const & bbox, ImageOrigin origin, bool conformMasks, bool allowUnsafe,
+        int nThreads, bool loadArchive
+    );
+
     fits::Fits * _getFitsFile() { return _maskedImageReader._getFitsFile(); }
 
+    std::string _fileName;  // empty unless constructed from a file name
     MaskedImageFitsReader _maskedImageReader;
     std::unique_ptr<MetadataReader> _metadataReader;
     std::unique_ptr<ArchiveReader> _archiveReader;
@@ -60,6 +60,16 @@ public:
     Mask<PixelT> read(lsst::geom::Box2I const & bbox=lsst::geom::Box2I(), ImageOrigin origin=PARENT,
                       bool conformMasks=false, bool allowUnsafe=false);
 
+private:
+
+    friend class ExposureFitsReader;
+
+    // Construct a Mask from pixels already read from this reader's HDU, translating its planes to the
+    // global mask plane dictionary (or adopting the file's dictionary if conformMasks is true).
+    template <typename PixelT>
+    Mask<PixelT> _makeMask(ndarray::Array<PixelT, 2, 2> const & array, lsst::geom::Point2I const & xy0,
+                           bool conformMasks);
+
 };
 
 }}} // namespace lsst::afw::image
@@ -72,7 +72,8 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _nThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -98,7 +99,8 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _nThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -129,7 +131,8 @@ public:
               _undersampleStyle(undersampleStyle),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _nThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -161,7 +164,8 @@ public:
               _undersampleStyle(math::stringToUndersampleStyle(undersampleStyle)),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _nThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -223,6 +227,27 @@ public:
     std::shared_ptr<ApproximateControl> getApproximateControl() { return _actrl; }
     std::shared_ptr<ApproximateControl const> getApproximateControl() const { return _actrl; }
 
+    /**
+     * Return the maximum number of threads used to measure the cells and interpolate the background
+     *
+     * 0 means one thread per hardware thread.  The results do not depend on the number of threads.
+     */
+    int getNThreads() const noexcept { return _nThreads; }
+    /**
+     * Set the maximum number of threads used to measure the cells and interpolate the background
+     *
+     * @param nThreads maximum number of threads; 0 for one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0
+     */
+    void setNThreads(int nThreads) {
+        if (nThreads < 0) {
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                              str(boost::format("nThreads = %d < 0") % nThreads));
+        }
+        _nThreads = nThreads;
+    }
+
 private:
     Interpolate::Style _style;           // style of interpolation to use
     int _nxSample;                       // number of grid squares to divide image into to sample in x
@@ -231,6 +256,7 @@ private:
     std::shared_ptr<StatisticsControl> _sctrl;   // statistics control object
     Property _prop;                              // statistics Property
     std::shared_ptr<ApproximateControl> _actrl;  // approximate control object
+    int _nThreads;                               // maximum number of threads; 0 for one per hardware thread
 };
 
 /**
@@ -57,17 +57,64 @@ public:
                        )
             : _doNormalize(doNormalize),
               _doCopyEdge(doCopyEdge),
-              _maxInterpolationDistance(maxInterpolationDistance) {}
+              _maxInterpolationDistance(maxInterpolationDistance),
+              _nThreads(1),
+              _minFftKernelSize(0) {}
 
     bool getDoNormalize() const { return _doNormalize; }
     bool getDoCopyEdge() const { return _doCopyEdge; }
     int getMaxInterpolationDistance() const { return _maxInterpolationDistance; };
+    /**
+     * Get the maximum number of threads used to compute the convolved %image
+     *
+     * The output is divided into bands of rows that are convolved concurrently;
+     * the result is identical to that of a serial convolution.
+     * 1 (the default) means no threading and 0 means one thread per hardware thread.
+     */
+    int getNThreads() const { return _nThreads; }
+    /**
+     * Get the minimum kernel width and height for which a spatially invariant kernel is convolved using FFTs
+     *
+     * FFT convolution is only used when the output %image has floating-point pixels.
+     * 0 (the default) means FFTs are never used; 1 means they are used for all eligible kernels.
+     */
+    int getMinFftKernelSize() const { return _minFftKernelSize; }
 
     void setDoNormalize(bool doNormalize) { _doNormalize = doNormalize; }
     void setDoCopyEdge(bool doCopyEdge) { _doCopyEdge = doCopyEdge; }
     void setMaxInterpolationDistance(int maxInterpolationDistance) {
         _maxInterpolationDistance = maxInterpolationDistance;
     }
+    /**
+     * Set the maximum number of threads used to compute the convolved %image
+     *
+     * @param nThreads maximum number of threads; 0 for one thread per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0
+     */
+    void setNThreads(int nThreads) {
+        if (nThreads < 0) {
+            std::ostringstream os;
+            os << "nThreads = " << nThreads << " < 0";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        _nThreads = nThreads;
+    }
+    /**
+     * Set the minimum kernel width and height for which a spatially invariant kernel is convolved using FFTs
+     *
+     * @param minFftKernelSize minimum kernel width and height; 0 to never use FFTs
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if minFftKernelSize < 0
+     */
+    void setMinFftKernelSize(int minFftKernelSize) {
+        if (minFftKernelSize < 0) {
+            std::ostringstream os;
+            os << "minFftKernelSize = " << minFftKernelSize << " < 0";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        _minFftKernelSize = minFftKernelSize;
+    }
 
 private:
     bool _doNormalize;              ///< normalize the kernel to sum=1?
@@ -75,6 +122,8 @@ private:
                                     ///< instead of setting them to the standard edge pixel?
     int _maxInterpolationDistance;  ///< maximum width or height of a region
                                     ///< over which to attempt interpolation
+    int _nThreads;                  ///< maximum number of threads; 0 for one per hardware thread
+    int _minFftKernelSize;          ///< minimum kernel width and height for FFT convolution; 0 for never
 };
 
 /**
@@ -131,9 +180,14 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  * to the lower left corner of the sub-image, but it will almost certainly change to be
  * the lower left corner of the parent image.
  *
- * All convolution is performed in real space. This allows convolution to handle masked pixels
- * and spatially varying kernels. Although convolution of an Image with a spatially invariant kernel could,
- * in fact, be performed in Fourier space, the code does not do this.
+ * By default all convolution is performed in real space. This allows convolution to handle masked pixels
+ * and spatially varying kernels. Spatially invariant kernels that are not DeltaFunctionKernels or
+ * SeparableKernels (e.g. a FixedKernel or a spatially invariant LinearCombinationKernel) may instead be
+ * convolved using FFTs, which is much faster for large kernels; see ConvolutionControl::setMinFftKernelSize.
+ * The image and variance planes are then convolved in Fourier space, one tile at a time,
+ * and agree with real-space convolution to within double-precision round-off.
+ * The mask plane, and any output pixel that depends on a non-finite input pixel,
+ * are computed exactly as in real space.
  *
  * Note that mask bits are smeared by convolution; all nonzero pixels in the kernel smear the mask, even
  * pixels that have very small values. Larger kernels smear the mask more and are also slower to convolve.
@@ -175,6 +229,9 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  *    of the output. Optimization of convolution for different types of Kernel are handled by different
  *    specializations of basicConvolve().
  *
+ * The good region of the output may be computed by several threads, each handling a band of rows;
+ * see ConvolutionControl::setNThreads. The result does not depend on the number of threads.
+ *
  * afw/examples offers programs that time convolution including timeConvolve and timeSpatiallyVaryingConvolve.
  *
  * @param[out] convolvedImage convolved %image; must be the same size as inImage
@@ -27,7 +27,9 @@
 /*
  * Functions to stack images
  */
+#include <functional>
 #include <vector>
+#include "lsst/geom/Box.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/Mask.h"
 #include "lsst/afw/math/Statistics.h"
@@ -154,6 +156,51 @@ void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,  ///< Output im
                      image::MaskPixel excuse = 0    ///< bitmask to excuse from marking as clipped
 );
 
+/**
+ * A function that returns the part of an input MaskedImage within a bounding box (in PARENT coordinates)
+ *
+ * Used by statisticsStack to stream inputs a block of rows at a time, e.g. by reading a subimage
+ * of a FITS file.
+ */
+template <typename PixelT>
+using MaskedImageBlockReader =
+        std::function<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(lsst::geom::Box2I const&)>;
+
+/**
+ * A function to compute some statistics of a stack of Masked Images that are read a block of rows at a time
+ *
+ * The output is computed in blocks of blockHeight rows; for each block, every reader is called (serially,
+ * in the calling thread) with the bounding box of the block, and the returned images are stacked
+ * as by the statisticsStack overload taking a vector of MaskedImages.  Only one block of each input
+ * need be held in memory at a time.
+ *
+ * @param[out] out      Output MaskedImage; its bounding box determines the bounding boxes requested
+ *                      from the readers.
+ * @param[in] readers   Functions returning each input within a bounding box; each returned image
+ *                      must have the dimensions of that bounding box.
+ * @param[in] flags     Statistics requested.
+ * @param[in] sctrl     Control structure.
+ * @param[in] wvector   Vector of weights.
+ * @param[in] clipped   Mask to set for pixels that were clipped (NOT rejected
+ *                      due to masks).
+ * @param[in] maskMap   Vector of pairs of mask pixel values; any pixel
+ *                      on an input with any of the bits in .first will result
+ *                      in all of the bits in .second being set on the
+ *                      corresponding pixel on the output.
+ * @param[in] blockHeight   Number of rows to read from each input at a time.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if blockHeight <= 0, or if a reader returns
+ *     an image of the wrong dimensions.
+ * @throws lsst::pex::exceptions::RuntimeError if a reader returns a null pointer.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,
+                     std::vector<MaskedImageBlockReader<PixelT>> const& readers, Property flags,
+                     StatisticsControl const& sctrl,
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                     int blockHeight = 256);
+
 /**
  * A function to compute some statistics of a stack of std::vectors
  */
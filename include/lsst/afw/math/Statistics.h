@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <sstream>
 #include "boost/iterator/iterator_adaptor.hpp"
 #include "boost/tuple/tuple.hpp"
 #include <memory>
@@ -109,6 +110,7 @@ public:
               _isNanSafe(isNanSafe),
               _useWeights(useWeights),
               _calcErrorFromInputVariance(false),
+              _nThreads(1),
               _maskPropagationThresholds() {
         try {
             _noGoodPixelsMask = lsst::afw::image::Mask<>::getPlaneBitMask("NO_DATA");
@@ -138,6 +140,13 @@ public:
     bool getWeighted() const noexcept { return _useWeights == WEIGHTS_TRUE ? true : false; }
     bool getWeightedIsSet() const noexcept { return _useWeights != WEIGHTS_NONE ? true : false; }
     bool getCalcErrorFromInputVariance() const noexcept { return _calcErrorFromInputVariance; }
+    /**
+     * Get the maximum number of threads used by functions that compute many statistics at once,
+     * such as statisticsStack
+     *
+     * 1 (the default) means no threading and 0 means one thread per hardware thread.
+     */
+    int getNThreads() const noexcept { return _nThreads; }
 
     void setNumSigmaClip(double numSigmaClip) {
         assert(numSigmaClip > 0);
@@ -154,6 +163,21 @@ public:
     void setCalcErrorFromInputVariance(bool calcErrorFromInputVariance) noexcept {
         _calcErrorFromInputVariance = calcErrorFromInputVariance;
     }
+    /**
+     * Set the maximum number of threads used by functions that compute many statistics at once
+     *
+     * @param nThreads maximum number of threads; 0 for one thread per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0
+     */
+    void setNThreads(int nThreads) {
+        if (nThreads < 0) {
+            std::ostringstream os;
+            os << "nThreads = " << nThreads << " < 0";
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError, os.str());
+        }
+        _nThreads = nThreads;
+    }
 
 private:
     friend class Statistics;
@@ -165,6 +189,7 @@ private:
     bool _isNanSafe;                   // Check for NaNs & Infs before running (slower)
     WeightsBoolean _useWeights;        // Calculate weighted statistics (enum because of 3-valued logic)
     bool _calcErrorFromInputVariance;  // Calculate errors from the input variances, if available
+    int _nThreads;                     // Maximum number of threads; 0 for one per hardware thread
     std::vector<double> _maskPropagationThresholds;  // Thresholds for when to propagate mask bits,
                                                      // treated like a dict (unset bits are set to 1.0)
 };
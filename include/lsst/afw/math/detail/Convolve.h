@@ -148,6 +148,59 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
                             lsst::afw::math::Kernel const& kernel,
                             lsst::afw::math::ConvolutionControl const& convolutionControl);
 
+/**
+ * Return true if convolutionControl selects FFT convolution for this kernel and these images
+ *
+ * FFT convolution is selected for spatially invariant kernels that are at least
+ * ConvolutionControl::getMinFftKernelSize() pixels wide and high,
+ * provided convolvedImage has floating-point pixels.
+ *
+ * @param[in] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ */
+template <typename OutImageT, typename InImageT>
+bool canConvolveWithFft(OutImageT const& convolvedImage, InImageT const& inImage,
+                        lsst::afw::math::Kernel const& kernel,
+                        lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Convolve an Image or MaskedImage with a spatially invariant Kernel using FFTs
+ *
+ * The good region is divided into tiles that are convolved independently (in parallel if
+ * convolutionControl.getNThreads() allows it) using overlap-save, so memory use is bounded
+ * regardless of the image size. The image and variance planes are convolved with the kernel
+ * and its square, respectively; the mask plane is computed directly. Output pixels that depend
+ * on non-finite input image or variance pixels are recomputed directly, so the result matches
+ * convolveWithBruteForce to within round-off.
+ *
+ * convolvedImage must be the same size as inImage.
+ * convolvedImage has a border in which the output pixels are not set. This border has size:
+ * - kernel.getCtrX() along the left edge
+ * - kernel.getCtrY() along the bottom edge
+ * - kernel.getWidth()  - 1 - kernel.getCtrX() along the right edge
+ * - kernel.getHeight() - 1 - kernel.getCtrY() along the top edge
+ *
+ * @param[out] convolvedImage convolved %image; must have floating-point pixels
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel; must be spatially invariant
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel is spatially varying
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage does not have floating-point pixels
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ *
+ * @warning Low-level convolution function that does not set edge pixels.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage,
+                     lsst::afw::math::Kernel const& kernel,
+                     lsst::afw::math::ConvolutionControl const& convolutionControl);
+
 // I would prefer this to be nested in KernelImagesForRegion but SWIG doesn't support that
 class RowOfKernelImagesForRegion;
 
@@ -277,6 +330,20 @@ public:
      */
     static int getMinInterpolationSize() { return _MinInterpolationSize; };
 
+    /**
+     * Compute length of each subregion for a region divided into nDivisions pieces of approximately equal
+     * length.
+     *
+     * The lengths match those of the subregions produced by computeNextRow.
+     *
+     * @param length length of region
+     * @param nDivisions number of divisions of region
+     * @returns a list of subspan lengths
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nDivisions >= length
+     */
+    static std::vector<int> computeSubregionLengths(int length, int nDivisions);
+
 private:
     typedef std::vector<Location> LocationList;
 
@@ -304,17 +371,6 @@ private:
 
     // static helper functions
     static inline int _computeNextSubregionLength(int length, int nDivisions);
-    /**
-     * Compute length of each subregion for a region divided into nDivisions pieces of approximately equal
-     * length.
-     *
-     * @param length length of region
-     * @param nDivisions number of divisions of region
-     * @returns a list of subspan lengths
-     *
-     * @throws lsst::pex::exceptions::InvalidParameterError if nDivisions >= length
-     */
-    static std::vector<int> _computeSubregionLengths(int length, int nDivisions);
 
     // member variables
     KernelConstPtr _kernelPtr;
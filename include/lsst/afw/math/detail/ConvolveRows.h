@@ -0,0 +1,108 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_CONVOLVEROWS_H
+#define LSST_AFW_MATH_DETAIL_CONVOLVEROWS_H
+/*
+ * Vectorized inner loops for convolution of Images with floating-point pixels
+ *
+ * These compute many kernel dot products at once, one per output pixel along a row, using
+ * AVX-512 or AVX2 instructions if the CPU supports them (chosen at run time) and scalar code otherwise.
+ * Each output pixel is computed with exactly the same sequence of floating-point operations as
+ * the scalar dot product used by basicConvolve and convolveWithBruteForce:
+ * terms with a zero kernel value are skipped, each product is computed in double precision,
+ * converted to the output pixel type and added in kernel order. Vectorizing across output pixels
+ * (rather than across the kernel) means the results are bit-identical whichever code path is used.
+ */
+#include <string>
+#include <type_traits>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Are rowDotProducts and columnDotProducts available for this combination of pixel types?
+ *
+ * They are for (output, input) = (float, float), (double, double) and (double, float).
+ */
+template <typename OutPixelT, typename InPixelT>
+struct IsConvolveRowsType
+        : std::integral_constant<bool, (std::is_same<OutPixelT, float>::value &&
+                                        std::is_same<InPixelT, float>::value) ||
+                                               (std::is_same<OutPixelT, double>::value &&
+                                                (std::is_same<InPixelT, double>::value ||
+                                                 std::is_same<InPixelT, float>::value))> {};
+
+/**
+ * Compute the dot product of a kernel vector with each of n overlapping stretches of an input row
+ *
+ * out[i] (+)= sum over k of (OutPixelT)(in[i + k] * kernel[k]), for 0 <= i < n
+ *
+ * @param[in,out] out output pixels (n of them)
+ * @param[in] in input pixels (n + kSize - 1 of them)
+ * @param[in] kernel kernel vector
+ * @param[in] kSize number of elements in kernel
+ * @param[in] n number of output pixels
+ * @param[in] doAdd if true, add each dot product to the existing output pixel, else set the output pixel
+ */
+template <typename OutPixelT, typename InPixelT>
+void rowDotProducts(OutPixelT* out, InPixelT const* in, double const* kernel, int kSize, int n, bool doAdd);
+
+/**
+ * Compute the dot product of a kernel vector with each column of a set of rows
+ *
+ * out[i] (+)= sum over k of (OutPixelT)(rows[k][i] * kernel[k]), for 0 <= i < n
+ *
+ * @param[in,out] out output pixels (n of them)
+ * @param[in] rows pointers to kSize input rows (n pixels each)
+ * @param[in] kernel kernel vector
+ * @param[in] kSize number of elements in kernel and rows
+ * @param[in] n number of output pixels
+ * @param[in] doAdd if true, add each dot product to the existing output pixel, else set the output pixel
+ */
+template <typename OutPixelT, typename InPixelT>
+void columnDotProducts(OutPixelT* out, InPixelT const* const* rows, double const* kernel, int kSize, int n,
+                       bool doAdd);
+
+/**
+ * Return the name of the instruction set used by rowDotProducts and columnDotProducts
+ *
+ * @returns "AVX-512", "AVX2" or "scalar"
+ */
+std::string getConvolveRowsInstructionSet();
+
+/**
+ * Enable or disable use of SIMD instructions by rowDotProducts and columnDotProducts
+ *
+ * SIMD instructions are enabled by default (if the CPU supports them). Disabling them is only
+ * useful for testing and benchmarking, since the results are the same either way.
+ */
+void setConvolveRowsSimdEnabled(bool enabled);
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_CONVOLVEROWS_H
@@ -0,0 +1,116 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_LANCZOSTABLE_H
+#define LSST_AFW_MATH_DETAIL_LANCZOSTABLE_H
+
+#include <cmath>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * A lookup table of the 1-dimensional Lanczos function, for fast evaluation of Lanczos warping kernels
+ *
+ * The function L(t) = sinc(pi t) sinc(pi t / n) is tabulated for -n <= t <= n at intervals of
+ * 1/oversampling and evaluated by linear interpolation between table entries.
+ * The absolute error of each value is at most max|L''| / (8 oversampling^2)
+ * = pi^2 (1 + 1/n^2) / (24 oversampling^2); see getMaxError.
+ */
+class LanczosTable final {
+public:
+    /**
+     * Construct a table
+     *
+     * @param[in] order order n of the Lanczos function
+     * @param[in] oversampling number of table entries per unit of t
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if order < 1 or oversampling < 1
+     */
+    LanczosTable(int order, int oversampling);
+
+    LanczosTable(LanczosTable const &) = default;
+    LanczosTable(LanczosTable &&) = default;
+    LanczosTable &operator=(LanczosTable const &) = default;
+    LanczosTable &operator=(LanczosTable &&) = default;
+    ~LanczosTable() = default;
+
+    int getOrder() const { return _order; }
+
+    int getOversampling() const { return _oversampling; }
+
+    /**
+     * Return the maximum absolute error of a value computed by a table of given order and oversampling
+     */
+    static double getMaxError(int order, int oversampling);
+
+    /**
+     * Compute the 1-dimensional weights of a Lanczos warping kernel
+     *
+     * This computes the same values as LanczosWarpingKernel::computeVectors (without normalization)
+     * for one axis, to within getMaxError.
+     *
+     * @param[in] fracPos fractional position: the kernel parameter for this axis
+     * @param[in] ctr kernel center index for this axis
+     * @param[out] weights the weights; the size must be 2 * order
+     * @returns the sum of the weights
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the kernel extends outside the table,
+     * which can only happen if fracPos and ctr are not a valid combination for a warping kernel.
+     */
+    double computeWeights(double fracPos, int ctr, std::vector<double> &weights) const {
+        // table index of the first weight; the indices of the others are spaced by _oversampling,
+        // so they all have the same fractional part
+        double const firstIndex = (_order - ctr - fracPos) * _oversampling;
+        double const floorIndex = std::floor(firstIndex);
+        double const frac = firstIndex - floorIndex;
+        int ind = static_cast<int>(floorIndex);
+        int const nWeights = static_cast<int>(weights.size());
+        if (ind < 0 || ind + (nWeights - 1) * _oversampling + 1 >= static_cast<int>(_values.size())) {
+            _throwOutOfRange(fracPos, ctr);
+        }
+        double sum = 0.0;
+        for (int i = 0; i < nWeights; ++i, ind += _oversampling) {
+            double const value = _values[ind] + frac * (_values[ind + 1] - _values[ind]);
+            weights[i] = value;
+            sum += value;
+        }
+        return sum;
+    }
+
+private:
+    [[noreturn]] void _throwOutOfRange(double fracPos, int ctr) const;
+
+    int _order;
+    int _oversampling;
+    std::vector<double> _values;  // L(-order + i / oversampling)
+};
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_LANCZOSTABLE_H
@@ -0,0 +1,120 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_PARALLEL_H
+#define LSST_AFW_MATH_DETAIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Return the number of threads to use for a requested thread count
+ *
+ * @param nThreads requested number of threads; 0 means one thread per hardware thread
+ * @returns the number of threads to use (always >= 1)
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0
+ */
+int resolveNThreads(int nThreads);
+
+/**
+ * Divide the range [begin, end) into at most nBands contiguous bands of approximately equal length
+ *
+ * @param begin start of range
+ * @param end end of range (one past the last element)
+ * @param nBands maximum number of bands
+ * @param alignment every band except the last starts a multiple of this many elements after begin
+ * @returns band boundaries: band i is [result[i], result[i+1]); empty if the range is empty
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if nBands < 1 or alignment < 1
+ */
+std::vector<int> computeBandBoundaries(int begin, int end, int nBands, int alignment = 1);
+
+/**
+ * Call func(i) for each i in [0, n), using up to nThreads threads
+ *
+ * Indices are handed out dynamically, so the order in which they are processed is unspecified;
+ * func must be safe to call concurrently for different indices. The calling thread does part
+ * of the work. If nThreads <= 1 or n <= 1 the calls are made serially, in order, in the calling thread.
+ *
+ * If any call throws, no further indices are started and the first exception is rethrown
+ * in the calling thread once all running calls have finished.
+ *
+ * @param n number of indices
+ * @param nThreads maximum number of threads, as returned by resolveNThreads
+ * @param func function to call; must accept an int
+ */
+template <typename Function>
+void parallelFor(int n, int nThreads, Function func) {
+    if (nThreads <= 1 || n <= 1) {
+        for (int i = 0; i < n; ++i) {
+            func(i);
+        }
+        return;
+    }
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]() {
+        for (int i = next++; i < n && !failed; i = next++) {
+            try {
+                func(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    int const nExtra = std::min(nThreads, n) - 1;
+    threads.reserve(nExtra);
+    for (int i = 0; i < nExtra; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_PARALLEL_H
@@ -0,0 +1,117 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_PIECEWISECUBIC_H
+#define LSST_AFW_MATH_DETAIL_PIECEWISECUBIC_H
+
+#include <vector>
+
+#include "lsst/afw/math/Interpolate.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * A piecewise cubic interpolant of tabulated values, for evaluation at a run of integer positions
+ *
+ * This computes the same interpolants as the GSL-based Interpolate returned by makeInterpolate for the
+ * LINEAR, NATURAL_SPLINE, CUBIC_SPLINE and AKIMA_SPLINE styles (including the quadratic extrapolation
+ * beyond the ends of the table), and agrees with it to rounding error.  The coefficients of each interval
+ * are computed once, and evaluating at consecutive positions steps through the intervals rather than
+ * searching for each one, so filling a row or column of an image costs little more than a
+ * polynomial evaluation per pixel.
+ */
+class PiecewiseCubic {
+public:
+    /**
+     * Can a PiecewiseCubic be used for this style and number of points?
+     *
+     * If not, use makeInterpolate (which will throw if there are too few points).
+     */
+    static bool isSupported(Interpolate::Style style, int nPoints);
+
+    /**
+     * Construct an interpolant
+     *
+     * @param x positions of the tabulated values, in increasing order
+     * @param y tabulated values
+     * @param style interpolation style
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if isSupported(style, x.size()) is false,
+     *         or if x and y are of different sizes
+     */
+    PiecewiseCubic(std::vector<double> const& x, std::vector<double> const& y, Interpolate::Style style);
+
+    PiecewiseCubic(PiecewiseCubic const&) = default;
+    PiecewiseCubic(PiecewiseCubic&&) = default;
+    PiecewiseCubic& operator=(PiecewiseCubic const&) = default;
+    PiecewiseCubic& operator=(PiecewiseCubic&&) = default;
+    ~PiecewiseCubic() = default;
+
+    /// Return the interpolant at a single position
+    double interpolate(double x) const;
+
+    /**
+     * Evaluate the interpolant at the positions begin, begin + 1, ..., end - 1
+     *
+     * @param begin first position
+     * @param end one past the last position
+     * @param out output; out[i*stride] is set to the interpolant at begin + i
+     * @param stride spacing of the outputs
+     */
+    template <typename T>
+    void interpolate(int begin, int end, T* out, int stride = 1) const {
+        int const nInterval = _x.size() - 1;
+        int i = 0;  // index of the interval containing x
+        for (int x = begin; x < end; ++x, out += stride) {
+            if (x < _x.front() || x > _x.back()) {
+                *out = static_cast<T>(_extrapolate(x));
+                continue;
+            }
+            while (i < nInterval - 1 && x >= _x[i + 1]) {
+                ++i;
+            }
+            double const dx = x - _x[i];
+            *out = static_cast<T>(_y[i] + dx * (_b[i] + dx * (_c[i] + dx * _d[i])));
+        }
+    }
+
+private:
+    // Return the quadratic extrapolation of the interpolant beyond the ends of the table
+    double _extrapolate(double x) const;
+
+    std::vector<double> _x;
+    std::vector<double> _y;
+    // In interval i the interpolant is _y[i] + dx*(_b[i] + dx*(_c[i] + dx*_d[i])) with dx = x - _x[i]
+    std::vector<double> _b;
+    std::vector<double> _c;
+    std::vector<double> _d;
+};
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_PIECEWISECUBIC_H
@@ -21,9 +21,11 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <memory>
 #include <vector>
 
 #include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/LanczosTable.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/geom/Point.h"
@@ -53,7 +55,9 @@ public:
               _maskXList(_maskKernelPtr ? _maskKernelPtr->getWidth() : 0),
               _maskYList(_maskKernelPtr ? _maskKernelPtr->getHeight() : 0),
               _padValue(padValue),
-              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))){};
+              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))),
+              _tablePtr(_makeTable(_kernelPtr, control.getLanczosTableOversampling())),
+              _maskTablePtr(_makeTable(_maskKernelPtr, control.getLanczosTableOversampling())){};
 
     /**
      * Compute one warped pixel, Image specialization
@@ -179,15 +183,40 @@ private:
      */
     double _setFracIndex(double xFrac, double yFrac) {
         std::pair<double, double> srcFracInd(xFrac, yFrac);
-        _kernelPtr->setKernelParameters(srcFracInd);
-        double kSum = _kernelPtr->computeVectors(_xList, _yList, false);
-        if (_maskKernelPtr) {
+        double kSum;
+        if (_tablePtr) {
+            kSum = _tablePtr->computeWeights(xFrac, _kernelCtr[0], _xList) *
+                   _tablePtr->computeWeights(yFrac, _kernelCtr[1], _yList);
+        } else {
+            _kernelPtr->setKernelParameters(srcFracInd);
+            kSum = _kernelPtr->computeVectors(_xList, _yList, false);
+        }
+        if (_maskTablePtr) {
+            _maskTablePtr->computeWeights(xFrac, _maskKernelCtr[0], _maskXList);
+            _maskTablePtr->computeWeights(yFrac, _maskKernelCtr[1], _maskYList);
+        } else if (_maskKernelPtr) {
             _maskKernelPtr->setKernelParameters(srcFracInd);
             _maskKernelPtr->computeVectors(_maskXList, _maskYList, false);
         }
         return kSum;
     }
 
+    /**
+     * Return a Lanczos lookup table for a warping kernel,
+     * or nullptr if the kernel should be evaluated directly
+     */
+    static std::shared_ptr<LanczosTable const> _makeTable(
+            std::shared_ptr<lsst::afw::math::SeparableKernel const> const &kernelPtr, int oversampling) {
+        if (oversampling > 0) {
+            auto const lanczosKernelPtr =
+                    std::dynamic_pointer_cast<lsst::afw::math::LanczosWarpingKernel const>(kernelPtr);
+            if (lanczosKernelPtr) {
+                return std::make_shared<LanczosTable const>(lanczosKernelPtr->getOrder(), oversampling);
+            }
+        }
+        return nullptr;
+    }
+
     SrcImageT _srcImage;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _kernelPtr;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _maskKernelPtr;
@@ -201,6 +230,8 @@ private:
     std::vector<double> _maskYList;
     typename DestImageT::SinglePixel _padValue;
     lsst::geom::Box2I const _srcGoodBBox;
+    std::shared_ptr<LanczosTable const> _tablePtr;      // lookup table for warping kernel, if used
+    std::shared_ptr<LanczosTable const> _maskTablePtr;  // lookup table for mask warping kernel, if used
 };
 }  // namespace detail
 }  // namespace math
@@ -273,7 +273,9 @@ public:
               _maskWarpingKernelPtr(),
               _cacheSize(cacheSize),
               _interpLength(interpLength),
-              _growFullMask(growFullMask) {
+              _growFullMask(growFullMask),
+              _nThreads(1),
+              _lanczosTableOversampling(0) {
         setMaskWarpingKernelName(maskWarpingKernelName);
     }
 
@@ -373,6 +375,47 @@ public:
         _growFullMask = growFullMask;
     }
 
+    /**
+     * get the number of threads used to warp an image
+     */
+    int getNThreads() const { return _nThreads; }
+
+    /**
+     * set the number of threads used to warp an image
+     *
+     * Each thread warps a band of rows of the destination image using its own copy of the warping kernels.
+     * The result does not depend on the number of threads.
+     * * 1 (the default) warps in the calling thread
+     * * 0 uses one thread per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0
+     */
+    void setNThreads(int nThreads  ///< number of threads
+    );
+
+    /**
+     * get the oversampling of the Lanczos lookup tables; 0 if lookup tables are not used
+     */
+    int getLanczosTableOversampling() const { return _lanczosTableOversampling; }
+
+    /**
+     * set the oversampling of the Lanczos lookup tables
+     *
+     * If oversampling > 0 then Lanczos warping kernels (including a Lanczos mask warping kernel)
+     * are not evaluated directly. Instead the 1-dimensional Lanczos function is tabulated
+     * at intervals of 1/oversampling pixel and linearly interpolated, which is much faster.
+     * The absolute error of each 1-dimensional kernel value is at most
+     * pi^2 (1 + 1/n^2) / (24 oversampling^2) for a kernel of order n:
+     * less than 4.4e-7 for oversampling = 1024 and n >= 2.
+     * Other warping kernels, and the kernel cache (see setCacheSize), are not affected,
+     * except that the cache is not used for a tabulated kernel.
+     * The default is 0, which evaluates the Lanczos function directly.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if oversampling < 0
+     */
+    void setLanczosTableOversampling(int oversampling  ///< table entries per pixel; 0 to disable
+    );
+
 private:
     /**
      * Throw an exception if the two kernels are not compatible in shape
@@ -389,6 +432,8 @@ private:
     int _cacheSize;
     int _interpLength;
     lsst::afw::image::MaskPixel _growFullMask;
+    int _nThreads;
+    int _lanczosTableOversampling;
 };
 
 /**
@@ -442,6 +487,12 @@ int warpExposure(
  * separated by interpLen pixels along rows and columns. All other source pixel positions are determined
  * by linear interpolation between those grid points. Everything else remains the same.
  *
+ * @b Threading:
+ *
+ * If WarpingControl::getNThreads is not 1 then the destination image is divided into bands of rows
+ * that are warped concurrently, each with its own copy of the warping kernels and transform.
+ * The result is bit-identical to warping with one thread.
+ *
  * @throws lsst::pex::exceptions::InvalidParameterError if destImage overlaps srcImage
  * @throws std::bad_alloc when allocation of CPU memory fails
  *
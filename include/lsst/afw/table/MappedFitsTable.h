@@ -0,0 +1,102 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_MappedFitsTable_h_INCLUDED
+#define AFW_TABLE_MappedFitsTable_h_INCLUDED
+
+#include <memory>
+#include <string>
+
+#include "ndarray.h"
+
+#include "lsst/afw/fitsDefaults.h"
+#include "lsst/afw/table/Schema.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  Read-only, column-wise access to a FITS binary table through a memory map of the file.
+ *
+ *  Constructing a MappedFitsTable reads only the FITS header and maps the table data into memory,
+ *  so its cost does not depend on the size of the table.  Nothing is read from the table data until
+ *  a column is requested: the first request for a column converts it from its on-disk (big-endian)
+ *  form into a cached array, which later requests return again, so memory use is proportional to the
+ *  columns actually accessed.  Columns that need no conversion (single-byte columns, and suitably
+ *  aligned columns on big-endian hosts) are instead returned as strided views into the mapped file.
+ *
+ *  The Schema is the one BaseCatalog::readFits would produce for the same table.  Readers of other
+ *  catalog types may add or remove fields (SourceCatalog::readFits, for instance, reads the footprint
+ *  column into Footprints rather than a field), and this class does not.  Only fields stored directly
+ *  in a FITS column can be accessed: fixed-size scalar, Angle, array and Flag fields.  String fields,
+ *  variable-length arrays and fields converted from older table versions must be read with
+ *  Catalog::readFits.  The file must be an uncompressed FITS file on disk.
+ *
+ *  The arrays returned share ownership of the mapping and the cache, so they remain valid after the
+ *  MappedFitsTable is destroyed.  All member functions may be called concurrently from multiple threads,
+ *  and each call returns an array with its own reference count, so arrays returned by different calls
+ *  may be copied and destroyed by different threads.
+ */
+class MappedFitsTable final {
+public:
+    /**
+     *  Map a FITS binary table.
+     *
+     *  @param[in] filename    Name of the file to map.
+     *  @param[in] hdu         Number of the "header-data unit" to map (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *
+     *  @throws lsst::afw::fits::FitsError if the HDU is not a binary table or the file is compressed.
+     *  @throws lsst::pex::exceptions::IoError if the file cannot be mapped.
+     */
+    explicit MappedFitsTable(std::string const& filename, int hdu = fits::DEFAULT_HDU);
+
+    MappedFitsTable(MappedFitsTable const&) = default;
+    MappedFitsTable(MappedFitsTable&&) = default;
+    MappedFitsTable& operator=(MappedFitsTable const&) = default;
+    MappedFitsTable& operator=(MappedFitsTable&&) = default;
+    ~MappedFitsTable();
+
+    /// Return the schema that defines the fields.
+    Schema getSchema() const;
+
+    /// Return the number of rows in the table.
+    std::size_t size() const;
+
+    /**
+     *  Return a 1-d array corresponding to a scalar field.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the field is not stored directly in a FITS column.
+     *  @throws lsst::pex::exceptions::LogicError if the field's type does not match its FITS column.
+     */
+    template <typename T>
+    ndarray::Array<T const, 1> operator[](Key<T> const& key) const;
+
+    /**
+     *  Return a 2-d array corresponding to a fixed-length array field.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the field is not stored directly in a FITS column.
+     *  @throws lsst::pex::exceptions::LogicError if the field's type does not match its FITS column,
+     *          or if the field is a variable-length array.
+     */
+    template <typename T>
+    ndarray::Array<T const, 2, 1> operator[](Key<Array<T>> const& key) const;
+
+    /**
+     *  Return a 1-d array of the values of a Flag field.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the flag is not in the FITS header.
+     */
+    ndarray::Array<bool const, 1, 1> operator[](Key<Flag> const& key) const;
+
+private:
+    class Impl;
+
+    std::shared_ptr<Impl> _impl;
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_MappedFitsTable_h_INCLUDED
@@ -25,15 +25,19 @@
 #ifndef LSST_AFW_TABLE_MATCH_H
 #define LSST_AFW_TABLE_MATCH_H
 
+#include <cstddef>
 #include <vector>
 
+#include "ndarray.h"
 #include "lsst/pex/config.h"
 #include "lsst/afw/table/fwd.h"
 #include "lsst/afw/table/BaseRecord.h"
 #include "lsst/afw/table/Simple.h"
 #include "lsst/afw/table/Source.h"
 #include "lsst/afw/table/Catalog.h"
+#include "lsst/afw/table/detail/KdTree.h"
 #include "lsst/geom/Angle.h"
+#include "lsst/geom/Point.h"
 
 namespace lsst {
 namespace afw {
@@ -44,7 +48,7 @@ namespace table {
  */
 class MatchControl {
 public:
-    MatchControl() : findOnlyClosest(true), symmetricMatch(true), includeMismatches(false) {}
+    MatchControl() : findOnlyClosest(true), symmetricMatch(true), includeMismatches(false), nThreads(1) {}
     LSST_CONTROL_FIELD(findOnlyClosest, bool,
                        "Return only the closest match if more than one is found "
                        "(default: true)");
@@ -54,6 +58,10 @@ public:
     LSST_CONTROL_FIELD(includeMismatches, bool,
                        "Include failed matches (i.e. one 'match' is NULL) "
                        "(default: false)");
+    LSST_CONTROL_FIELD(nThreads, int,
+                       "Maximum number of threads used by matchRaDec and matchXy; 0 for one per hardware "
+                       "thread. "
+                       "The result does not depend on the number of threads (default: 1)");
 };
 
 /**
@@ -86,6 +94,63 @@ typedef std::vector<SimpleMatch> SimpleMatchVector;
 typedef std::vector<ReferenceMatch> ReferenceMatchVector;
 typedef std::vector<SourceMatch> SourceMatchVector;
 
+/**
+ *  A reusable spatial index of 2-d (e.g. pixel) positions, for radius and nearest-neighbor searches.
+ *
+ *  The index is built once, and may then be queried any number of times (including concurrently from
+ *  several threads), e.g. in each iteration of a fit.  Positions are referred to by their index in the
+ *  catalog or arrays the XyIndex was built from; positions with a NaN coordinate are never found.
+ */
+class XyIndex final {
+public:
+    /**
+     *  Index the centroids of the records in a catalog.
+     *
+     *  @param[in] cat   Catalog whose centroid slot gives the positions to index.
+     */
+    explicit XyIndex(SourceCatalog const &cat);
+
+    /**
+     *  Index positions given as arrays.
+     *
+     *  @param[in] x     x coordinates of the positions.
+     *  @param[in] y     y coordinates of the positions; must be the same size as x.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if x and y have different sizes.
+     */
+    XyIndex(ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y);
+
+    XyIndex(XyIndex const &) = default;
+    XyIndex(XyIndex &&) = default;
+    XyIndex &operator=(XyIndex const &) = default;
+    XyIndex &operator=(XyIndex &&) = default;
+    ~XyIndex() = default;
+
+    /// Return the number of positions the index was built from, including those with a NaN coordinate.
+    std::size_t size() const { return _size; }
+
+    /**
+     *  Return the indices of all positions closer than `radius` to `center`, in increasing order.
+     */
+    std::vector<std::size_t> findWithin(lsst::geom::Point2D const &center, double radius) const;
+
+    /**
+     *  Return the indices of the (up to) `n` positions nearest to `center`, nearest first,
+     *  with ties broken by index.
+     */
+    std::vector<std::size_t> findNearest(lsst::geom::Point2D const &center, std::size_t n) const;
+
+    /**
+     *  @internal Return the underlying k-d tree; its point indices are indices into the catalog
+     *  or arrays the XyIndex was built from.
+     */
+    detail::KdTree<2> const &getTree() const { return _tree; }
+
+private:
+    std::size_t _size;
+    detail::KdTree<2> _tree;
+};
+
 /**
  * Compute all tuples (s1,s2,d) where s1 belings to `cat1`, s2 belongs to `cat2` and
  * d, the distance between s1 and s2, in pixels, is at most `radius`. If cat1 and
@@ -100,6 +165,23 @@ SourceMatchVector matchXy(
                 MatchControl()  ///< how to do the matching (obeys MatchControl::findOnlyClosest)
 );
 
+/**
+ * Compute all tuples (s1,s2,d) where s1 belongs to `cat1`, s2 belongs to `cat2` and
+ * d, the distance between s1 and s2, in pixels, is at most `radius`, using a prebuilt
+ * index of `cat2`. This gives the same result as `matchXy(cat1, cat2, radius, mc)`
+ * (even if cat1 and cat2 are identical), without indexing `cat2` again.
+ *
+ * @throws lsst::pex::exceptions::LengthError if `index2` was not built from a catalog the size of `cat2`.
+ */
+SourceMatchVector matchXy(
+        SourceCatalog const &cat1,  ///< first catalog
+        SourceCatalog const &cat2,  ///< second catalog
+        XyIndex const &index2,      ///< index of cat2
+        double radius,              ///< match radius (pixels)
+        MatchControl const &mc =
+                MatchControl()  ///< how to do the matching (obeys MatchControl::findOnlyClosest)
+);
+
 /**
  * Compute all tuples (s1,s2,d) where s1 != s2, s1 and s2 both belong to `cat`,
  * and d, the distance between s1 and s2, in pixels, is at most `radius`. The
@@ -142,6 +142,43 @@ public:
         return io::FitsReader::apply<SortedCatalogT>(manager, hdu, flags);
     }
 
+    /**
+     *  Read a subset of the columns of a FITS binary table from a regular file.
+     *
+     *  Only the given columns, and any the table class requires, are read; the Schema of the returned
+     *  catalog contains only the fields read from them.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] columns     Names of the FITS columns (or Flag fields) to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if one of the columns does not exist.
+     */
+    static SortedCatalogT readFits(std::string const& filename, std::vector<std::string> const& columns,
+                                   int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<SortedCatalogT>(filename, hdu, flags, nullptr, columns);
+    }
+
+    /**
+     *  Read a subset of the columns of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] columns     Names of the FITS columns (or Flag fields) to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if one of the columns does not exist.
+     */
+    static SortedCatalogT readFits(fits::MemFileManager& manager, std::vector<std::string> const& columns,
+                                   int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<SortedCatalogT>(manager, hdu, flags, nullptr, columns);
+    }
+
     /**
      *  Read a FITS binary table from a file object already at the correct extension.
      *
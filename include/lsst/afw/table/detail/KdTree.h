@@ -0,0 +1,264 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef AFW_TABLE_DETAIL_KdTree_h_INCLUDED
+#define AFW_TABLE_DETAIL_KdTree_h_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+/**
+ *  @internal
+ *
+ *  A static k-d tree of points in N-dimensional Cartesian space, for fixed-radius and
+ *  nearest-neighbor searches.
+ *
+ *  The tree is immutable once built, so any number of threads may query it concurrently.
+ *  Points are identified by their index in the vector passed to the constructor, or by indices
+ *  supplied with them.
+ */
+template <std::size_t N>
+class KdTree final {
+public:
+    typedef std::array<double, N> Point;
+
+    /**
+     *  Build a tree.
+     *
+     *  @param[in] points     Points to index; all coordinates must be finite.
+     *  @param[in] leafSize   Maximum number of points in a leaf node.
+     */
+    explicit KdTree(std::vector<Point> const &points, std::size_t leafSize = 8)
+            : KdTree(points, std::vector<std::size_t>(), leafSize) {}
+
+    /**
+     *  Build a tree of points with arbitrary indices.
+     *
+     *  @param[in] points     Points to index; all coordinates must be finite.
+     *  @param[in] indices    The indices by which the points are identified; must be empty (in which case
+     *                        the index of each point is its position in `points`) or the same size as
+     *                        `points`.
+     *  @param[in] leafSize   Maximum number of points in a leaf node.
+     */
+    KdTree(std::vector<Point> const &points, std::vector<std::size_t> const &indices,
+           std::size_t leafSize = 8)
+            : _leafSize(std::max<std::size_t>(leafSize, 1)) {
+        _indices.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            _indices[i] = i;
+        }
+        if (!points.empty()) {
+            _nodes.resize(1);
+            _build(points, 0, 0, points.size());
+        }
+        // store the points in tree order, so the points of each leaf are contiguous in memory
+        _points.reserve(points.size());
+        for (std::size_t &index : _indices) {
+            _points.push_back(points[index]);
+            if (!indices.empty()) {
+                index = indices[index];
+            }
+        }
+    }
+
+    KdTree(KdTree const &) = default;
+    KdTree(KdTree &&) = default;
+    KdTree &operator=(KdTree const &) = default;
+    KdTree &operator=(KdTree &&) = default;
+    ~KdTree() = default;
+
+    /// Return the number of points in the tree.
+    std::size_t size() const { return _points.size(); }
+
+    /**
+     *  Call a function for every point strictly closer than a given distance to a center.
+     *
+     *  @param[in] center     Center of the search.
+     *  @param[in] d2Limit    Square of the search radius; points with d2 < d2Limit are found.
+     *  @param[in] func       Function called with (index, d2) for each point found, where d2 is the
+     *                        squared distance computed as the sum of squares of (center - point).
+     *                        Points are not visited in any particular order.
+     */
+    template <typename Function>
+    void forEachWithin(Point const &center, double d2Limit, Function &&func) const {
+        if (_nodes.empty()) {
+            return;
+        }
+        std::size_t stack[64];
+        std::size_t nStack = 0;
+        stack[nStack++] = 0;
+        while (nStack > 0) {
+            Node const &node = _nodes[stack[--nStack]];
+            if (_boxDistanceSquared(node, center) >= d2Limit) {
+                continue;
+            }
+            if (node.left == 0) {
+                for (std::size_t i = node.begin; i < node.end; ++i) {
+                    double const d2 = _distanceSquared(center, _points[i]);
+                    if (d2 < d2Limit) {
+                        func(_indices[i], d2);
+                    }
+                }
+            } else {
+                stack[nStack++] = node.left;
+                stack[nStack++] = node.left + 1;
+            }
+        }
+    }
+
+    /**
+     *  Find the points nearest to a given position.
+     *
+     *  @param[in] center     Center of the search.
+     *  @param[in] n          Maximum number of points to find.
+     *  @param[out] result    (d2, index) pairs for the (up to) n nearest points, in increasing order
+     *                        of squared distance, with ties broken by index.
+     */
+    void findNearest(Point const &center, std::size_t n,
+                     std::vector<std::pair<double, std::size_t> > &result) const {
+        result.clear();
+        if (_nodes.empty() || n == 0) {
+            return;
+        }
+        // result is kept as a max-heap, so the worst of the points found so far is at the front
+        std::size_t stack[64];
+        std::size_t nStack = 0;
+        stack[nStack++] = 0;
+        while (nStack > 0) {
+            Node const &node = _nodes[stack[--nStack]];
+            if (result.size() == n && _boxDistanceSquared(node, center) > result.front().first) {
+                continue;
+            }
+            if (node.left == 0) {
+                for (std::size_t i = node.begin; i < node.end; ++i) {
+                    std::pair<double, std::size_t> const candidate(_distanceSquared(center, _points[i]),
+                                                                   _indices[i]);
+                    if (result.size() < n) {
+                        result.push_back(candidate);
+                        std::push_heap(result.begin(), result.end());
+                    } else if (candidate < result.front()) {
+                        std::pop_heap(result.begin(), result.end());
+                        result.back() = candidate;
+                        std::push_heap(result.begin(), result.end());
+                    }
+                }
+            } else {
+                // visit the nearer child first, so the search radius shrinks quickly
+                std::size_t near = node.left;
+                std::size_t far = node.left + 1;
+                if (_boxDistanceSquared(_nodes[far], center) < _boxDistanceSquared(_nodes[near], center)) {
+                    std::swap(near, far);
+                }
+                stack[nStack++] = far;
+                stack[nStack++] = near;
+            }
+        }
+        std::sort_heap(result.begin(), result.end());
+    }
+
+private:
+    struct Node {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t left;  // index of the left child (the right child follows it); 0 for a leaf
+        Point min;
+        Point max;
+    };
+
+    static double _distanceSquared(Point const &a, Point const &b) {
+        double d2 = 0.0;
+        for (std::size_t k = 0; k < N; ++k) {
+            double const d = a[k] - b[k];
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    static double _boxDistanceSquared(Node const &node, Point const &p) {
+        double d2 = 0.0;
+        for (std::size_t k = 0; k < N; ++k) {
+            double d = 0.0;
+            if (p[k] < node.min[k]) {
+                d = node.min[k] - p[k];
+            } else if (p[k] > node.max[k]) {
+                d = p[k] - node.max[k];
+            }
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    // Build the subtree of points _indices[begin:end] with its root at _nodes[nodeIndex].
+    void _build(std::vector<Point> const &points, std::size_t nodeIndex, std::size_t begin, std::size_t end) {
+        Node node;
+        node.begin = begin;
+        node.end = end;
+        node.left = 0;
+        node.min = node.max = points[_indices[begin]];
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            Point const &p = points[_indices[i]];
+            for (std::size_t k = 0; k < N; ++k) {
+                node.min[k] = std::min(node.min[k], p[k]);
+                node.max[k] = std::max(node.max[k], p[k]);
+            }
+        }
+        if (end - begin > _leafSize) {
+            // split at the median of the dimension with the largest extent
+            std::size_t dim = 0;
+            for (std::size_t k = 1; k < N; ++k) {
+                if (node.max[k] - node.min[k] > node.max[dim] - node.min[dim]) {
+                    dim = k;
+                }
+            }
+            std::size_t const middle = begin + (end - begin) / 2;
+            std::nth_element(_indices.begin() + begin, _indices.begin() + middle, _indices.begin() + end,
+                             [&points, dim](std::size_t a, std::size_t b) {
+                                 return points[a][dim] < points[b][dim];
+                             });
+            // children are allocated as adjacent pairs
+            node.left = _nodes.size();
+            _nodes.resize(_nodes.size() + 2);
+            _build(points, node.left, begin, middle);
+            _build(points, node.left + 1, middle, end);
+        }
+        _nodes[nodeIndex] = node;
+    }
+
+    std::size_t _leafSize;
+    std::vector<Node> _nodes;
+    std::vector<std::size_t> _indices;  // indices of the points, in tree order
+    std::vector<Point> _points;         // the points, in tree order
+};
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_DETAIL_KdTree_h_INCLUDED
@@ -2,7 +2,10 @@
 #ifndef AFW_TABLE_IO_FitsReader_h_INCLUDED
 #define AFW_TABLE_IO_FitsReader_h_INCLUDED
 
+#include <algorithm>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
@@ -66,14 +69,23 @@ public:
      *                       archive argument is provided only for cases in which the catalog itself is
      *                       part of a larger object, and does not "own" its own archive (e.g. CoaddPsf
      *                       persistence).
+     *  @param[in]  columns  Names of the FITS columns to read; if empty, all columns are read.  Fields the
+     *                       table class requires (see FitsSchemaInputMapper::require) are always read.
+     *
+     *  Records are read in blocks of consecutive rows, with each column of a block read in a single call
+     *  where possible.
      */
     template <typename ContainerT>
     static ContainerT apply(afw::fits::Fits& fits, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = std::vector<std::string>()) {
         std::shared_ptr<daf::base::PropertyList> metadata = std::make_shared<daf::base::PropertyList>();
         fits.readMetadata(*metadata, true);
         FitsReader const* reader = _lookupFitsReader(*metadata);
         FitsSchemaInputMapper mapper(*metadata, true);
+        if (!columns.empty()) {
+            mapper.select(columns);
+        }
         reader->_setupArchive(fits, mapper, archive, ioFlags);
         std::shared_ptr<BaseTable> table = reader->makeTable(mapper, metadata, ioFlags, true);
         ContainerT container(std::dynamic_pointer_cast<typename ContainerT::Table>(table));
@@ -82,14 +94,18 @@ public:
         }
         std::size_t nRows = fits.countRows();
         container.reserve(nRows);
-        for (std::size_t row = 0; row < nRows; ++row) {
-            mapper.readRecord(
-                    // We need to be able to support reading Catalog<T const>, since it shares the same
-                    // template
-                    // as Catalog<T> (which invokes this method in readFits).
-                    const_cast<typename std::remove_const<typename ContainerT::Record>::type&>(
-                            *container.addNew()),
-                    fits, row);
+        std::size_t const blockSize = _computeBlockSize(table->getSchema());
+        std::vector<BaseRecord*> records;
+        records.reserve(std::min(blockSize, nRows));
+        for (std::size_t row = 0; row < nRows; row += records.size()) {
+            records.clear();
+            while (records.size() < blockSize && row + records.size() < nRows) {
+                // We need to be able to support reading Catalog<T const>, since it shares the same
+                // template as Catalog<T> (which invokes this method in readFits).
+                records.push_back(const_cast<typename std::remove_const<typename ContainerT::Record>::type*>(
+                        container.addNew().get()));
+            }
+            mapper.readRecords(records, fits, row);
         }
         return container;
     }
@@ -102,10 +118,11 @@ public:
      */
     template <typename ContainerT, typename SourceT>
     static ContainerT apply(SourceT& source, int hdu, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = std::vector<std::string>()) {
         afw::fits::Fits fits(source, "r", afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
         fits.setHdu(hdu);
-        return apply<ContainerT>(fits, ioFlags, archive);
+        return apply<ContainerT>(fits, ioFlags, archive, columns);
     }
 
     /**
@@ -140,6 +157,9 @@ public:
     virtual ~FitsReader() = default;
 
 private:
+    // Return the number of rows to read at once for tables with the given schema.
+    static std::size_t _computeBlockSize(Schema const& schema);
+
     static FitsReader const* _lookupFitsReader(daf::base::PropertyList const& metadata);
 
     void _setupArchive(afw::fits::Fits& fits, FitsSchemaInputMapper& mapper,
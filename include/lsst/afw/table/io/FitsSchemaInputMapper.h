@@ -2,6 +2,8 @@
 #ifndef AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 #define AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 
+#include <vector>
+
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -25,6 +27,19 @@ public:
     virtual void readCell(BaseRecord &record, std::size_t row, fits::Fits &fits,
                           std::shared_ptr<InputArchive> const &archive) const = 0;
 
+    /**
+     *  Read a block of consecutive rows, filling records[i] from row firstRow + i.
+     *
+     *  The default implementation calls readCell() for each row; readers for fixed-size columns override
+     *  it to read the whole block with a single call.
+     */
+    virtual void readCells(std::vector<BaseRecord *> const &records, std::size_t firstRow, fits::Fits &fits,
+                           std::shared_ptr<InputArchive> const &archive) const {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            readCell(*records[i], firstRow + i, fits, archive);
+        }
+    }
+
     virtual ~FitsColumnReader() = default;
 };
 
@@ -122,6 +137,23 @@ public:
      */
     void erase(int column);
 
+    /**
+     *  Restrict the regular fields added by finalize() to those read from the given columns.
+     *
+     *  Flag fields may be selected by name along with regular columns.  Columns that are not selected are
+     *  never read.  Custom readers added via customize() are not affected.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a column does not exist.
+     */
+    void select(std::vector<std::string> const &ttypes);
+
+    /**
+     *  Add the fields of a schema to any selection made by select(), so a table that requires a minimal
+     *  schema can still be constructed from a subset of the columns.  Fields in the schema that have no
+     *  corresponding column are ignored.
+     */
+    void require(Schema const &schema);
+
     /**
      *  Customize a mapping by providing a FitsColumnReader instance that will be invoked by readRecords().
      */
@@ -139,6 +171,14 @@ public:
      */
     void readRecord(BaseRecord &record, afw::fits::Fits &fits, std::size_t row);
 
+    /**
+     *  Fill records from a block of consecutive FITS binary table rows, starting at firstRow.
+     *
+     *  This is equivalent to calling readRecord() on each record, but reads each column of the block with a
+     *  single call wherever possible.
+     */
+    void readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits, std::size_t firstRow);
+
 private:
     class Impl;
     std::shared_ptr<Impl> _impl;
@@ -23,6 +23,7 @@
 #define AFW_TABLE_PYTHON_CATALOG_H_INCLUDED
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include "lsst/utils/python.h"
 #include "lsst/afw/table/BaseColumnView.h"
@@ -153,6 +154,14 @@ PyCatalog<Record> declareCatalog(pybind11::module &mod, std::string const &name,
                    "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
     cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                    "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+    cls.def_static("readFits",
+                   (Catalog(*)(std::string const &, std::vector<std::string> const &, int, int)) &
+                           Catalog::readFits,
+                   "filename"_a, "columns"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+    cls.def_static("readFits",
+                   (Catalog(*)(fits::MemFileManager &, std::vector<std::string> const &, int, int)) &
+                           Catalog::readFits,
+                   "manager"_a, "columns"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
     // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
 
     /* Methods */
@@ -80,6 +80,14 @@ PySortedCatalog<Record> declareSortedCatalog(pybind11::module &mod, std::string
                    "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
     cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                    "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+    cls.def_static("readFits",
+                   (Catalog(*)(std::string const &, std::vector<std::string> const &, int, int)) &
+                           Catalog::readFits,
+                   "filename"_a, "columns"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+    cls.def_static("readFits",
+                   (Catalog(*)(fits::MemFileManager &, std::vector<std::string> const &, int, int)) &
+                           Catalog::readFits,
+                   "manager"_a, "columns"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
     // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
 
     cls.def("subset", (Catalog(Catalog::*)(ndarray::Array<bool const, 1> const &) const) & Catalog::subset);
@@ -47,7 +47,7 @@ PYBIND11_MODULE(footprintMerge, mod) {
     clsFootprintMergeList.def("getPeakSchema", &FootprintMergeList::getPeakSchema);
     clsFootprintMergeList.def("addCatalog", &FootprintMergeList::addCatalog, "sourceTable"_a, "inputCat"_a,
                               "filter"_a, "minNewPeakDist"_a = -1., "doMerge"_a = true,
-                              "maxSamePeakDist"_a = -1.);
+                              "maxSamePeakDist"_a = -1., "nThreads"_a = 1);
     clsFootprintMergeList.def("clearCatalog", &FootprintMergeList::clearCatalog);
     clsFootprintMergeList.def("getFinalSources", &FootprintMergeList::getFinalSources, "outputCat"_a);
 }
@@ -7,8 +7,11 @@ from .footprintMerge import FootprintMergeList
 @continueClass  # noqa F811
 class FootprintMergeList:
     def getMergedSourceCatalog(self, catalogs, filters,
-                               peakDist, schema, idFactory, samePeakDist):
-        """Add multiple catalogs and get the SourceCatalog with merged Footprints"""
+                               peakDist, schema, idFactory, samePeakDist, nThreads=1):
+        """Add multiple catalogs and get the SourceCatalog with merged Footprints
+
+        ``nThreads`` is passed to `addCatalog`; the result does not depend on it.
+        """
         import lsst.afw.table as afwTable
 
         table = afwTable.SourceTable.make(schema, idFactory)
@@ -39,7 +42,7 @@ class FootprintMergeList:
 
         self.clearCatalog()
         for cat, filter, dist, sameDist in zip(catalogs, filters, peakDist, samePeakDist):
-            self.addCatalog(table, cat, filter, dist, True, sameDist)
+            self.addCatalog(table, cat, filter, dist, True, sameDist, nThreads)
 
         self.getFinalSources(mergedList)
         return mergedList
@@ -61,11 +61,12 @@ void declareSetMask(PyClass &cls) {
 template <typename PixelT, typename PyClass>
 void declareTemplatedMembers(PyClass &cls) {
     /* Constructors */
-    cls.def(py::init<image::Image<PixelT> const &, Threshold const &, int const, bool const>(), "img"_a,
-            "threshold"_a, "npixMin"_a = 1, "setPeaks"_a = true);
+    cls.def(py::init<image::Image<PixelT> const &, Threshold const &, int const, bool const, int const>(),
+            "img"_a, "threshold"_a, "npixMin"_a = 1, "setPeaks"_a = true, "nThreads"_a = 1);
     cls.def(py::init<image::MaskedImage<PixelT, image::MaskPixel> const &, Threshold const &,
-                     std::string const &, int const, bool const>(),
-            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true);
+                     std::string const &, int const, bool const, int const>(),
+            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true,
+            "nThreads"_a = 1);
 
     /* Members */
     declareMakeHeavy<int>(cls);
@@ -88,15 +89,17 @@ PYBIND11_MODULE(footprintSet, mod) {
     declareTemplatedMembers<float>(clsFootprintSet);
     declareTemplatedMembers<double>(clsFootprintSet);
 
-    clsFootprintSet.def(py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const>(),
-                        "img"_a, "threshold"_a, "npixMin"_a = 1);
+    clsFootprintSet.def(
+            py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const, int const>(),
+            "img"_a, "threshold"_a, "npixMin"_a = 1, "nThreads"_a = 1);
 
     /* Members */
     clsFootprintSet.def(py::init<lsst::geom::Box2I>(), "region"_a);
     clsFootprintSet.def(py::init<FootprintSet const &>(), "set"_a);
-    clsFootprintSet.def(py::init<FootprintSet const &, int, FootprintControl const &>(), "set"_a, "rGrow"_a,
-                        "ctrl"_a);
-    clsFootprintSet.def(py::init<FootprintSet const &, int, bool>(), "set"_a, "rGrow"_a, "isotropic"_a);
+    clsFootprintSet.def(py::init<FootprintSet const &, int, FootprintControl const &, int>(), "set"_a,
+                        "rGrow"_a, "ctrl"_a, "nThreads"_a = 1);
+    clsFootprintSet.def(py::init<FootprintSet const &, int, bool, int>(), "set"_a, "rGrow"_a, "isotropic"_a,
+                        "nThreads"_a = 1);
     clsFootprintSet.def(py::init<FootprintSet const &, FootprintSet const &, bool>(), "footprints1"_a,
                         "footprints2"_a, "includePeaks"_a);
 
@@ -119,7 +122,7 @@ PYBIND11_MODULE(footprintSet, mod) {
                                                 std::string const &)) &
                                 FootprintSet::setMask<lsst::afw::image::MaskPixel>);
     clsFootprintSet.def("merge", &FootprintSet::merge, "rhs"_a, "tGrow"_a = 0, "rGrow"_a = 0,
-                        "isotropic"_a = true);
+                        "isotropic"_a = true, "nThreads"_a = 1);
 
     /* Module level */
 
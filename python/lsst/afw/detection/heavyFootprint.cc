@@ -52,6 +52,10 @@ void declareHeavyFootprint(py::module &mod, std::string const &suffix) {
             "foot"_a, "mimage"_a, "ctrl"_a = nullptr);
     clsHeavyFootprint.def(py::init<Footprint const &, HeavyFootprintCtrl const *>(), "foot"_a,
                           "ctrl"_a = nullptr);
+    clsHeavyFootprint.def(py::init<Footprint const &, ndarray::Array<ImagePixelT, 1, 1> const &,
+                                   ndarray::Array<MaskPixelT, 1, 1> const &,
+                                   ndarray::Array<VariancePixelT, 1, 1> const &>(),
+                          "foot"_a, "image"_a, "mask"_a, "variance"_a);
 
     /* Members */
     clsHeavyFootprint.def("isHeavy", &Class::isHeavy);
@@ -75,6 +79,9 @@ void declareHeavyFootprint(py::module &mod, std::string const &suffix) {
                       HeavyFootprintCtrl const *))makeHeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>,
             "foot"_a, "img"_a, "ctrl"_a = nullptr);
 
+    mod.def("makeHeavyFootprints", makeHeavyFootprints<ImagePixelT, MaskPixelT, VariancePixelT>,
+            "footprints"_a, "mimage"_a, "ctrl"_a = nullptr);
+
     // In Swig this seems to be suffixed with a type (i.e. mergeHeavyFootprintsF)
     // but there really doesn't seem any good reason why that is done, so removed it
     mod.def("mergeHeavyFootprints", mergeHeavyFootprints<ImagePixelT, MaskPixelT, VariancePixelT>);
@@ -23,7 +23,9 @@
 #include <memory>
 
 #include <pybind11/pybind11.h>
-//#include <pybind11/stl.h>
+#include <pybind11/stl.h>
+
+#include "ndarray/pybind11.h"
 
 #include "lsst/daf/base/Citizen.h"
 #include "lsst/geom/Point.h"
@@ -52,6 +54,11 @@ PYBIND11_MODULE(psf, mod) {
             .value("INTERNAL", Psf::ImageOwnerEnum::INTERNAL)
             .export_values();
 
+    py::class_<Psf::CacheStatistics>(cls, "CacheStatistics")
+            .def_readonly("hits", &Psf::CacheStatistics::hits)
+            .def_readonly("misses", &Psf::CacheStatistics::misses)
+            .def_readonly("evictions", &Psf::CacheStatistics::evictions);
+
     table::io::python::addPersistableMethods<Psf>(cls);
 
     /* Members */
@@ -66,6 +73,11 @@ PYBIND11_MODULE(psf, mod) {
             "color"_a = image::Color());
     cls.def("computeShape", &Psf::computeShape, "position"_a = NullPoint, "color"_a = image::Color());
     cls.def("computeBBox", &Psf::computeBBox, "position"_a = NullPoint, "color"_a = image::Color());
+    cls.def("computeKernelImages", &Psf::computeKernelImages, "positions"_a,
+            "colors"_a = std::vector<image::Color>(), "owner"_a = Psf::ImageOwnerEnum::COPY);
+    cls.def("computeApertureFluxes", &Psf::computeApertureFluxes, "radius"_a, "positions"_a,
+            "colors"_a = std::vector<image::Color>());
+    cls.def("computeShapes", &Psf::computeShapes, "positions"_a, "colors"_a = std::vector<image::Color>());
     cls.def("getLocalKernel", &Psf::getLocalKernel, "position"_a = NullPoint, "color"_a = image::Color());
     cls.def("getAverageColor", &Psf::getAverageColor);
     cls.def("getAveragePosition", &Psf::getAveragePosition);
@@ -73,6 +85,8 @@ PYBIND11_MODULE(psf, mod) {
                    "warpAlgorithm"_a = "lanczos5", "warpBuffer"_a = 5);
     cls.def("getCacheCapacity", &Psf::getCacheCapacity);
     cls.def("setCacheCapacity", &Psf::setCacheCapacity);
+    cls.def("getCacheStatistics", &Psf::getCacheStatistics);
+    cls.def("resetCacheStatistics", &Psf::resetCacheStatistics);
 }
 }
 }
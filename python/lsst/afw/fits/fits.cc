@@ -51,10 +51,11 @@ void declareImageCompression(py::module & mod) {
         value("PLIO", ImageCompressionOptions::CompressionAlgorithm::PLIO).
         export_values();
 
-    cls.def(py::init<ImageCompressionOptions::CompressionAlgorithm, ImageCompressionOptions::Tiles, float>(),
-            "algorithm"_a, "tiles"_a, "quantizeLevel"_a=0.0);
-    cls.def(py::init<ImageCompressionOptions::CompressionAlgorithm, int, float>(), "algorithm"_a, "rows"_a=1,
-            "quantizeLevel"_a=0.0);
+    cls.def(py::init<ImageCompressionOptions::CompressionAlgorithm, ImageCompressionOptions::Tiles, float,
+                     int>(),
+            "algorithm"_a, "tiles"_a, "quantizeLevel"_a=0.0, "nThreads"_a=1);
+    cls.def(py::init<ImageCompressionOptions::CompressionAlgorithm, int, float, int>(), "algorithm"_a,
+            "rows"_a=1, "quantizeLevel"_a=0.0, "nThreads"_a=1);
 
     cls.def(py::init<lsst::afw::image::Image<unsigned char> const&>());
     cls.def(py::init<lsst::afw::image::Image<unsigned short> const&>());
@@ -73,6 +74,7 @@ void declareImageCompression(py::module & mod) {
     cls.def_readonly("algorithm", &ImageCompressionOptions::algorithm);
     cls.def_readonly("tiles", &ImageCompressionOptions::tiles);
     cls.def_readonly("quantizeLevel", &ImageCompressionOptions::quantizeLevel);
+    cls.def_readonly("nThreads", &ImageCompressionOptions::nThreads);
 }
 
 
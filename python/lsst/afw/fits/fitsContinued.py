@@ -23,9 +23,9 @@ class ImageWriteOptions:
 @continueClass  # noqa F811
 class ImageCompressionOptions:
     def __repr__(self):
-        return ("%s(algorithm=%r, tiles=%r, quantizeLevel=%f" %
+        return ("%s(algorithm=%r, tiles=%r, quantizeLevel=%f, nThreads=%d" %
                 (self.__class__.__name__, compressionAlgorithmToString(self.algorithm),
-                 self.tiles.tolist(), self.quantizeLevel))
+                 self.tiles.tolist(), self.quantizeLevel, self.nThreads))
 
 
 @continueClass  # noqa F811
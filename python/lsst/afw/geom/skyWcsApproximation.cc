@@ -0,0 +1,82 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include "ndarray/pybind11.h"
+
+#include "lsst/afw/geom/SkyWcsApproximation.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst { namespace afw { namespace geom { namespace {
+
+using PySkyWcsApproximation = py::class_<SkyWcsApproximation, std::shared_ptr<SkyWcsApproximation>>;
+
+PYBIND11_MODULE(skyWcsApproximation, mod) {
+    py::module::import("lsst.geom");
+    py::module::import("lsst.afw.geom.skyWcs");
+
+    PySkyWcsApproximation cls(mod, "SkyWcsApproximation");
+
+    cls.def(py::init<SkyWcs const &, lsst::geom::Box2D const &, lsst::geom::Angle const &, int>(),
+            "wcs"_a, "bbox"_a, "maxError"_a=0.001*lsst::geom::arcseconds, "maxGridSize"_a=1025);
+
+    cls.def("pixelToSky",
+            py::overload_cast<lsst::geom::Point2D const &>(&SkyWcsApproximation::pixelToSky, py::const_),
+            "pixel"_a);
+    cls.def("pixelToSky",
+            py::overload_cast<std::vector<lsst::geom::Point2D> const &>(&SkyWcsApproximation::pixelToSky,
+                                                                        py::const_),
+            "pixels"_a);
+    cls.def("pixelToSkyArray",
+            [](SkyWcsApproximation const & self, ndarray::Array<double const, 1> const & x,
+               ndarray::Array<double const, 1> const & y) {
+                ndarray::Array<double, 1, 1> ra = ndarray::allocate(x.getSize<0>());
+                ndarray::Array<double, 1, 1> dec = ndarray::allocate(x.getSize<0>());
+                self.pixelToSky(x, y, ra, dec);
+                return py::make_tuple(ra, dec);
+            },
+            "x"_a, "y"_a);
+    cls.def("skyToPixel",
+            py::overload_cast<lsst::geom::SpherePoint const &>(&SkyWcsApproximation::skyToPixel, py::const_),
+            "sky"_a);
+    cls.def("skyToPixel",
+            py::overload_cast<std::vector<lsst::geom::SpherePoint> const &>(
+                &SkyWcsApproximation::skyToPixel, py::const_),
+            "sky"_a);
+    cls.def("skyToPixelArray",
+            [](SkyWcsApproximation const & self, ndarray::Array<double const, 1> const & ra,
+               ndarray::Array<double const, 1> const & dec) {
+                ndarray::Array<double, 1, 1> x = ndarray::allocate(ra.getSize<0>());
+                ndarray::Array<double, 1, 1> y = ndarray::allocate(ra.getSize<0>());
+                self.skyToPixel(ra, dec, x, y);
+                return py::make_tuple(x, y);
+            },
+            "ra"_a, "dec"_a);
+    cls.def("getBBox", &SkyWcsApproximation::getBBox);
+    cls.def("getGridShape", &SkyWcsApproximation::getGridShape);
+    cls.def("getMaxError", &SkyWcsApproximation::getMaxError);
+}
+
+}}}}  // namespace lsst::afw::geom::<anonymous>
@@ -301,38 +301,38 @@ void declareExposureFitsReader(py::module & mod) {
     cls.def(
         "readMaskedImage",
         [](ExposureFitsReader & self, lsst::geom::Box2I const & bbox, ImageOrigin origin,
-           bool conformMasks, bool allowUnsafe, py::object dtype) {
+           bool conformMasks, bool allowUnsafe, py::object dtype, int nThreads) {
             if (dtype == py::none()) {
                 dtype = py::dtype(self.readImageDType());
             }
             return utils::python::TemplateInvoker().apply(
                 [&](auto t) {
-                    return self.readMaskedImage<decltype(t)>(bbox, origin, conformMasks, allowUnsafe);
+                    return self.readMaskedImage<decltype(t)>(bbox, origin, conformMasks, allowUnsafe, nThreads);
                 },
                 py::dtype(dtype),
                 utils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double, std::uint64_t>()
             );
         },
         "bbox"_a=lsst::geom::Box2I(), "origin"_a=PARENT, "conformMasks"_a=false, "allowUnsafe"_a=false,
-        "dtype"_a=py::none()
+        "dtype"_a=py::none(), "nThreads"_a=1
     );
     cls.def(
         "read",
         [](ExposureFitsReader & self, lsst::geom::Box2I const & bbox, ImageOrigin origin,
-           bool conformMasks, bool allowUnsafe, py::object dtype) {
+           bool conformMasks, bool allowUnsafe, py::object dtype, int nThreads) {
             if (dtype == py::none()) {
                 dtype = py::dtype(self.readImageDType());
             }
             return utils::python::TemplateInvoker().apply(
                 [&](auto t) {
-                    return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe);
+                    return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe, nThreads);
                 },
                 py::dtype(dtype),
                 utils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double, std::uint64_t>()
             );
         },
         "bbox"_a=lsst::geom::Box2I(), "origin"_a=PARENT, "conformMasks"_a=false, "allowUnsafe"_a=false,
-        "dtype"_a=py::none()
+        "dtype"_a=py::none(), "nThreads"_a=1
     );
 }
 
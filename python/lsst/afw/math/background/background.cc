@@ -132,6 +132,8 @@ PYBIND11_MODULE(background, mod) {
     clsBackgroundControl.def("getApproximateControl",
                              (std::shared_ptr<ApproximateControl> (BackgroundControl::*)()) &
                                      BackgroundControl::getApproximateControl);
+    clsBackgroundControl.def("getNThreads", &BackgroundControl::getNThreads);
+    clsBackgroundControl.def("setNThreads", &BackgroundControl::setNThreads, "nThreads"_a);
 
     /* Note that, in this case, the holder type must be unique_ptr to enable usage
      * of py::nodelete, which in turn is needed because Background has a protected
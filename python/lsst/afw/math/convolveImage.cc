@@ -86,6 +86,11 @@ PYBIND11_MODULE(convolveImage, mod) {
     clsConvolutionControl.def("setDoCopyEdge", &ConvolutionControl::setDoCopyEdge);
     clsConvolutionControl.def("setMaxInterpolationDistance",
                               &ConvolutionControl::setMaxInterpolationDistance);
+    clsConvolutionControl.def("getNThreads", &ConvolutionControl::getNThreads);
+    clsConvolutionControl.def("setNThreads", &ConvolutionControl::setNThreads, "nThreads"_a);
+    clsConvolutionControl.def("getMinFftKernelSize", &ConvolutionControl::getMinFftKernelSize);
+    clsConvolutionControl.def("setMinFftKernelSize", &ConvolutionControl::setMinFftKernelSize,
+                              "minFftKernelSize"_a);
 
     declareAll<double, double>(mod);
     declareAll<double, float>(mod);
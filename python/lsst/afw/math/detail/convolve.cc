@@ -25,6 +25,7 @@
 //#include <pybind11/stl.h>
 
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/ConvolveRows.h"
 
 namespace py = pybind11;
 
@@ -76,6 +77,9 @@ PYBIND11_MODULE(convolve, mod) {
     declareAll<int, int>(mod);
     declareAll<std::uint16_t, std::uint16_t>(mod);
 
+    mod.def("getConvolveRowsInstructionSet", getConvolveRowsInstructionSet);
+    mod.def("setConvolveRowsSimdEnabled", setConvolveRowsSimdEnabled, "enabled"_a);
+
     py::class_<KernelImagesForRegion, std::shared_ptr<KernelImagesForRegion>> clsKernelImagesForRegion(
             mod, "KernelImagesForRegion");
 
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <pybind11/pybind11.h>
+#include <pybind11/functional.h>
 //#include <pybind11/operators.h>
 #include <pybind11/stl.h>
 
@@ -72,6 +73,16 @@ void declareStatisticsStack(py::module &mod) {
                       std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const &
                 ))statisticsStack<PixelT>,
             "out"_a, "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
+                      std::vector<MaskedImageBlockReader<PixelT>> const &, Property,
+                      StatisticsControl const &,
+                      std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel,
+                      std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const &
+                      , int))statisticsStack<PixelT>,
+            "out"_a, "readers"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "blockHeight"_a = 256);
     mod.def("statisticsStack",
             (std::shared_ptr<lsst::afw::image::Image<PixelT>>(*)(
                     std::vector<std::shared_ptr<lsst::afw::image::Image<PixelT>>> &, Property,
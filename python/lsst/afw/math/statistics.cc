@@ -115,6 +115,7 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("getWeightedIsSet", &StatisticsControl::getWeightedIsSet);
     clsStatisticsControl.def("getCalcErrorFromInputVariance",
                              &StatisticsControl::getCalcErrorFromInputVariance);
+    clsStatisticsControl.def("getNThreads", &StatisticsControl::getNThreads);
     clsStatisticsControl.def("setNumSigmaClip", &StatisticsControl::setNumSigmaClip);
     clsStatisticsControl.def("setNumIter", &StatisticsControl::setNumIter);
     clsStatisticsControl.def("setAndMask", &StatisticsControl::setAndMask);
@@ -123,6 +124,7 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("setWeighted", &StatisticsControl::setWeighted);
     clsStatisticsControl.def("setCalcErrorFromInputVariance",
                              &StatisticsControl::setCalcErrorFromInputVariance);
+    clsStatisticsControl.def("setNThreads", &StatisticsControl::setNThreads);
 
     py::class_<Statistics> clsStatistics(mod, "Statistics");
 
@@ -178,6 +178,11 @@ PYBIND11_MODULE(warpExposure, mod) {
                           "maskWarpingKernel"_a);
     clsWarpingControl.def("getGrowFullMask", &WarpingControl::getGrowFullMask);
     clsWarpingControl.def("setGrowFullMask", &WarpingControl::setGrowFullMask, "growFullMask"_a);
+    clsWarpingControl.def("getNThreads", &WarpingControl::getNThreads);
+    clsWarpingControl.def("setNThreads", &WarpingControl::setNThreads, "nThreads"_a);
+    clsWarpingControl.def("getLanczosTableOversampling", &WarpingControl::getLanczosTableOversampling);
+    clsWarpingControl.def("setLanczosTableOversampling", &WarpingControl::setLanczosTableOversampling,
+                          "oversampling"_a);
 
     /* Members */
 }
@@ -23,6 +23,7 @@
 from .aliasMap import *
 from .schema import *
 from .baseColumnView import *
+from .mappedFitsTable import *
 from .base import *
 from .idFactory import *
 from .aggregates import *
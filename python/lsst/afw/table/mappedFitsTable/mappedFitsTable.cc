@@ -0,0 +1,84 @@
+/*
+ * LSST Data Management System
+ * Copyright 2008-2017  AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include "pybind11/pybind11.h"
+
+#include "ndarray/pybind11.h"
+
+#include "lsst/afw/table/Key.h"
+#include "lsst/afw/table/MappedFitsTable.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace {
+
+using PyMappedFitsTable = py::class_<MappedFitsTable, std::shared_ptr<MappedFitsTable>>;
+
+template <typename T>
+void declareScalarAccessor(PyMappedFitsTable &cls) {
+    cls.def("_basicget", [](MappedFitsTable const &self, Key<T> const &key) { return self[key]; });
+}
+
+template <typename T>
+void declareArrayAccessor(PyMappedFitsTable &cls) {
+    cls.def("_basicget", [](MappedFitsTable const &self, Key<Array<T>> const &key) { return self[key]; });
+}
+
+PYBIND11_MODULE(mappedFitsTable, mod) {
+    py::module::import("lsst.afw.table.schema");
+
+    PyMappedFitsTable cls(mod, "MappedFitsTable");
+    cls.def(py::init<std::string const &, int>(), "filename"_a, "hdu"_a = fits::DEFAULT_HDU);
+    cls.def("getSchema", &MappedFitsTable::getSchema);
+    cls.def_property_readonly("schema", &MappedFitsTable::getSchema);
+    cls.def("size", &MappedFitsTable::size);
+    declareScalarAccessor<std::uint8_t>(cls);
+    declareScalarAccessor<std::uint16_t>(cls);
+    declareScalarAccessor<std::int32_t>(cls);
+    declareScalarAccessor<std::int64_t>(cls);
+    declareScalarAccessor<float>(cls);
+    declareScalarAccessor<double>(cls);
+    declareArrayAccessor<std::uint8_t>(cls);
+    declareArrayAccessor<std::uint16_t>(cls);
+    declareArrayAccessor<std::int32_t>(cls);
+    declareArrayAccessor<std::int64_t>(cls);
+    declareArrayAccessor<float>(cls);
+    declareArrayAccessor<double>(cls);
+    cls.def("_basicget", [](MappedFitsTable const &self, Key<Flag> const &key) { return self[key]; });
+    // As in BaseColumnView, lsst::geom::Angle columns are returned as arrays of radians.
+    using AngleArray = ndarray::Array<lsst::geom::Angle const, 1>;
+    using DoubleArray = ndarray::Array<double const, 1>;
+    cls.def("_basicget", [](MappedFitsTable const &self, Key<lsst::geom::Angle> const &key) -> DoubleArray {
+        AngleArray a = self[key];
+        return ndarray::detail::ArrayAccess<DoubleArray>::construct(
+                reinterpret_cast<double const *>(a.getData()),
+                ndarray::detail::ArrayAccess<AngleArray>::getCore(a));
+    });
+}
+}  // namespace
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
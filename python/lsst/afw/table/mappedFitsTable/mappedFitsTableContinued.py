@@ -0,0 +1,43 @@
+#
+# LSST Data Management System
+# Copyright 2018 LSST/AURA.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <http://www.lsstcorp.org/LegalNotices/>.
+#
+
+__all__ = []  # importing this module adds methods to MappedFitsTable
+
+from lsst.utils import continueClass
+from .mappedFitsTable import MappedFitsTable
+
+
+@continueClass  # noqa F811
+class MappedFitsTable:
+
+    def __getitem__(self, key):
+        """Get a read-only column array; key may be a key object or the name
+        of a field.
+        """
+        if isinstance(key, str):
+            key = self.schema.find(key).key
+        return self._basicget(key)
+
+    get = __getitem__
+
+    def __len__(self):
+        return self.size()
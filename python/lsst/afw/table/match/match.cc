@@ -23,6 +23,8 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include "ndarray/pybind11.h"
+
 #include "lsst/pex/config/python.h"  // for LSST_DECLARE_CONTROL_FIELD
 #include "lsst/afw/table/Simple.h"
 #include "lsst/afw/table/Source.h"
@@ -87,6 +89,7 @@ PYBIND11_MODULE(match, mod) {
     LSST_DECLARE_CONTROL_FIELD(clsMatchControl, MatchControl, findOnlyClosest);
     LSST_DECLARE_CONTROL_FIELD(clsMatchControl, MatchControl, symmetricMatch);
     LSST_DECLARE_CONTROL_FIELD(clsMatchControl, MatchControl, includeMismatches);
+    LSST_DECLARE_CONTROL_FIELD(clsMatchControl, MatchControl, nThreads);
 
     declareMatch2<SimpleCatalog, SimpleCatalog>(mod, "Simple");
     declareMatch2<SimpleCatalog, SourceCatalog>(mod, "Reference");
@@ -99,6 +102,19 @@ PYBIND11_MODULE(match, mod) {
             "cat1"_a, "cat2"_a, "radius"_a, "mc"_a = MatchControl());
     mod.def("matchXy", (SourceMatchVector(*)(SourceCatalog const &, double, MatchControl const &))matchXy,
             "cat"_a, "radius"_a, "mc"_a = MatchControl());
+    mod.def("matchXy",
+            (SourceMatchVector(*)(SourceCatalog const &, SourceCatalog const &, XyIndex const &, double,
+                                  MatchControl const &))matchXy,
+            "cat1"_a, "cat2"_a, "index2"_a, "radius"_a, "mc"_a = MatchControl());
+
+    py::class_<XyIndex, std::shared_ptr<XyIndex>> clsXyIndex(mod, "XyIndex");
+    clsXyIndex.def(py::init<SourceCatalog const &>(), "cat"_a);
+    clsXyIndex.def(
+            py::init<ndarray::Array<double const, 1> const &, ndarray::Array<double const, 1> const &>(),
+            "x"_a, "y"_a);
+    clsXyIndex.def("__len__", &XyIndex::size);
+    clsXyIndex.def("findWithin", &XyIndex::findWithin, "center"_a, "radius"_a);
+    clsXyIndex.def("findNearest", &XyIndex::findNearest, "center"_a, "n"_a);
     // The following are deprecated; consider changing the code instead of wrapping them:
     // mod.def("matchXy",
     //         (SourceMatchVector (*)(SourceCatalog const &, SourceCatalog const &, double, bool))
@@ -19,13 +19,19 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <utility>
 
 #include "boost/bind.hpp"
+#include "boost/geometry/geometry.hpp"
+#include "boost/geometry/index/rtree.hpp"
 
 #include "lsst/afw/detection/FootprintMerge.h"
 #include "lsst/afw/detection/FootprintSet.h"
 #include "lsst/afw/table/IdFactory.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -238,61 +244,153 @@ void FootprintMergeList::_initialize(afw::table::Schema &sourceSchema,
     _peakTable = PeakTable::make(_peakSchemaMapper.getOutputSchema());
 }
 
+namespace {
+
+typedef boost::geometry::model::point<int, 2, boost::geometry::cs::cartesian> IndexPoint;
+typedef boost::geometry::model::box<IndexPoint> IndexBox;
+typedef std::pair<IndexBox, std::size_t> IndexValue;  // bounding box and position in the merge list
+typedef boost::geometry::index::rtree<IndexValue, boost::geometry::index::rstar<16>> MergeIndex;
+
+IndexBox makeIndexBox(lsst::geom::Box2I const &box) {
+    return IndexBox(IndexPoint(box.getMinX(), box.getMinY()), IndexPoint(box.getMaxX(), box.getMaxY()));
+}
+
+// Return the positions (in increasing order) of the indexed merges whose boxes overlap a bounding box
+std::vector<std::size_t> findCandidates(MergeIndex const &index, lsst::geom::Box2I const &bbox) {
+    std::vector<std::size_t> result;
+    if (bbox.isEmpty()) {
+        return result;
+    }
+    std::vector<IndexValue> values;
+    index.query(boost::geometry::index::intersects(makeIndexBox(bbox)), std::back_inserter(values));
+    result.reserve(values.size());
+    for (auto const &value : values) {
+        result.push_back(value.second);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
 void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sourceTable,
                                     afw::table::SourceCatalog const &inputCat, std::string const &filter,
-                                    float minNewPeakDist, bool doMerge, float maxSamePeakDist) {
+                                    float minNewPeakDist, bool doMerge, float maxSamePeakDist,
+                                    int nThreads) {
     FilterMap::const_iterator keyIter = _filterMap.find(filter);
     if (keyIter == _filterMap.end()) {
         throw LSST_EXCEPT(pex::exceptions::LogicError,
                           (boost::format("Filter %s not in original list") % filter).str());
     }
+    nThreads = math::detail::resolveNThreads(nThreads);
 
-    // If list is empty don't check for any matches, just add all the objects
-    bool checkForMatches = (_mergeList.size() > 0);
-
+    // Only consider unblended objects
+    std::vector<std::shared_ptr<Footprint>> footprints;
     for (afw::table::SourceCatalog::const_iterator srcIter = inputCat.begin(); srcIter != inputCat.end();
          ++srcIter) {
-        // Only consider unblended objects
-        if (srcIter->getParent() != 0) continue;
+        if (srcIter->getParent() == 0) {
+            footprints.push_back(srcIter->getFootprint());
+        }
+    }
 
-        std::shared_ptr<Footprint> foot = srcIter->getFootprint();
+    // If list is empty don't check for any matches, just add all the objects
+    if (_mergeList.empty()) {
+        for (auto const &foot : footprints) {
+            _mergeList.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
+                                                                  _peakSchemaMapper, keyIter->second));
+        }
+        return;
+    }
+
+    // Index the bounding boxes of the merges, grown by one pixel to allow for touching.  Merges that are
+    // absorbed into another are reset to null and removed from the index, so positions in _mergeList
+    // remain valid until the end, and sorting candidates by position visits them in list order.
+    std::size_t const nInitial = _mergeList.size();
+    std::vector<lsst::geom::Box2I> boxes;  // the box of each merge as it is in the index
+    std::vector<IndexValue> values;
+    boxes.reserve(nInitial);
+    values.reserve(nInitial);
+    for (std::size_t i = 0; i < nInitial; ++i) {
+        lsst::geom::Box2I box(_mergeList[i]->getBBox());
+        box.grow(lsst::geom::Extent2I(1, 1));
+        boxes.push_back(box);
+        if (!box.isEmpty()) {
+            values.emplace_back(makeIndexBox(box), i);
+        }
+    }
+    MergeIndex index(values.begin(), values.end());
+    auto updateIndex = [&index, &boxes](std::size_t i, lsst::geom::Box2I const &box) {
+        if (!boxes[i].isEmpty()) {
+            index.remove(IndexValue(makeIndexBox(boxes[i]), i));
+        }
+        boxes[i] = box;
+        if (!box.isEmpty()) {
+            index.insert(IndexValue(makeIndexBox(box), i));
+        }
+    };
+
+    // Find the existing merges that each Footprint overlaps.  These tests dominate the cost, and don't
+    // depend on each other, so we do them in parallel; as merges change while the Footprints are added
+    // below, only the ones that have changed need to be tested again.
+    std::vector<std::vector<std::size_t>> initialMatches(footprints.size());
+    math::detail::parallelFor(footprints.size(), nThreads, [&](int i) {
+        for (std::size_t j : findCandidates(index, footprints[i]->getBBox())) {
+            if (_mergeList[j]->overlaps(*footprints[i])) {
+                initialMatches[i].push_back(j);
+            }
+        }
+    });
+
+    std::vector<bool> changed(nInitial, false);  // has this merge changed since it was tested above?
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        std::shared_ptr<Footprint> const &foot = footprints[i];
 
         // Empty pointer to account for the first match in the catalog.  If there is more than one
         // match, subsequent matches will be merged with this one
         std::shared_ptr<FootprintMerge> first = std::shared_ptr<FootprintMerge>();
-
-        if (checkForMatches) {
-            FootprintMergeVec::iterator iter = _mergeList.begin();
-            while (iter != _mergeList.end()) {
-                // Grow by one pixel to allow for touching
-                lsst::geom::Box2I box((**iter).getBBox());
-                box.grow(lsst::geom::Extent2I(1, 1));
-                if (box.overlaps(foot->getBBox()) && (**iter).overlaps(*foot)) {
-                    if (!first) {
-                        first = *iter;
-                        // Add Footprint to existing merge and set flag for this band
-                        if (doMerge) {
-                            first->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist,
-                                       maxSamePeakDist);
-                        }
-                    } else {
-                        // Add merged Footprint to first
-                        if (doMerge) {
-                            first->add(**iter, _filterMap, minNewPeakDist, maxSamePeakDist);
-                            iter = _mergeList.erase(iter);
-                            continue;
-                        }
-                    }
+        std::size_t firstIndex = 0;
+
+        for (std::size_t j : findCandidates(index, foot->getBBox())) {
+            bool const overlaps = changed[j] ? _mergeList[j]->overlaps(*foot)
+                                             : std::binary_search(initialMatches[i].begin(),
+                                                                  initialMatches[i].end(), j);
+            if (!overlaps) {
+                continue;
+            }
+            if (!first) {
+                first = _mergeList[j];
+                firstIndex = j;
+                // Add Footprint to existing merge and set flag for this band
+                if (doMerge) {
+                    first->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist, maxSamePeakDist);
+                }
+            } else {
+                // Add merged Footprint to first
+                if (doMerge) {
+                    first->add(*_mergeList[j], _filterMap, minNewPeakDist, maxSamePeakDist);
+                    updateIndex(j, lsst::geom::Box2I());
+                    _mergeList[j].reset();
                 }
-                ++iter;
             }
         }
 
-        if (!first) {
+        if (first && doMerge) {
+            lsst::geom::Box2I box(first->getBBox());
+            box.grow(lsst::geom::Extent2I(1, 1));
+            updateIndex(firstIndex, box);
+            changed[firstIndex] = true;
+        } else if (!first) {
             _mergeList.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
                                                                   _peakSchemaMapper, keyIter->second));
+            boxes.emplace_back();
+            changed.push_back(true);
+            lsst::geom::Box2I box(_mergeList.back()->getBBox());
+            box.grow(lsst::geom::Extent2I(1, 1));
+            updateIndex(_mergeList.size() - 1, box);
         }
     }
+
+    _mergeList.erase(std::remove(_mergeList.begin(), _mergeList.end(), nullptr), _mergeList.end());
 }
 
 void FootprintMergeList::getFinalSources(afw::table::SourceCatalog &outputCat) {
@@ -40,16 +40,22 @@
        cout << "Found " << sources.getFootprints()->size() << " sources" << std::endl;
  */
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <numeric>
 #include <algorithm>
 #include <cassert>
 #include <set>
 #include <string>
+#include <tuple>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 #include "boost/format.hpp"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/detection/Peak.h"
 #include "lsst/afw/detection/FootprintSet.h"
 #include "lsst/afw/detection/FootprintCtrl.h"
@@ -62,8 +68,6 @@ namespace detection {
 namespace {
 /// Don't let doxygen see this block  @cond
 
-typedef std::uint64_t IdPixelT;  // Type of temporary Images used in merging Footprints
-
 struct Threshold_traits {};
 struct ThresholdLevel_traits : public Threshold_traits {  // Threshold is a single number
 };
@@ -146,49 +150,6 @@ inline bool isBadPixel(double val) {
     return std::isnan(val);
 }
 
-/*
- * Return the number of bits required to represent a unsigned long
- */
-int nbit(unsigned long i) {
-    int n = 0;
-    while (i > 0) {
-        ++n;
-        i >>= 1;
-    }
-
-    return n;
-}
-/*
- * Find the list of pixel values that lie in a Footprint
- *
- * Used when the Footprints are constructed from an Image containing Footprint indices
- */
-template <typename T>
-class FindIdsInFootprint {
-public:
-    explicit FindIdsInFootprint() : _ids(), _old(0) {}
-
-    // Reset everything for a new Footprint
-    void reset() {
-        _ids.clear();
-        _old = 0;
-    }
-
-    // Take by copy and not be reference on purpose
-    void operator()(lsst::geom::Point2I const &point, T val) {
-        if (val != _old) {
-            _ids.insert(val);
-            _old = val;
-        }
-    }
-
-    std::set<T> const &getIds() const { return _ids; }
-
-private:
-    std::set<T> _ids;
-    T _old;
-};
-
 /*
  * Sort peaks by decreasing pixel value.  N.b. -ve peaks are sorted the same way as +ve ones
  */
@@ -205,228 +166,6 @@ struct SortPeaks {
         return (a->getIy() < b->getIy());
     }
 };
-/*
- * Worker routine for merging two FootprintSets, possibly growing them as we proceed
- */
-FootprintSet mergeFootprintSets(FootprintSet const &lhs,      // the FootprintSet to be merged to
-                                int rLhs,                     // Grow lhs Footprints by this many pixels
-                                FootprintSet const &rhs,      // the FootprintSet to be merged into lhs
-                                int rRhs,                     // Grow rhs Footprints by this many pixels
-                                FootprintControl const &ctrl  // Control how the grow is done
-) {
-    typedef FootprintSet::FootprintList FootprintList;
-    // The isXXX routines return <isset, value>
-    bool const circular = ctrl.isCircular().first && ctrl.isCircular().second;
-    bool const isotropic = ctrl.isIsotropic().second;  // isotropic grow as opposed to a Manhattan metric
-                                                       // n.b. Isotropic grows are significantly slower
-    bool const left = ctrl.isLeft().first && ctrl.isLeft().second;
-    bool const right = ctrl.isRight().first && ctrl.isRight().second;
-    bool const up = ctrl.isUp().first && ctrl.isUp().second;
-    bool const down = ctrl.isDown().first && ctrl.isDown().second;
-
-    lsst::geom::Box2I const region = lhs.getRegion();
-    if (region != rhs.getRegion()) {
-        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
-                          boost::format("The two FootprintSets must have the same region").str());
-    }
-
-    auto idImage = std::make_shared<image::Image<IdPixelT>>(region);
-    idImage->setXY0(region.getMinX(), region.getMinY());
-    *idImage = 0;
-
-    FootprintList const &lhsFootprints = *lhs.getFootprints();
-    FootprintList const &rhsFootprints = *rhs.getFootprints();
-    int const nLhs = lhsFootprints.size();
-    int const nRhs = rhsFootprints.size();
-    /*
-     * In general the lists of Footprints overlap, so we need to make sure that the IDs can be
-     * uniquely recovered from the idImage.  We do this by allocating a range of bits to the lhs IDs
-     */
-    int const lhsIdNbit = nbit(nLhs);
-    int const lhsIdMask = (lhsIdNbit == 0) ? 0x0 : (1 << lhsIdNbit) - 1;
-
-    if (std::size_t(nRhs << lhsIdNbit) > std::numeric_limits<IdPixelT>::max() - 1) {
-        throw LSST_EXCEPT(pex::exceptions::OverflowError,
-                          (boost::format("%d + %d footprints need too many bits; change IdPixelT typedef") %
-                           nLhs % nRhs)
-                                  .str());
-    }
-    /*
-     * When we insert grown Footprints into the idImage we can potentially overwrite an entire Footprint,
-     * losing any peaks that it might contain.  We'll preserve the overwritten Ids in case we need to
-     * get them back (n.b. Footprints that overlap, but both if which survive, will appear in this list)
-     */
-    typedef std::map<int, std::set<std::uint64_t>> OldIdMap;
-    OldIdMap overwrittenIds;  // here's a map from id -> overwritten IDs
-
-    auto grower = [&circular, &up, &down, &left, &right, &isotropic](
-                          std::shared_ptr<Footprint> const &foot, int amount) -> std::shared_ptr<Footprint> {
-        if (circular) {
-            auto element = isotropic ? geom::Stencil::CIRCLE : geom::Stencil::MANHATTAN;
-            auto tmpFoot = std::make_shared<Footprint>(foot->getSpans()->dilated(amount, element),
-                                                       foot->getRegion());
-            return tmpFoot;
-        } else {
-            int top = up ? amount : 0;
-            int bottom = down ? amount : 0;
-            int lLimit = left ? amount : 0;
-            int rLimit = right ? amount : 0;
-
-            auto yRange = top + bottom + 1;
-            std::vector<geom::Span> spanList;
-            spanList.reserve(yRange);
-
-            for (auto dy = 1; dy <= top; ++dy) {
-                spanList.push_back(geom::Span(dy, 0, 0));
-            }
-            for (auto dy = -1; dy >= -bottom; --dy) {
-                spanList.push_back(geom::Span(dy, 0, 0));
-            }
-            spanList.push_back(geom::Span(0, -lLimit, rLimit));
-            geom::SpanSet structure(std::move(spanList));
-            auto tmpFoot =
-                    std::make_shared<Footprint>(foot->getSpans()->dilated(structure), foot->getRegion());
-            return tmpFoot;
-        }
-    };
-
-    IdPixelT id = 1;  // the ID inserted into the image
-    for (FootprintList::const_iterator ptr = lhsFootprints.begin(), end = lhsFootprints.end(); ptr != end;
-         ++ptr, ++id) {
-        std::shared_ptr<Footprint> foot = *ptr;
-
-        if (rLhs > 0 && foot->getArea() > 0) {
-            foot = grower(foot, rLhs);
-        }
-
-        std::set<std::uint64_t> overwritten;
-        foot->getSpans()
-                ->clippedTo(idImage->getBBox())
-                ->applyFunctor(setIdImage<IdPixelT>(id, &overwritten, true), *idImage);
-
-        if (!overwritten.empty()) {
-            overwrittenIds.insert(overwrittenIds.end(), std::make_pair(id, overwritten));
-        }
-    }
-
-    assert(id <= std::size_t(1 << lhsIdNbit));
-    id = (1 << lhsIdNbit);
-    for (FootprintList::const_iterator ptr = rhsFootprints.begin(), end = rhsFootprints.end(); ptr != end;
-         ++ptr, id += (1 << lhsIdNbit)) {
-        std::shared_ptr<Footprint> foot = *ptr;
-
-        if (rRhs > 0 && foot->getArea() > 0) {
-            foot = grower(foot, rRhs);
-        }
-
-        std::set<std::uint64_t> overwritten;
-        foot->getSpans()
-                ->clippedTo(idImage->getBBox())
-                ->applyFunctor(setIdImage<IdPixelT>(id, &overwritten, true, lhsIdMask), *idImage);
-
-        if (!overwritten.empty()) {
-            overwrittenIds.insert(overwrittenIds.end(), std::make_pair(id, overwritten));
-        }
-    }
-
-    FootprintSet fs(*idImage, Threshold(1), 1, false);  // detect all pixels in rhs + lhs
-                                                        /*
-                                                         * Now go through the new Footprints looking up and remembering their progenitor's IDs; we'll use
-                                                         * these IDs to merge the peaks in a moment
-                                                         *
-                                                         * We can't do this as we go through the idFinder as the IDs it returns are
-                                                         *   (lhsId + 1) | ((rhsId + 1) << nbit)
-                                                         * and, depending on the geometry, values of lhsId and/or rhsId can appear multiple times
-                                                         * (e.g. if nbit is 2, idFinder IDs 0x5 and 0x6 both contain lhsId = 0) so we get duplicates
-                                                         * of peaks.  This is not too bad, but it's a bit of a pain to make the lists unique again,
-                                                         * and we avoid this by this two-step process.
-                                                         */
-    FindIdsInFootprint<IdPixelT> idFinder;
-    for (FootprintList::iterator ptr = fs.getFootprints()->begin(), end = fs.getFootprints()->end();
-         ptr != end; ++ptr) {
-        std::shared_ptr<Footprint> foot = *ptr;
-
-        // find the (mangled) [lr]hsFootprint IDs that contribute to foot
-        foot->getSpans()->applyFunctor(idFinder, *idImage);
-
-        std::set<std::uint64_t> lhsFootprintIndxs, rhsFootprintIndxs;  // indexes into [lr]hsFootprints
-
-        for (std::set<IdPixelT>::iterator idptr = idFinder.getIds().begin(), idend = idFinder.getIds().end();
-             idptr != idend; ++idptr) {
-            unsigned int indx = *idptr;
-            if ((indx & lhsIdMask) > 0) {
-                std::uint64_t i = (indx & lhsIdMask) - 1;
-                lhsFootprintIndxs.insert(i);
-                /*
-                 * Now allow for Footprints that vanished beneath this one
-                 */
-                OldIdMap::iterator mapPtr = overwrittenIds.find(indx);
-                if (mapPtr != overwrittenIds.end()) {
-                    std::set<std::uint64_t> &overwritten = mapPtr->second;
-
-                    for (std::set<std::uint64_t>::iterator ptr = overwritten.begin(), end = overwritten.end();
-                         ptr != end; ++ptr) {
-                        lhsFootprintIndxs.insert((*ptr & lhsIdMask) - 1);
-                    }
-                }
-            }
-            indx >>= lhsIdNbit;
-
-            if (indx > 0) {
-                std::uint64_t i = indx - 1;
-                rhsFootprintIndxs.insert(i);
-                /*
-                 * Now allow for Footprints that vanished beneath this one
-                 */
-                OldIdMap::iterator mapPtr = overwrittenIds.find(indx);
-                if (mapPtr != overwrittenIds.end()) {
-                    std::set<std::uint64_t> &overwritten = mapPtr->second;
-
-                    for (std::set<std::uint64_t>::iterator ptr = overwritten.begin(), end = overwritten.end();
-                         ptr != end; ++ptr) {
-                        rhsFootprintIndxs.insert(*ptr - 1);
-                    }
-                }
-            }
-        }
-        /*
-         * We now have a complete set of Footprints that contributed to this one, so merge
-         * all their Peaks into the new one
-         */
-        PeakCatalog &peaks = foot->getPeaks();
-
-        for (std::set<std::uint64_t>::iterator ptr = lhsFootprintIndxs.begin(), end = lhsFootprintIndxs.end();
-             ptr != end; ++ptr) {
-            std::uint64_t i = *ptr;
-            assert(i < lhsFootprints.size());
-            PeakCatalog const &oldPeaks = lhsFootprints[i]->getPeaks();
-
-            int const nold = peaks.size();
-            peaks.insert(peaks.end(), oldPeaks.begin(), oldPeaks.end());
-            // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
-            // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
-            // it'd try to do if we passed Catalog's own iterators).
-            std::inplace_merge(peaks.getInternal().begin(), peaks.getInternal().begin() + nold,
-                               peaks.getInternal().end(), SortPeaks());
-        }
-
-        for (std::set<std::uint64_t>::iterator ptr = rhsFootprintIndxs.begin(), end = rhsFootprintIndxs.end();
-             ptr != end; ++ptr) {
-            std::uint64_t i = *ptr;
-            assert(i < rhsFootprints.size());
-            PeakCatalog const &oldPeaks = rhsFootprints[i]->getPeaks();
-
-            int const nold = peaks.size();
-            peaks.insert(peaks.end(), oldPeaks.begin(), oldPeaks.end());
-            // See note above on why we're using getInternal() here.
-            std::inplace_merge(peaks.getInternal().begin(), peaks.getInternal().begin() + nold,
-                               peaks.getInternal().end(), SortPeaks());
-        }
-        idFinder.reset();
-    }
-
-    return fs;
-}
 /*
  * run-length code for part of object
  */
@@ -469,8 +208,17 @@ int resolve_alias(std::vector<int> const &aliases, /* list of aliases */
 }  // namespace
 
 namespace {
+/*
+ * The positions and values of peaks found in a Footprint, before they are added to it
+ *
+ * Peaks are found in a list rather than added to the Footprint's PeakCatalog directly so they may be found
+ * for many Footprints concurrently; the PeakTable (and its IdFactory) is shared, so the peaks are added
+ * later in a fixed order to assign the same IDs regardless of the number of threads.
+ */
+typedef std::vector<std::tuple<int, int, double>> PeakCandidateList;
+
 template <typename ImageT>
-void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCatalog &peaks, Footprint &foot,
+void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCandidateList &peaks, Footprint const &foot,
                           std::size_t const margin = 0) {
     auto spanSet = foot.getSpans();
     if (spanSet->size() == 0) {
@@ -503,7 +251,7 @@ void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCatalog &peaks
                 }
             }
 
-            foot.addPeak(x + image.getX0(), y + image.getY0(), val);
+            peaks.emplace_back(x + image.getX0(), y + image.getY0(), val);
         }
     }
 }
@@ -534,7 +282,7 @@ public:
         }
     }
 
-    void addRecord(Footprint &foot) const { foot.addPeak(_x, _y, _polarity ? _max : _min); }
+    void addRecord(PeakCandidateList &peaks) const { peaks.emplace_back(_x, _y, _polarity ? _max : _min); }
 
 private:
     bool _polarity;
@@ -542,28 +290,44 @@ private:
     double _min, _max;
 };
 
+// Find the peaks in a Footprint; may be called for different Footprints concurrently
 template <typename ImageT, typename ThresholdT>
-void findPeaks(std::shared_ptr<Footprint> foot, ImageT const &img, bool polarity, ThresholdT) {
-    findPeaksInFootprint(img, polarity, foot->getPeaks(), *foot, 1);
-
-    // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
-    // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
-    // it'd try to do if we passed Catalog's own iterators).
-    std::stable_sort(foot->getPeaks().getInternal().begin(), foot->getPeaks().getInternal().end(),
-                     SortPeaks());
-
-    if (foot->getPeaks().empty()) {
-        FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
-        foot->getSpans()->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
-        maxFinder.addRecord(*foot);
-    }
+void findPeaks(Footprint const &foot, ImageT const &img, bool polarity, PeakCandidateList &peaks,
+               ThresholdT) {
+    findPeaksInFootprint(img, polarity, peaks, foot, 1);
 }
 
 // No need to search for peaks when processing a Mask
 template <typename ImageT>
-void findPeaks(std::shared_ptr<Footprint>, ImageT const &, bool, ThresholdBitmask_traits) {
+void findPeaks(Footprint const &, ImageT const &, bool, PeakCandidateList &, ThresholdBitmask_traits) {
     ;
 }
+
+/*
+ * Add the peaks found by findPeaks to a Footprint, in order of decreasing value; if there are none,
+ * add the Footprint's most extreme pixel
+ *
+ * Not thread safe, as the peaks' IDs are set by their (shared) PeakTable and ndarray's reference
+ * counting of the image's pixels is not atomic
+ */
+template <typename ImageT>
+void addPeaks(Footprint &foot, ImageT const &img, bool polarity, PeakCandidateList &peaks) {
+    if (peaks.empty()) {
+        FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
+        foot.getSpans()->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
+        maxFinder.addRecord(peaks);
+    }
+
+    for (auto const &peak : peaks) {
+        foot.addPeak(std::get<0>(peak), std::get<1>(peak), std::get<2>(peak));
+    }
+
+    // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
+    // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
+    // it'd try to do if we passed Catalog's own iterators).
+    std::stable_sort(foot.getPeaks().getInternal().begin(), foot.getPeaks().getInternal().end(),
+                     SortPeaks());
+}
 }  // namespace
 
 /*
@@ -588,132 +352,152 @@ static inline bool inFootprint(ImagePixelT pixVal, IterT, bool, double threshold
 }
 
 /*
- * Advance the x_iterator to the variance image, when relevant (it may be NULL otherwise)
+ * Return a pointer to the variance of pixel x in a row, when relevant (it may be NULL otherwise)
  */
-template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, Threshold_traits) {
+template <typename PtrT>
+static inline PtrT advancePtr(PtrT varPtr, int, Threshold_traits) {
     return varPtr;
 }
 
-template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, ThresholdPixelLevel_traits) {
-    return varPtr + 1;
+template <typename PtrT>
+static inline PtrT advancePtr(PtrT varPtr, int x, ThresholdPixelLevel_traits) {
+    return varPtr + x;
 }
 
 /*
- * Here's the working routine for the FootprintSet constructors; see documentation
- * of the constructors themselves
+ * Set above[x] to 1 for each pixel in a row that is above threshold, and 0 otherwise (including NaNs)
+ *
+ * The loop has no branches or loop-carried dependencies, so it can be vectorized
  */
-template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
-static void findFootprints(
-        typename FootprintSet::FootprintList *_footprints,  // Footprints
-        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
-        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
-        image::Image<VariancePixelT> const *var,            // img's variance
-        double const footprintThreshold,                    // threshold value for footprint
-        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
-        bool const polarity,                      // if false, search _below_ thresholdVal
-        int const npixMin,                        // minimum number of pixels in an object
-        bool const setPeaks                       // should I set the Peaks list?
-) {
+template <typename ImagePixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void flagPixelsAboveThreshold(unsigned char *above, ImagePixelT const *pixPtr,
+                                     VariancePixelT const *varPtr, int const width, bool const polarity,
+                                     double const footprintThreshold) {
+    for (int x = 0; x < width; ++x) {
+        ImagePixelT const pixVal = pixPtr[x];
+        above[x] = !isBadPixel(pixVal) & inFootprint(pixVal, advancePtr(varPtr, x, ThresholdTraitT()),
+                                                     polarity, footprintThreshold, ThresholdTraitT());
+    }
+}
+
+/*
+ * Return the index of the first non-zero element of above[x:width], or width if there is none
+ *
+ * Most pixels in an astronomical image are below threshold, so we skip a word at a time
+ */
+static inline int skipToNonZero(unsigned char const *above, int x, int const width) {
+    for (; x + static_cast<int>(sizeof(std::uint64_t)) <= width; x += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, above + x, sizeof(word));
+        if (word != 0) {
+            break;
+        }
+    }
+    while (x < width && above[x] == 0) {
+        ++x;
+    }
+    return x;
+}
+
+/*
+ * Find the spans of pixels above threshold in rows [yBegin, yEnd) of an image
+ *
+ * The spans are appended to spans in raster order with an id of 0, and the number of spans in row y is
+ * stored in rowStart[y + 1].  Each row is first scanned to flag the pixels above threshold; only the
+ * pixels in the resulting spans are then visited to see if they're above the inclusion threshold
+ */
+template <typename ImagePixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void findSpansInRows(std::vector<IdSpan> &spans, std::vector<int> &rowStart,
+                            ndarray::Array<ImagePixelT const, 2, 1> const &img,
+                            ndarray::Array<VariancePixelT const, 2, 1> const &var, int const yBegin,
+                            int const yEnd, double const footprintThreshold,
+                            double const includeThresholdMultiplier, bool const polarity) {
+    double const includeThreshold = footprintThreshold * includeThresholdMultiplier;  // for inclusion
+    int const width = img.template getSize<1>();
+
+    std::vector<unsigned char> above(width);  // is each pixel in the row above threshold?
+    for (int y = yBegin; y != yEnd; ++y) {
+        std::size_t const nOld = spans.size();
+
+        ImagePixelT const *pixPtr = img.getData() + y * img.template getStride<0>();
+        VariancePixelT const *varPtr = var.isEmpty() ? NULL : var.getData() + y * var.template getStride<0>();
+        flagPixelsAboveThreshold<ImagePixelT, VariancePixelT, ThresholdTraitT>(above.data(), pixPtr, varPtr,
+                                                                             width, polarity,
+                                                                             footprintThreshold);
+
+        for (int x = skipToNonZero(above.data(), 0, width); x < width;
+             x = skipToNonZero(above.data(), x, width)) {
+            int const x0 = x;  // start of the span
+            while (x < width && above[x]) {
+                ++x;
+            }
+            /*
+             * Does the span exceed the inclusion threshold?  If includeThresholdMultiplier == 1.0
+             * the thresholds are the same, so every pixel does
+             */
+            bool good = (includeThresholdMultiplier == 1.0);
+            for (int i = x0; !good && i < x; ++i) {
+                good = inFootprint(pixPtr[i], advancePtr(varPtr, i, ThresholdTraitT()), polarity,
+                                   includeThreshold, ThresholdTraitT());
+            }
+            spans.emplace_back(0, y, x0, x - 1, good);
+        }
+        rowStart[y + 1] = spans.size() - nOld;
+    }
+}
+
+/*
+ * Label the spans found in an image with the IDs of the objects that they belong to
+ *
+ * The spans must be in raster order, with those in row y being spans[rowStart[y]:rowStart[y + 1]]
+ */
+static void labelSpans(std::vector<IdSpan> &spans, std::vector<int> const &rowStart, int const height) {
     int id;       /* object ID */
-    int in_span;  /* object ID of current IdSpan */
     int nobj = 0; /* number of objects found */
-    int x0 = 0;   /* unpacked from a IdSpan */
-
-    double includeThreshold = footprintThreshold * includeThresholdMultiplier;  // Threshold for inclusion
 
-    int const row0 = img.getY0();
-    int const col0 = img.getX0();
-    int const height = img.getHeight();
-    int const width = img.getWidth();
     /*
-     * Storage for arrays that identify objects by ID. We want to be able to
-     * refer to idp[-1] and idp[width], hence the (width + 2)
+     * Identify objects, by giving each span the ID of an 8-connected span in the previous row,
+     * making entries in aliases[] for the IDs that need to be merged.  A span takes the ID of the
+     * previous row's span that touches its first pixel; this is the ID that was given to the span's
+     * first pixel when the image was searched pixel by pixel, so the IDs (and hence the order of
+     * the Footprints) are unchanged
      */
-    std::vector<int> id1(width + 2);
-    std::fill(id1.begin(), id1.end(), 0);
-    std::vector<int> id2(width + 2);
-    std::fill(id2.begin(), id2.end(), 0);
-    std::vector<int>::iterator idc = id1.begin() + 1;  // object IDs in current/
-    std::vector<int>::iterator idp = id2.begin() + 1;  //                       previous row
-
     std::vector<int> aliases;          // aliases for initially disjoint parts of Footprints
     aliases.reserve(1 + height / 20);  // initial size of aliases
+    aliases.push_back(0);              // 0 --> 0
 
-    std::vector<IdSpan> spans;          // y:x0,x1 for objects
-    spans.reserve(aliases.capacity());  // initial size of spans
-
-    aliases.push_back(0);  // 0 --> 0
-                           /*
-                            * Go through image identifying objects
-                            */
-    typedef typename image::Image<ImagePixelT>::x_iterator x_iterator;
-    typedef typename image::Image<VariancePixelT>::x_iterator x_var_iterator;
-
-    in_span = 0;  // not in a span
     for (int y = 0; y != height; ++y) {
-        if (idc == id1.begin() + 1) {
-            idc = id2.begin() + 1;
-            idp = id1.begin() + 1;
-        } else {
-            idc = id1.begin() + 1;
-            idp = id2.begin() + 1;
-        }
-        std::fill_n(idc - 1, width + 2, 0);
-
-        in_span = 0;                                     /* not in a span */
-        bool good = (includeThresholdMultiplier == 1.0); /* Span exceeds the threshold? */
+        int prev = (y == 0) ? rowStart[0] : rowStart[y - 1];  // first span in previous row to consider
+        int const prevEnd = rowStart[y];
+        for (int i = rowStart[y]; i != rowStart[y + 1]; ++i) {
+            IdSpan &span = spans[i];
 
-        x_iterator pixPtr = img.row_begin(y);
-        x_var_iterator varPtr = (var == NULL) ? NULL : var->row_begin(y);
-        for (int x = 0; x < width; ++x, ++pixPtr, varPtr = advancePtr(varPtr, ThresholdTraitT())) {
-            ImagePixelT const pixVal = *pixPtr;
-
-            if (isBadPixel(pixVal) ||
-                !inFootprint(pixVal, varPtr, polarity, footprintThreshold, ThresholdTraitT())) {
-                if (in_span) {
-                    spans.emplace_back(in_span, y, x0, x - 1, good);
-
-                    in_span = 0;
-                    good = false;
-                }
-            } else { /* a pixel to fix */
-                if (idc[x - 1] != 0) {
-                    id = idc[x - 1];
-                } else if (idp[x - 1] != 0) {
-                    id = idp[x - 1];
-                } else if (idp[x] != 0) {
-                    id = idp[x];
-                } else if (idp[x + 1] != 0) {
-                    id = idp[x + 1];
-                } else {
+            while (prev != prevEnd && spans[prev].x1 < span.x0 - 1) {
+                ++prev;
+            }
+            id = 0;
+            for (int j = prev; j != prevEnd && spans[j].x0 <= span.x1 + 1; ++j) {
+                int const resolved = resolve_alias(aliases, spans[j].id);
+                if (id == 0) {
+                    if (std::max(spans[j].x0, span.x0 - 1) <= span.x0 + 1) {
+                        id = resolved;
+                        continue;
+                    }
                     id = ++nobj;
                     aliases.push_back(id);
                 }
-
-                idc[x] = id;
-                if (!in_span) {
-                    x0 = x;
-                    in_span = id;
-                }
                 /*
                  * Do we need to merge ID numbers? If so, make suitable entries in aliases[]
                  */
-                if (idp[x + 1] != 0 && idp[x + 1] != id) {
-                    aliases[resolve_alias(aliases, idp[x + 1])] = resolve_alias(aliases, id);
-
-                    idc[x] = id = idp[x + 1];
-                }
-
-                if (!good && inFootprint(pixVal, varPtr, polarity, includeThreshold, ThresholdTraitT())) {
-                    good = true;
+                if (resolved != id) {
+                    aliases[resolved] = id;
                 }
             }
-        }
-
-        if (in_span) {
-            spans.emplace_back(in_span, y, x0, width - 1, good);
+            if (id == 0) {
+                id = ++nobj;
+                aliases.push_back(id);
+            }
+            span.id = id;
         }
     }
     /*
@@ -722,11 +506,23 @@ static void findFootprints(
     for (unsigned int i = 0; i < spans.size(); i++) {
         spans[i].id = resolve_alias(aliases, spans[i].id);
     }
+}
+
+/*
+ * Build Footprints from labelled spans, keeping those with a good span and at least npixMin pixels
+ *
+ * The Footprints are appended to footprints in order of increasing object ID
+ */
+static void makeFootprints(std::vector<IdSpan> &spans, int const row0, int const col0,
+                           lsst::geom::Box2I const &region, int const npixMin,
+                           FootprintSet::FootprintList *footprints) {
+    int id; /* object ID */
+
     /*
      * Sort spans by ID, so we can sweep through them once
      */
     if (spans.size() > 0) {
-        std::sort(spans.begin(), spans.end(), IdSpanCompare());
+        std::stable_sort(spans.begin(), spans.end(), IdSpanCompare());
     }
     /*
      * Build Footprints from spans
@@ -745,10 +541,10 @@ static void findFootprints(
                             geom::Span(spans[i0].y + row0, spans[i0].x0 + col0, spans[i0].x1 + col0));
                 }
                 auto tempSpanSet = std::make_shared<geom::SpanSet>(std::move(tempSpanList));
-                auto fp = std::make_shared<Footprint>(tempSpanSet, _region);
+                auto fp = std::make_shared<Footprint>(tempSpanSet, region);
 
                 if (good && fp->getArea() >= static_cast<std::size_t>(npixMin)) {
-                    _footprints->push_back(fp);
+                    footprints->push_back(fp);
                 }
             }
 
@@ -757,44 +553,327 @@ static void findFootprints(
             }
         }
     }
+}
+
+/*
+ * Concatenate the spans found in bands of rows, emptying the bands
+ */
+static std::vector<IdSpan> concatenateBands(std::vector<std::vector<IdSpan>> &bandSpans) {
+    std::vector<IdSpan> spans;
+    if (bandSpans.size() == 1) {
+        spans.swap(bandSpans[0]);
+    } else {
+        std::size_t nSpans = 0;
+        for (auto const &s : bandSpans) {
+            nSpans += s.size();
+        }
+        spans.reserve(nSpans);
+        for (auto &s : bandSpans) {
+            spans.insert(spans.end(), s.begin(), s.end());
+            std::vector<IdSpan>().swap(s);
+        }
+    }
+    return spans;
+}
+
+/*
+ * Here's the working routine for the FootprintSet constructors; see documentation
+ * of the constructors themselves
+ *
+ * The image is searched for spans above threshold in bands of rows, possibly in parallel.  The spans are
+ * then labelled in a single pass in raster order, which assigns the same object IDs as a pixel-by-pixel
+ * search, so the Footprints (and their peaks) are identical whatever the number of threads; finally the
+ * peaks in the Footprints are found, again possibly in parallel.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void findFootprints(
+        typename FootprintSet::FootprintList *_footprints,  // Footprints
+        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
+        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
+        image::Image<VariancePixelT> const *var,            // img's variance
+        double const footprintThreshold,                    // threshold value for footprint
+        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
+        bool const polarity,                      // if false, search _below_ thresholdVal
+        int const npixMin,                        // minimum number of pixels in an object
+        bool const setPeaks,                      // should I set the Peaks list?
+        int const nThreads                        // maximum number of threads; 0 for one per hardware thread
+) {
+    int const row0 = img.getY0();
+    int const col0 = img.getX0();
+    int const height = img.getHeight();
+
+    int const nThread = math::detail::resolveNThreads(nThreads);
     /*
-     * Find all peaks within those Footprints
+     * Go through image finding spans above threshold.  Use several bands per thread, as the
+     * density of objects (and hence the work per row) varies across an image
+     */
+    std::vector<int> const bands =
+            math::detail::computeBandBoundaries(0, height, (nThread == 1) ? 1 : 8 * nThread);
+    int const nBands = bands.empty() ? 0 : bands.size() - 1;
+
+    std::vector<std::vector<IdSpan>> bandSpans(nBands);
+    std::vector<int> rowStart(height + 1, 0);  // spans in row y are spans[rowStart[y]:rowStart[y + 1]]
+    // Get the arrays here, as ndarray's reference counting isn't thread safe
+    ndarray::Array<ImagePixelT const, 2, 1> const imgArray = img.getArray();
+    ndarray::Array<VariancePixelT const, 2, 1> const varArray =
+            (var == NULL) ? ndarray::Array<VariancePixelT const, 2, 1>() : var->getArray();
+    math::detail::parallelFor(nBands, nThread, [&](int band) {
+        findSpansInRows<ImagePixelT, VariancePixelT, ThresholdTraitT>(
+                bandSpans[band], rowStart, imgArray, varArray, bands[band], bands[band + 1],
+                footprintThreshold, includeThresholdMultiplier, polarity);
+    });
+
+    std::vector<IdSpan> spans = concatenateBands(bandSpans);  // y:x0,x1 for objects
+    std::partial_sum(rowStart.begin(), rowStart.end(), rowStart.begin());
+    labelSpans(spans, rowStart, height);
+    makeFootprints(spans, row0, col0, _region, npixMin, _footprints);
+    /*
+     * Find all peaks within those Footprints.  The PeakRecords are created serially, in order, as
+     * they share a PeakTable which assigns their IDs
      */
     if (setPeaks) {
-        typedef FootprintSet::FootprintList::iterator fiterator;
-        for (fiterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
-            findPeaks(*ptr, img, polarity, ThresholdTraitT());
+        int const nFootprints = _footprints->size();
+        std::vector<PeakCandidateList> peaks(nFootprints);
+        math::detail::parallelFor(nFootprints, nThread, [&](int i) {
+            findPeaks(*(*_footprints)[i], img, polarity, peaks[i], ThresholdTraitT());
+        });
+        for (int i = 0; i != nFootprints; ++i) {
+            addPeaks(*(*_footprints)[i], img, polarity, peaks[i]);
+        }
+    }
+}
+
+/*
+ * Worker routine for merging two FootprintSets, possibly growing them as we proceed
+ *
+ * The Footprints are grown (possibly in parallel) and clipped to the region, and their spans are merged
+ * row by row and labelled just as findFootprints labels the spans above threshold, so the new Footprints
+ * are those that would be detected in an image of the grown Footprints, without having to make one.  Each
+ * new Footprint then gets the peaks of all the old Footprints whose grown spans lie within it; as every
+ * grown span lies within a single merged span, these are found by looking up each grown span in its row.
+ */
+static FootprintSet mergeFootprintSets(
+        FootprintSet const &lhs,      // the FootprintSet to be merged to
+        int rLhs,                     // Grow lhs Footprints by this many pixels
+        FootprintSet const &rhs,      // the FootprintSet to be merged into lhs
+        int rRhs,                     // Grow rhs Footprints by this many pixels
+        FootprintControl const &ctrl,  // Control how the grow is done
+        int const nThreads            // maximum number of threads; 0 for one per hardware thread
+) {
+    typedef FootprintSet::FootprintList FootprintList;
+    // The isXXX routines return <isset, value>
+    bool const circular = ctrl.isCircular().first && ctrl.isCircular().second;
+    bool const isotropic = ctrl.isIsotropic().second;  // isotropic grow as opposed to a Manhattan metric
+                                                       // n.b. Isotropic grows are significantly slower
+    bool const left = ctrl.isLeft().first && ctrl.isLeft().second;
+    bool const right = ctrl.isRight().first && ctrl.isRight().second;
+    bool const up = ctrl.isUp().first && ctrl.isUp().second;
+    bool const down = ctrl.isDown().first && ctrl.isDown().second;
+
+    lsst::geom::Box2I const region = lhs.getRegion();
+    if (region != rhs.getRegion()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          boost::format("The two FootprintSets must have the same region").str());
+    }
+    int const nThread = math::detail::resolveNThreads(nThreads);
+
+    // Return the structuring element used to grow Footprints by amount pixels
+    auto makeStructure = [&circular, &up, &down, &left, &right,
+                          &isotropic](int amount) -> std::shared_ptr<geom::SpanSet> {
+        if (amount <= 0) {
+            return nullptr;
+        } else if (circular) {
+            return geom::SpanSet::fromShape(amount,
+                                            isotropic ? geom::Stencil::CIRCLE : geom::Stencil::MANHATTAN);
+        } else {
+            int top = up ? amount : 0;
+            int bottom = down ? amount : 0;
+            int lLimit = left ? amount : 0;
+            int rLimit = right ? amount : 0;
+
+            auto yRange = top + bottom + 1;
+            std::vector<geom::Span> spanList;
+            spanList.reserve(yRange);
+
+            for (auto dy = 1; dy <= top; ++dy) {
+                spanList.push_back(geom::Span(dy, 0, 0));
+            }
+            for (auto dy = -1; dy >= -bottom; --dy) {
+                spanList.push_back(geom::Span(dy, 0, 0));
+            }
+            spanList.push_back(geom::Span(0, -lLimit, rLimit));
+            return std::make_shared<geom::SpanSet>(std::move(spanList));
+        }
+    };
+    std::shared_ptr<geom::SpanSet> const lhsStructure = makeStructure(rLhs);
+    std::shared_ptr<geom::SpanSet> const rhsStructure = makeStructure(rRhs);
+
+    FootprintList const &lhsFootprints = *lhs.getFootprints();
+    FootprintList const &rhsFootprints = *rhs.getFootprints();
+    int const nLhs = lhsFootprints.size();
+    int const nOld = nLhs + rhsFootprints.size();  // old Footprints are indexed lhs first, then rhs
+    auto getOldFootprint = [&](int i) -> Footprint const & {
+        return (i < nLhs) ? *lhsFootprints[i] : *rhsFootprints[i - nLhs];
+    };
+    /*
+     * Grow the old Footprints, clipping them to the region.  Only SpanSets are created here; the new
+     * Footprints are made serially below
+     */
+    std::vector<std::shared_ptr<geom::SpanSet>> grown(nOld);
+    math::detail::parallelFor(nOld, nThread, [&](int i) {
+        Footprint const &foot = getOldFootprint(i);
+        geom::SpanSet const *structure = (i < nLhs) ? lhsStructure.get() : rhsStructure.get();
+        std::shared_ptr<geom::SpanSet> spans = foot.getSpans();
+        if (structure && foot.getArea() > 0) {
+            spans = spans->dilated(*structure);
+        }
+        grown[i] = spans->clippedTo(region);
+    });
+    /*
+     * Sort the grown spans into rows, then merge those in each row that overlap or touch to find the
+     * pixels in any grown Footprint, with coordinates relative to the region
+     */
+    int const row0 = region.getMinY();
+    int const col0 = region.getMinX();
+    int const height = region.getHeight();
+
+    std::vector<int> pieceStart(height + 1, 0);  // grown spans in row y are pieces[pieceStart[y]:...[y + 1]]
+    for (auto const &spans : grown) {
+        for (auto const &spn : *spans) {
+            ++pieceStart[spn.getY() - row0 + 1];
+        }
+    }
+    std::partial_sum(pieceStart.begin(), pieceStart.end(), pieceStart.begin());
+    std::vector<std::pair<int, int>> pieces(pieceStart[height]);  // (x0, x1) of each grown span
+    {
+        std::vector<int> next(pieceStart.begin(), pieceStart.end() - 1);
+        for (auto const &spans : grown) {
+            for (auto const &spn : *spans) {
+                pieces[next[spn.getY() - row0]++] =
+                        std::make_pair(spn.getMinX() - col0, spn.getMaxX() - col0);
+            }
+        }
+    }
+
+    std::vector<int> const bands =
+            math::detail::computeBandBoundaries(0, height, (nThread == 1) ? 1 : 8 * nThread);
+    int const nBands = bands.empty() ? 0 : bands.size() - 1;
+
+    std::vector<std::vector<IdSpan>> bandSpans(nBands);
+    std::vector<int> rowStart(height + 1, 0);  // spans in row y are spans[rowStart[y]:rowStart[y + 1]]
+    math::detail::parallelFor(nBands, nThread, [&](int band) {
+        std::vector<IdSpan> &merged = bandSpans[band];
+        for (int y = bands[band]; y != bands[band + 1]; ++y) {
+            std::size_t const nBefore = merged.size();
+            auto const begin = pieces.begin() + pieceStart[y];
+            auto const end = pieces.begin() + pieceStart[y + 1];
+            std::sort(begin, end);
+            for (auto piece = begin; piece != end; ++piece) {
+                if (merged.size() > nBefore && piece->first <= merged.back().x1 + 1) {
+                    merged.back().x1 = std::max(merged.back().x1, piece->second);
+                } else {
+                    merged.emplace_back(0, y, piece->first, piece->second, true);
+                }
+            }
+            rowStart[y + 1] = merged.size() - nBefore;
+        }
+    });
+
+    std::vector<IdSpan> spans = concatenateBands(bandSpans);
+    std::partial_sum(rowStart.begin(), rowStart.end(), rowStart.begin());
+    labelSpans(spans, rowStart, height);
+    /*
+     * Find the IDs of the objects that each grown Footprint lies in (usually just one)
+     */
+    std::vector<std::vector<int>> oldIds(nOld);
+    math::detail::parallelFor(nOld, nThread, [&](int i) {
+        std::vector<int> &ids = oldIds[i];
+        for (auto const &spn : *grown[i]) {
+            int const y = spn.getY() - row0;
+            // The merged span containing spn is the last in its row to start at or before it
+            auto const merged = std::upper_bound(spans.begin() + rowStart[y], spans.begin() + rowStart[y + 1],
+                                                 spn.getMinX() - col0,
+                                                 [](int x, IdSpan const &span) { return x < span.x0; }) -
+                                1;
+            if (ids.empty() || ids.back() != merged->id) {
+                ids.push_back(merged->id);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    });
+    /*
+     * Every object becomes a Footprint, in order of increasing ID
+     */
+    std::vector<int> newIds;
+    newIds.reserve(spans.size());
+    for (auto const &span : spans) {
+        newIds.push_back(span.id);
+    }
+    std::sort(newIds.begin(), newIds.end());
+    newIds.erase(std::unique(newIds.begin(), newIds.end()), newIds.end());
+
+    FootprintSet fs(region);
+    makeFootprints(spans, row0, col0, region, 1, fs.getFootprints().get());
+    FootprintList &footprints = *fs.getFootprints();
+    assert(footprints.size() == newIds.size());
+    /*
+     * We now know which old Footprints contributed to each new one, so merge all their Peaks into it;
+     * the old Footprints are visited in order, lhs before rhs
+     */
+    std::vector<std::vector<int>> progenitors(footprints.size());  // indices of contributing old Footprints
+    for (int i = 0; i != nOld; ++i) {
+        for (int id : oldIds[i]) {
+            progenitors[std::lower_bound(newIds.begin(), newIds.end(), id) - newIds.begin()].push_back(i);
         }
     }
+    for (std::size_t k = 0; k != footprints.size(); ++k) {
+        PeakCatalog &peaks = footprints[k]->getPeaks();
+
+        for (int i : progenitors[k]) {
+            PeakCatalog const &oldPeaks = getOldFootprint(i).getPeaks();
+
+            int const nold = peaks.size();
+            peaks.insert(peaks.end(), oldPeaks.begin(), oldPeaks.end());
+            // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
+            // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
+            // it'd try to do if we passed Catalog's own iterators).
+            std::inplace_merge(peaks.getInternal().begin(), peaks.getInternal().begin() + nold,
+                               peaks.getInternal().end(), SortPeaks());
+        }
+    }
+
+    return fs;
 }
 
 template <typename ImagePixelT>
 FootprintSet::FootprintSet(image::Image<ImagePixelT> const &img, Threshold const &threshold,
-                           int const npixMin, bool const setPeaks)
+                           int const npixMin, bool const setPeaks, int const nThreads)
         : daf::base::Citizen(typeid(this)), _footprints(new FootprintList()), _region(img.getBBox()) {
     typedef float VariancePixelT;
 
     findFootprints<ImagePixelT, image::MaskPixel, VariancePixelT, ThresholdLevel_traits>(
             _footprints.get(), _region, img, NULL, threshold.getValue(img), threshold.getIncludeMultiplier(),
-            threshold.getPolarity(), npixMin, setPeaks);
+            threshold.getPolarity(), npixMin, setPeaks, nThreads);
 }
 
 // NOTE: not a template to appease swig (see note by instantiations at bottom)
 
 template <typename MaskPixelT>
-FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin)
+FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin,
+                           int const nThreads)
         : daf::base::Citizen(typeid(this)), _footprints(new FootprintList()), _region(msk.getBBox()) {
     switch (threshold.getType()) {
         case Threshold::BITMASK:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdBitmask_traits>(
                     _footprints.get(), _region, msk, NULL, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, nThreads);
             break;
 
         case Threshold::VALUE:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdLevel_traits>(
                     _footprints.get(), _region, msk, NULL, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, nThreads);
             break;
 
         default:
@@ -806,7 +885,7 @@ FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &
 template <typename ImagePixelT, typename MaskPixelT>
 FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &maskedImg,
                            Threshold const &threshold, std::string const &planeName, int const npixMin,
-                           bool const setPeaks)
+                           bool const setPeaks, int const nThreads)
         : daf::base::Citizen(typeid(this)),
           _footprints(new FootprintList()),
           _region(lsst::geom::Point2I(maskedImg.getX0(), maskedImg.getY0()),
@@ -818,13 +897,13 @@ FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &ma
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdPixelLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, nThreads);
             break;
         default:
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, nThreads);
             break;
     }
     // Set Mask if requested
@@ -873,9 +952,9 @@ FootprintSet &FootprintSet::operator=(FootprintSet &&rhs) { return *this = rhs;
 
 FootprintSet::~FootprintSet() = default;
 
-void FootprintSet::merge(FootprintSet const &rhs, int tGrow, int rGrow, bool isotropic) {
+void FootprintSet::merge(FootprintSet const &rhs, int tGrow, int rGrow, bool isotropic, int nThreads) {
     FootprintControl const ctrl(true, isotropic);
-    FootprintSet fs = mergeFootprintSets(*this, tGrow, rhs, rGrow, ctrl);
+    FootprintSet fs = mergeFootprintSets(*this, tGrow, rhs, rGrow, ctrl, nThreads);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
@@ -888,7 +967,7 @@ void FootprintSet::setRegion(lsst::geom::Box2I const &region) {
     }
 }
 
-FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic)
+FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic, int nThreads)
         : daf::base::Citizen(typeid(this)), _footprints(new FootprintList), _region(rhs._region) {
     if (r == 0) {
         FootprintSet fs = rhs;
@@ -900,11 +979,11 @@ FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic)
     }
 
     FootprintControl const ctrl(true, isotropic);
-    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, r, ctrl);
+    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, r, ctrl, nThreads);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
-FootprintSet::FootprintSet(FootprintSet const &rhs, int ngrow, FootprintControl const &ctrl)
+FootprintSet::FootprintSet(FootprintSet const &rhs, int ngrow, FootprintControl const &ctrl, int nThreads)
         : daf::base::Citizen(typeid(this)), _footprints(new FootprintList), _region(rhs._region) {
     if (ngrow == 0) {
         FootprintSet fs = rhs;
@@ -915,7 +994,7 @@ FootprintSet::FootprintSet(FootprintSet const &rhs, int ngrow, FootprintControl
                           str(boost::format("I cannot grow by negative numbers: %d") % ngrow));
     }
 
-    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, ngrow, ctrl);
+    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, ngrow, ctrl, nThreads);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
@@ -946,15 +1025,9 @@ std::shared_ptr<image::Image<FootprintIdPixel>> FootprintSet::insertIntoImage(bo
 template <typename ImagePixelT, typename MaskPixelT>
 void FootprintSet::makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const &mimg,
                              HeavyFootprintCtrl const *ctrl) {
-    HeavyFootprintCtrl ctrl_s = HeavyFootprintCtrl();
-
-    if (!ctrl) {
-        ctrl = &ctrl_s;
-    }
-
-    for (FootprintList::iterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
-        ptr->reset(new HeavyFootprint<ImagePixelT, MaskPixelT>(**ptr, mimg, ctrl));
-    }
+    // The HeavyFootprints share a single buffer for each pixel plane
+    auto heavies = makeHeavyFootprints(*_footprints, mimg, ctrl);
+    std::copy(heavies.begin(), heavies.end(), _footprints->begin());
 }
 
 void FootprintSet::makeSources(afw::table::SourceCatalog &cat) const {
@@ -972,13 +1045,15 @@ void FootprintSet::makeSources(afw::table::SourceCatalog &cat) const {
 
 #define INSTANTIATE(PIXEL)                                                                              \
     template FootprintSet::FootprintSet(image::Image<PIXEL> const &, Threshold const &, int const,      \
-                                        bool const);                                                    \
+                                        bool const, int const);                                         \
     template FootprintSet::FootprintSet(image::MaskedImage<PIXEL, image::MaskPixel> const &,            \
-                                        Threshold const &, std::string const &, int const, bool const); \
+                                        Threshold const &, std::string const &, int const, bool const,  \
+                                        int const);                                                     \
     template void FootprintSet::makeHeavy(image::MaskedImage<PIXEL, image::MaskPixel> const &,          \
                                           HeavyFootprintCtrl const *)
 
-template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const);
+template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const,
+                                    int const);
 
 template void FootprintSet::setMask(image::Mask<image::MaskPixel> *, std::string const &);
 template void FootprintSet::setMask(std::shared_ptr<image::Mask<image::MaskPixel>>, std::string const &);
@@ -159,6 +159,20 @@ geom::ellipses::Quadrupole GaussianPsf::doComputeShape(lsst::geom::Point2D const
     return geom::ellipses::Quadrupole(_sigma * _sigma, _sigma * _sigma, 0.0);
 }
 
+ndarray::Array<double, 1, 1> GaussianPsf::doComputeApertureFluxes(
+        double radius, std::vector<lsst::geom::Point2D> const& positions,
+        std::vector<image::Color> const& colors) const {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(positions.size());
+    result.deep() = doComputeApertureFlux(radius, lsst::geom::Point2D(), image::Color());
+    return result;
+}
+
+std::vector<geom::ellipses::Quadrupole> GaussianPsf::doComputeShapes(
+        std::vector<lsst::geom::Point2D> const& positions, std::vector<image::Color> const& colors) const {
+    return std::vector<geom::ellipses::Quadrupole>(positions.size(),
+                                                   doComputeShape(lsst::geom::Point2D(), image::Color()));
+}
+
 lsst::geom::Box2I GaussianPsf::doComputeBBox(lsst::geom::Point2D const& position,
                                              image::Color const& color) const {
     return lsst::geom::Box2I(lsst::geom::Point2I(-_dimensions / 2),
@@ -25,6 +25,7 @@
 #include <string>
 #include <typeinfo>
 #include <algorithm>
+#include <vector>
 #include "boost/format.hpp"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/detection/Peak.h"
@@ -71,6 +72,39 @@ private:
 };
 }  // namespace
 
+namespace {
+/*
+ * Copy the pixels of mimage within spans into image, mask and variance, modifying mimage as specified by ctrl
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void flattenPixels(geom::SpanSet const& spans,
+                   image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage,
+                   HeavyFootprintCtrl const& ctrl, ndarray::Array<ImagePixelT, 1, 1> const& image,
+                   ndarray::Array<MaskPixelT, 1, 1> const& mask,
+                   ndarray::Array<VariancePixelT, 1, 1> const& variance) {
+    switch (ctrl.getModifySource()) {
+        case HeavyFootprintCtrl::NONE:
+            spans.flatten(image, mimage.getImage()->getArray(), mimage.getXY0());
+            spans.flatten(mask, mimage.getMask()->getArray(), mimage.getXY0());
+            spans.flatten(variance, mimage.getVariance()->getArray(), mimage.getXY0());
+            break;
+        case HeavyFootprintCtrl::SET: {
+            ImagePixelT const ival = ctrl.getImageVal();
+            MaskPixelT const mval = ctrl.getMaskVal();
+            VariancePixelT const vval = ctrl.getVarianceVal();
+
+            spans.applyFunctor(FlattenWithSetter<ImagePixelT>(ival), ndarray::ndFlat(image),
+                               ndarray::ndImage(mimage.getImage()->getArray(), mimage.getXY0()));
+            spans.applyFunctor(FlattenWithSetter<MaskPixelT>(mval), ndarray::ndFlat(mask),
+                               ndarray::ndImage(mimage.getMask()->getArray(), mimage.getXY0()));
+            spans.applyFunctor(FlattenWithSetter<VariancePixelT>(vval), ndarray::ndFlat(variance),
+                               ndarray::ndImage(mimage.getVariance()->getArray(), mimage.getXY0()));
+            break;
+        }
+    }
+}
+}  // namespace
+
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(
         Footprint const& foot, image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage,
@@ -85,26 +119,7 @@ HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(
         ctrl = &ctrl_s;
     }
 
-    switch (ctrl->getModifySource()) {
-        case HeavyFootprintCtrl::NONE:
-            getSpans()->flatten(_image, mimage.getImage()->getArray(), mimage.getXY0());
-            getSpans()->flatten(_mask, mimage.getMask()->getArray(), mimage.getXY0());
-            getSpans()->flatten(_variance, mimage.getVariance()->getArray(), mimage.getXY0());
-            break;
-        case HeavyFootprintCtrl::SET: {
-            ImagePixelT const ival = ctrl->getImageVal();
-            MaskPixelT const mval = ctrl->getMaskVal();
-            VariancePixelT const vval = ctrl->getVarianceVal();
-
-            getSpans()->applyFunctor(FlattenWithSetter<ImagePixelT>(ival), ndarray::ndFlat(_image),
-                                     ndarray::ndImage(mimage.getImage()->getArray(), mimage.getXY0()));
-            getSpans()->applyFunctor(FlattenWithSetter<MaskPixelT>(mval), ndarray::ndFlat(_mask),
-                                     ndarray::ndImage(mimage.getMask()->getArray(), mimage.getXY0()));
-            getSpans()->applyFunctor(FlattenWithSetter<VariancePixelT>(vval), ndarray::ndFlat(_variance),
-                                     ndarray::ndImage(mimage.getVariance()->getArray(), mimage.getXY0()));
-            break;
-        }
-    }
+    flattenPixels(*getSpans(), mimage, *ctrl, _image, _mask, _variance);
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
@@ -115,6 +130,58 @@ HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(Footprin
           _mask(ndarray::allocate(ndarray::makeVector(foot.getArea()))),
           _variance(ndarray::allocate(ndarray::makeVector(foot.getArea()))) {}
 
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(
+        Footprint const& foot, ndarray::Array<ImagePixelT, 1, 1> const& image,
+        ndarray::Array<MaskPixelT, 1, 1> const& mask, ndarray::Array<VariancePixelT, 1, 1> const& variance)
+        : Footprint(foot), _image(image), _mask(mask), _variance(variance) {
+    std::size_t const area = foot.getArea();
+    std::size_t const nImage = image.template getSize<0>();
+    std::size_t const nMask = mask.template getSize<0>();
+    std::size_t const nVariance = variance.template getSize<0>();
+    if (nImage != area || nMask != area || nVariance != area) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Pixel arrays have sizes %d, %d, %d; Footprint has area %d") % nImage %
+                           nMask % nVariance % area)
+                                  .str());
+    }
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>> makeHeavyFootprints(
+        std::vector<std::shared_ptr<Footprint>> const& footprints,
+        image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage,
+        HeavyFootprintCtrl const* ctrl) {
+    HeavyFootprintCtrl ctrl_s = HeavyFootprintCtrl();
+
+    if (!ctrl) {
+        ctrl = &ctrl_s;
+    }
+
+    std::size_t nPix = 0;
+    for (auto const& foot : footprints) {
+        nPix += foot->getArea();
+    }
+    ndarray::Array<ImagePixelT, 1, 1> image = ndarray::allocate(nPix);
+    ndarray::Array<MaskPixelT, 1, 1> mask = ndarray::allocate(nPix);
+    ndarray::Array<VariancePixelT, 1, 1> variance = ndarray::allocate(nPix);
+
+    std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>> result;
+    result.reserve(footprints.size());
+    std::size_t begin = 0;
+    for (auto const& foot : footprints) {
+        std::size_t const end = begin + foot->getArea();
+        auto heavy = std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>(
+                *foot, image[ndarray::view(begin, end)], mask[ndarray::view(begin, end)],
+                variance[ndarray::view(begin, end)]);
+        flattenPixels(*heavy->getSpans(), mimage, *ctrl, heavy->getImageArray(), heavy->getMaskArray(),
+                      heavy->getVarianceArray());
+        result.push_back(heavy);
+        begin = end;
+    }
+    return result;
+}
+
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::insert(
         image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& mimage) const {
@@ -304,20 +371,20 @@ public:
         readPeaks(catalogs[1], *loadedFootprint);
         afw::table::BaseRecord const& record = catalogs[2].front();
 
-        // Create the HeavyFootprint from the above Footprint
-        auto result =
-                std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>(*loadedFootprint);
-        result->_image = ndarray::const_array_cast<ImagePixelT>(record.get(keys.image));
-
+        // Create the HeavyFootprint from the above Footprint, sharing the arrays read from the catalog
+        // (which are views into a single buffer for all the rows in the archive's catalog).
+        ndarray::Array<MaskPixelT, 1, 1> mask;
         // Handle legacy Masks prior to change to int32
         if (catalogs[2].getSchema() == legacyKeys.schema) {
             auto legacyMask = ndarray::const_array_cast<std::uint16_t>(record.get(legacyKeys.mask));
-            result->_mask.deep() = legacyMask;
+            mask = ndarray::allocate(legacyMask.template getSize<0>());
+            mask.deep() = legacyMask;
         } else {
-            result->_mask = ndarray::const_array_cast<MaskPixelT>(record.get(keys.mask));
+            mask = ndarray::const_array_cast<MaskPixelT>(record.get(keys.mask));
         }
-        result->_variance = ndarray::const_array_cast<VariancePixelT>(record.get(keys.variance));
-        return result;
+        return std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>(
+                *loadedFootprint, ndarray::const_array_cast<ImagePixelT>(record.get(keys.image)), mask,
+                ndarray::const_array_cast<VariancePixelT>(record.get(keys.variance)));
     }
 
     static Factory registration;
@@ -339,6 +406,10 @@ typename HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::Factory
     table::io::PersistableFacade<detection::HeavyFootprint<TYPE>>::dynamicCast(                      \
             std::shared_ptr<table::io::Persistable> const&);                                         \
     template class detection::HeavyFootprint<TYPE>;                                                  \
+    template std::vector<std::shared_ptr<detection::HeavyFootprint<TYPE>>>                           \
+    detection::makeHeavyFootprints<TYPE>(std::vector<std::shared_ptr<detection::Footprint>> const&,  \
+                                         image::MaskedImage<TYPE> const&,                            \
+                                         detection::HeavyFootprintCtrl const*);                      \
     template std::shared_ptr<detection::HeavyFootprint<TYPE>> detection::mergeHeavyFootprints<TYPE>( \
             detection::HeavyFootprint<TYPE> const&, detection::HeavyFootprint<TYPE> const&);
 
@@ -1,10 +1,19 @@
 // -*- LSST-C++ -*-
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <list>
+#include <mutex>
 #include <typeinfo>
 #include <cmath>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-#include "lsst/utils/Cache.h"
+#include "boost/format.hpp"
+#include "lsst/pex/exceptions.h"
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/math/offsetImage.h"
 #include "lsst/afw/table/io/Persistable.cc"
@@ -18,7 +27,7 @@ template std::shared_ptr<detection::Psf> table::io::PersistableFacade<detection:
 namespace detection {
 namespace detail {
 
-// Key for caching PSFs with lsst::utils::Cache
+// Key for caching PSFs with PsfCache
 //
 // We cache PSFs by their x,y position. Although there are placeholders
 // in the `Psf` class and here for `image::Color`, these are not used
@@ -62,16 +71,240 @@ struct hash<lsst::afw::detection::detail::PsfCacheKey> {
 namespace lsst {
 namespace afw {
 namespace detection {
+namespace detail {
+
+/*
+ * A thread-safe least-recently-used cache of PSF images
+ *
+ * The entries are divided among up to MAX_SHARDS shards by the hash of their keys.  Each shard has its own
+ * lock, least-recently-used list and an equal share of the capacity (so the least-recently-used entry of
+ * a shard, not of the whole cache, is evicted), and concurrent calls only contend when they fall in the
+ * same shard.  Every use of an entry also records a stamp from a cache-wide counter, so that changing the
+ * capacity can keep the entries most recently used in the whole cache.  The lock is not held while a
+ * missing image is computed; if two threads compute the same image at once, both return the one that was
+ * inserted first.
+ */
+class PsfCache {
+public:
+    using Value = std::shared_ptr<Psf::Image>;
+
+    explicit PsfCache(std::size_t capacity)
+            : _capacity(0), _hits(0), _misses(0), _evictions(0), _lastStamp(0) {
+        reserve(capacity);
+    }
+
+    PsfCache(PsfCache const &) = delete;
+    PsfCache(PsfCache &&) = delete;
+    PsfCache &operator=(PsfCache const &) = delete;
+    PsfCache &operator=(PsfCache &&) = delete;
+    ~PsfCache() = default;
+
+    // Return the cached value for key, calling func(key) to compute it if it is not present
+    template <typename Function>
+    Value operator()(PsfCacheKey const &key, Function func) {
+        Value value = find(key);
+        if (value) {
+            return value;
+        }
+        return insert(key, func(key));
+    }
+
+    // Return the cached value for key (counting a hit), or null if it is not present (counting a miss)
+    Value find(PsfCacheKey const &key) {
+        if (!_shards.empty()) {
+            Shard &shard = *_shards[_getShardIndex(key)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Value const *found = shard.find(key, ++_lastStamp);
+            if (found) {
+                ++_hits;
+                return *found;
+            }
+        }
+        ++_misses;
+        return Value();
+    }
+
+    // Cache a value computed after find() returned null, and return the value that is now cached,
+    // which will be a different one if another thread has cached a value for key in the meantime
+    Value insert(PsfCacheKey const &key, Value const &value) {
+        if (_shards.empty()) {
+            return value;
+        }
+        Shard &shard = *_shards[_getShardIndex(key)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Stamp const stamp = ++_lastStamp;
+        Value const *found = shard.find(key, stamp);
+        if (found) {
+            return *found;
+        }
+        _evictions += shard.insert(key, value, stamp);
+        return value;
+    }
+
+    std::size_t capacity() const { return _capacity; }
+
+    // Change the capacity, keeping the most recently used entries; not thread-safe
+    void reserve(std::size_t capacity) {
+        std::vector<std::unique_ptr<Shard>> oldShards;
+        oldShards.swap(_shards);
+        _capacity = capacity;
+        std::size_t nShards = std::min(MAX_SHARDS, capacity / MIN_SHARD_CAPACITY);
+        if (capacity > 0 && nShards == 0) {
+            nShards = 1;
+        }
+        std::size_t const shardCapacity = nShards > 0 ? (capacity + nShards - 1) / nShards : 0;
+        for (std::size_t i = 0; i < nShards; ++i) {
+            _shards.push_back(std::make_unique<Shard>(shardCapacity));
+        }
+        if (_shards.empty()) {
+            return;
+        }
+        // Merge the entries of all the old shards and insert the least recently used first, so the
+        // order is preserved across the whole cache, not just within each shard
+        std::vector<Entry const *> oldEntries;
+        for (auto const &oldShard : oldShards) {
+            for (auto const &entry : oldShard->entries) {
+                oldEntries.push_back(&entry);
+            }
+        }
+        std::sort(oldEntries.begin(), oldEntries.end(),
+                  [](Entry const *a, Entry const *b) { return a->stamp < b->stamp; });
+        for (Entry const *entry : oldEntries) {
+            _evictions += _shards[_getShardIndex(entry->key)]->insert(entry->key, entry->value, entry->stamp);
+        }
+    }
+
+    Psf::CacheStatistics getStatistics() const { return {_hits, _misses, _evictions}; }
+
+    void resetStatistics() {
+        _hits = 0;
+        _misses = 0;
+        _evictions = 0;
+    }
+
+private:
+    static constexpr std::size_t MAX_SHARDS = 16;
+    static constexpr std::size_t MIN_SHARD_CAPACITY = 8;  // so small caches are exactly least-recently-used
+
+    using Stamp = std::uint64_t;
+
+    struct Entry {
+        PsfCacheKey key;
+        Value value;
+        Stamp stamp;  // value of _lastStamp when the entry was last used
+    };
+
+    struct Shard {
+        using Entries = std::list<Entry>;
+
+        explicit Shard(std::size_t capacity_) : capacity(capacity_) {}
+
+        // Return the value for key (marking it as most recently used at stamp), or null if absent
+        Value const *find(PsfCacheKey const &key, Stamp stamp) {
+            auto iter = index.find(key);
+            if (iter == index.end()) {
+                return nullptr;
+            }
+            entries.splice(entries.begin(), entries, iter->second);
+            iter->second->stamp = stamp;
+            return &iter->second->value;
+        }
+
+        // Insert a value for a key that is not present, returning the number of entries evicted
+        std::size_t insert(PsfCacheKey const &key, Value const &value, Stamp stamp) {
+            entries.push_front(Entry{key, value, stamp});
+            index.emplace(key, entries.begin());
+            std::size_t nEvicted = 0;
+            for (; entries.size() > capacity; ++nEvicted) {
+                index.erase(entries.back().key);
+                entries.pop_back();
+            }
+            return nEvicted;
+        }
+
+        std::mutex mutex;
+        std::size_t const capacity;
+        Entries entries;  // most recently used first
+        std::unordered_map<PsfCacheKey, Entries::iterator> index;
+    };
+
+    std::size_t _getShardIndex(PsfCacheKey const &key) const {
+        // Mix the hash, so the shards don't all see the same few values of hash % bucket_count
+        std::uint64_t const hash = std::hash<PsfCacheKey>()(key) * 0x9E3779B97F4A7C15ULL;
+        return (hash >> 32) % _shards.size();
+    }
+
+    std::size_t _capacity;
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::atomic<std::size_t> _hits;
+    std::atomic<std::size_t> _misses;
+    std::atomic<std::size_t> _evictions;
+    std::atomic<Stamp> _lastStamp;
+};
+
+constexpr std::size_t PsfCache::MAX_SHARDS;
+constexpr std::size_t PsfCache::MIN_SHARD_CAPACITY;
+
+}  // namespace detail
 
 namespace {
 
 bool isPointNull(lsst::geom::Point2D const &p) { return std::isnan(p.getX()) && std::isnan(p.getY()); }
 
+/*
+ * Deep-copy a cached image, which other threads may be using at the same time.
+ *
+ * Copying the image itself (even with deep=true) or any of its arrays would change the reference count
+ * of its ndarray manager, which is not atomic, so the pixels are copied into a new image through views.
+ */
+std::shared_ptr<Psf::Image> copyCachedImage(Psf::Image const &image) {
+    auto result = std::make_shared<Psf::Image>(image.getBBox());
+    result->assign(image);
+    return result;
+}
+
+/*
+ * Apply the defaults to the arguments of the batch member functions, as the single-position member
+ * functions do; if isFixed, all positions and colors are replaced by the averages.
+ */
+void resolveBatchArguments(Psf const &psf, bool isFixed, std::vector<lsst::geom::Point2D> const &positions,
+                           std::vector<image::Color> const &colors,
+                           std::vector<lsst::geom::Point2D> &resolvedPositions,
+                           std::vector<image::Color> &resolvedColors) {
+    if (!colors.empty() && colors.size() != positions.size()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Number of colors (%d) does not match number of positions (%d)") %
+                           colors.size() % positions.size())
+                                  .str());
+    }
+    lsst::geom::Point2D const averagePosition = psf.getAveragePosition();
+    image::Color const averageColor = psf.getAverageColor();
+    resolvedPositions.clear();
+    resolvedColors.clear();
+    resolvedPositions.reserve(positions.size());
+    resolvedColors.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        bool const nullPosition = isFixed || isPointNull(positions[i]);
+        resolvedPositions.push_back(nullPosition ? averagePosition : positions[i]);
+        bool const nullColor = isFixed || colors.empty() || colors[i].isIndeterminate();
+        resolvedColors.push_back(nullColor ? averageColor : colors[i]);
+    }
+}
+
+// Check the number of results returned by a batch member function
+void checkBatchSize(std::size_t size, std::size_t expected, std::string const &name) {
+    if (size != expected) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError,
+                          (boost::format("%s returned %d results for %d positions") % name % size % expected)
+                                  .str());
+    }
+}
+
 }  // namespace
 
 Psf::Psf(bool isFixed, std::size_t capacity) : daf::base::Citizen(typeid(this)), _isFixed(isFixed) {
-    _imageCache = std::make_unique<PsfCache>(capacity);
-    _kernelImageCache = std::make_unique<PsfCache>(capacity);
+    _imageCache = std::make_unique<detail::PsfCache>(capacity);
+    _kernelImageCache = std::make_unique<detail::PsfCache>(capacity);
 }
 
 Psf::~Psf() = default;
@@ -108,7 +341,7 @@ std::shared_ptr<Psf::Image> Psf::computeImage(lsst::geom::Point2D position, imag
             detail::PsfCacheKey(position, color),
             [this](detail::PsfCacheKey const &key) { return doComputeImage(key.position, key.color); });
     if (owner == COPY) {
-        result = std::make_shared<Image>(*result, true);
+        result = copyCachedImage(*result);
     }
     return result;
 }
@@ -121,7 +354,7 @@ std::shared_ptr<Psf::Image> Psf::computeKernelImage(lsst::geom::Point2D position
             detail::PsfCacheKey(position, color),
             [this](detail::PsfCacheKey const &key) { return doComputeKernelImage(key.position, key.color); });
     if (owner == COPY) {
-        result = std::make_shared<Image>(*result, true);
+        result = copyCachedImage(*result);
     }
     return result;
 }
@@ -136,8 +369,8 @@ std::shared_ptr<math::Kernel const> Psf::getLocalKernel(lsst::geom::Point2D posi
                                                         image::Color color) const {
     if (isPointNull(position)) position = getAveragePosition();
     if (color.isIndeterminate()) color = getAverageColor();
-    // FixedKernel ctor will deep copy image, so we can use INTERNAL.
-    std::shared_ptr<Image> image = computeKernelImage(position, color, INTERNAL);
+    // FixedKernel ctor will deep copy image, but that is not safe for a cached image, so we use COPY.
+    std::shared_ptr<Image> image = computeKernelImage(position, color, COPY);
     return std::make_shared<math::FixedKernel>(*image);
 }
 
@@ -160,6 +393,108 @@ geom::ellipses::Quadrupole Psf::computeShape(lsst::geom::Point2D position, image
     return doComputeShape(position, color);
 }
 
+std::vector<std::shared_ptr<Psf::Image>> Psf::computeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, std::vector<image::Color> const &colors,
+        ImageOwnerEnum owner) const {
+    std::vector<lsst::geom::Point2D> resolvedPositions;
+    std::vector<image::Color> resolvedColors;
+    resolveBatchArguments(*this, _isFixed, positions, colors, resolvedPositions, resolvedColors);
+
+    // Look up each position in the cache, collecting the distinct keys that are missing
+    std::size_t const nPositions = resolvedPositions.size();
+    std::vector<std::shared_ptr<Image>> result(nPositions);
+    std::vector<detail::PsfCacheKey> missingKeys;
+    std::vector<lsst::geom::Point2D> missingPositions;
+    std::vector<image::Color> missingColors;
+    std::unordered_map<detail::PsfCacheKey, std::size_t> missingIndices;  // key -> index in missingKeys
+    std::vector<std::pair<std::size_t, std::size_t>> pending;            // (index in result, in missingKeys)
+    for (std::size_t i = 0; i < nPositions; ++i) {
+        detail::PsfCacheKey const key(resolvedPositions[i], resolvedColors[i]);
+        auto const iter = missingIndices.find(key);
+        if (iter != missingIndices.end()) {
+            pending.emplace_back(i, iter->second);
+            continue;
+        }
+        result[i] = _kernelImageCache->find(key);
+        if (!result[i]) {
+            pending.emplace_back(i, missingKeys.size());
+            missingIndices.emplace(key, missingKeys.size());
+            missingKeys.push_back(key);
+            missingPositions.push_back(key.position);
+            missingColors.push_back(key.color);
+        }
+    }
+
+    if (!missingKeys.empty()) {
+        std::vector<std::shared_ptr<Image>> computed = doComputeKernelImages(missingPositions, missingColors);
+        checkBatchSize(computed.size(), missingKeys.size(), "doComputeKernelImages");
+        for (std::size_t j = 0; j < missingKeys.size(); ++j) {
+            computed[j] = _kernelImageCache->insert(missingKeys[j], computed[j]);
+        }
+        for (auto const &indices : pending) {
+            result[indices.first] = computed[indices.second];
+        }
+    }
+
+    if (owner == COPY) {
+        for (auto &image : result) {
+            image = copyCachedImage(*image);
+        }
+    }
+    return result;
+}
+
+ndarray::Array<double, 1, 1> Psf::computeApertureFluxes(double radius,
+                                                       std::vector<lsst::geom::Point2D> const &positions,
+                                                       std::vector<image::Color> const &colors) const {
+    std::vector<lsst::geom::Point2D> resolvedPositions;
+    std::vector<image::Color> resolvedColors;
+    resolveBatchArguments(*this, false, positions, colors, resolvedPositions, resolvedColors);
+    ndarray::Array<double, 1, 1> result = doComputeApertureFluxes(radius, resolvedPositions, resolvedColors);
+    checkBatchSize(result.getSize<0>(), positions.size(), "doComputeApertureFluxes");
+    return result;
+}
+
+std::vector<geom::ellipses::Quadrupole> Psf::computeShapes(std::vector<lsst::geom::Point2D> const &positions,
+                                                           std::vector<image::Color> const &colors) const {
+    std::vector<lsst::geom::Point2D> resolvedPositions;
+    std::vector<image::Color> resolvedColors;
+    resolveBatchArguments(*this, false, positions, colors, resolvedPositions, resolvedColors);
+    std::vector<geom::ellipses::Quadrupole> result = doComputeShapes(resolvedPositions, resolvedColors);
+    checkBatchSize(result.size(), positions.size(), "doComputeShapes");
+    return result;
+}
+
+std::vector<std::shared_ptr<Psf::Image>> Psf::doComputeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, std::vector<image::Color> const &colors) const {
+    std::vector<std::shared_ptr<Image>> result;
+    result.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        result.push_back(doComputeKernelImage(positions[i], colors[i]));
+    }
+    return result;
+}
+
+ndarray::Array<double, 1, 1> Psf::doComputeApertureFluxes(double radius,
+                                                         std::vector<lsst::geom::Point2D> const &positions,
+                                                         std::vector<image::Color> const &colors) const {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        result[i] = doComputeApertureFlux(radius, positions[i], colors[i]);
+    }
+    return result;
+}
+
+std::vector<geom::ellipses::Quadrupole> Psf::doComputeShapes(
+        std::vector<lsst::geom::Point2D> const &positions, std::vector<image::Color> const &colors) const {
+    std::vector<geom::ellipses::Quadrupole> result;
+    result.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        result.push_back(doComputeShape(positions[i], colors[i]));
+    }
+    return result;
+}
+
 std::shared_ptr<Psf::Image> Psf::doComputeImage(lsst::geom::Point2D const &position,
                                                 image::Color const &color) const {
     std::shared_ptr<Psf::Image> im = computeKernelImage(position, color, COPY);
@@ -175,6 +510,18 @@ void Psf::setCacheCapacity(std::size_t capacity) {
     _kernelImageCache->reserve(capacity);
 }
 
+Psf::CacheStatistics Psf::getCacheStatistics() const {
+    CacheStatistics const image = _imageCache->getStatistics();
+    CacheStatistics const kernelImage = _kernelImageCache->getStatistics();
+    return {image.hits + kernelImage.hits, image.misses + kernelImage.misses,
+            image.evictions + kernelImage.evictions};
+}
+
+void Psf::resetCacheStatistics() {
+    _imageCache->resetStatistics();
+    _kernelImageCache->resetStatistics();
+}
+
 }  // namespace detection
 }  // namespace afw
 }  // namespace lsst
@@ -1,12 +1,15 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <complex>
 #include <cmath>
+#include <limits>
 #include <sstream>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 
 #include "fitsio.h"
 extern "C" {
@@ -1081,6 +1084,19 @@ void Fits::writeTableScalar(std::size_t row, int col, std::string const &value)
     }
 }
 
+void Fits::writeTableStrings(std::size_t row, int col, std::vector<std::string> const &values) {
+    // As in writeTableScalar, each string is written up to its first null terminator.
+    std::vector<char const *> tmp(values.size());
+    std::transform(values.begin(), values.end(), tmp.begin(),
+                   [](std::string const &value) { return value.c_str(); });
+    fits_write_col(reinterpret_cast<fitsfile *>(fptr), TSTRING, col + 1, row + 1, 1, tmp.size(),
+                   const_cast<char const **>(tmp.data()), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Writing %d strings starting at table cell (%d, %d)") %
+                                              values.size() % row % col);
+    }
+}
+
 template <typename T>
 void Fits::readTableArray(std::size_t row, int col, int nElements, T *value) {
     int anynul = false;
@@ -1128,6 +1144,21 @@ long Fits::getTableArraySize(std::size_t row, int col) {
     return result;
 }
 
+std::vector<long> Fits::getTableArraySizes(int col) {
+    std::size_t const nRows = countRows();
+    std::vector<long> result(nRows, 0);
+    if (nRows == 0) {
+        return result;
+    }
+    std::vector<long> offsets(nRows, 0);
+    fits_read_descripts(reinterpret_cast<fitsfile *>(fptr), col + 1, 1, nRows, result.data(), offsets.data(),
+                        &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Looking up array sizes for column %d") % col);
+    }
+    return result;
+}
+
 // ---- Manipulating images ---------------------------------------------------------------------------------
 
 void Fits::createEmpty() {
@@ -1183,6 +1214,76 @@ private:
     ImageCompressionOptions old;  // Former compression options, to be restored
 };
 
+/// Create a tile-compressed image HDU for tiles compressed by detail::compressTiles
+///
+/// This creates the binary table and writes the keywords describing the compressed image,
+/// as cfitsio does when it creates a compressed image; the tiles are written separately
+/// (writeCompressedTiles), after the header.
+void createCompressedImage(Fits &fits, int bitpix, ndarray::Vector<long, 2> const &dims,
+                           ImageCompressionOptions const &options,
+                           std::vector<std::vector<unsigned char>> const &tiles) {
+    auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+    std::size_t heapSize = 0;
+    for (auto const &tile : tiles) {
+        heapSize += tile.size();
+    }
+    // 64-bit heap descriptors are only needed for very large images
+    char ttype[] = "COMPRESSED_DATA";
+    char tform[] = "1PB";
+    char tformLarge[] = "1QB";
+    char *ttypes[] = {ttype};
+    char *tforms[] = {heapSize > std::numeric_limits<std::int32_t>::max() ? tformLarge : tform};
+    fits_create_tbl(fptr, BINARY_TBL, tiles.size(), 1, ttypes, tforms, nullptr, nullptr, &fits.status);
+    if (fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(fits, "Creating compressed image HDU");
+    }
+
+    auto const tileShape = detail::computeTileShape(options.tiles, dims[0], dims[1]);
+    fits_write_key_log(fptr, "ZIMAGE", 1, "extension contains compressed image", &fits.status);
+    fits_write_key_lng(fptr, "ZBITPIX", bitpix, "data type of original image", &fits.status);
+    fits_write_key_lng(fptr, "ZNAXIS", 2, "dimension of original image", &fits.status);
+    fits_write_key_lng(fptr, "ZNAXIS1", dims[0], "length of original image axis", &fits.status);
+    fits_write_key_lng(fptr, "ZNAXIS2", dims[1], "length of original image axis", &fits.status);
+    fits_write_key_lng(fptr, "ZTILE1", tileShape[0], "size of tiles to be compressed", &fits.status);
+    fits_write_key_lng(fptr, "ZTILE2", tileShape[1], "size of tiles to be compressed", &fits.status);
+    switch (options.algorithm) {
+        case ImageCompressionOptions::GZIP:
+            fits_write_key_str(fptr, "ZCMPTYPE", "GZIP_1", "compression algorithm", &fits.status);
+            break;
+        case ImageCompressionOptions::GZIP_SHUFFLE:
+            fits_write_key_str(fptr, "ZCMPTYPE", "GZIP_2", "compression algorithm", &fits.status);
+            break;
+        case ImageCompressionOptions::RICE:
+            fits_write_key_str(fptr, "ZCMPTYPE", "RICE_1", "compression algorithm", &fits.status);
+            fits_write_key_str(fptr, "ZNAME1", "BLOCKSIZE", "compression block size", &fits.status);
+            fits_write_key_lng(fptr, "ZVAL1", 32, "pixels per block", &fits.status);
+            fits_write_key_str(fptr, "ZNAME2", "BYTEPIX", "bytes per pixel (1, 2, 4, or 8)", &fits.status);
+            fits_write_key_lng(fptr, "ZVAL2", bitpix / 8, "bytes per pixel (1, 2, 4, or 8)", &fits.status);
+            break;
+        default:
+            std::abort();  // Programming error: detail::compressTiles doesn't support anything else
+    }
+    if (bitpix < 0) {
+        fits_write_key_str(fptr, "ZQUANTIZ", "NONE", "Lossless compression without quantization",
+                           &fits.status);
+    }
+    if (fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(fits, "Writing compressed image keywords");
+    }
+}
+
+/// Write tiles compressed by detail::compressTiles to the HDU made by createCompressedImage
+void writeCompressedTiles(Fits &fits, std::vector<std::vector<unsigned char>> const &tiles) {
+    auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+    for (std::size_t ii = 0; ii < tiles.size(); ++ii) {
+        fits_write_col(fptr, TBYTE, 1, ii + 1, 1, tiles[ii].size(),
+                       const_cast<unsigned char *>(tiles[ii].data()), &fits.status);
+        if (fits.behavior & Fits::AUTO_CHECK) {
+            LSST_FITS_CHECK_STATUS(fits, boost::format("Writing compressed tile %d") % ii);
+        }
+    }
+}
+
 }  // anonymous namespace
 
 template <typename T>
@@ -1195,16 +1296,33 @@ void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const
                     ? options.compression
                     : ImageCompressionOptions(
                               ImageCompressionOptions::NONE);  // cfitsio can't compress empty images
-    ImageCompressionContext comp(*this, compression);          // RAII
+    ImageScale scale = options.scaling.determine(image, mask);
+    int const bitpix = scale.bitpix == 0 ? detail::Bitpix<T>::value : scale.bitpix;
+
+    // cfitsio compresses the tiles one at a time; if we've been asked to use more threads, and can, we
+    // compress the tiles ourselves and hand cfitsio an uncompressed binary table to write them to.
+    bool const compressTiles = allowImageCompression && compression.nThreads != 1 &&
+                               detail::isTileCompressionSupported(compression, bitpix);
+    ImageCompressionContext comp(*this, compressTiles ? ImageCompressionOptions(ImageCompressionOptions::NONE)
+                                                      : compression);  // RAII
     if (behavior & AUTO_CHECK) {
         LSST_FITS_CHECK_STATUS(*this, "Activating compression for write image");
     }
 
-    ImageScale scale = options.scaling.determine(image, mask);
+    // Scale the image how we want it on disk
+    ndarray::Array<T const, 2, 2> array = makeContiguousArray(image.getArray());
+    auto pixels = scale.toFits(array, compression.quantizeLevel != 0, options.scaling.fuzz,
+                               options.compression.tiles, options.scaling.seed);
 
     // We need a place to put the image+header, and CFITSIO needs to know the dimenions.
     ndarray::Vector<long, 2> dims(image.getArray().getShape().reverse());
-    createImageImpl(scale.bitpix == 0 ? detail::Bitpix<T>::value : scale.bitpix, 2, dims.elems);
+    std::vector<std::vector<unsigned char>> tiles;  // compressed tiles, if we're compressing them ourselves
+    if (compressTiles) {
+        tiles = detail::compressTiles(compression, bitpix, *pixels, dims[0], dims[1]);
+        createCompressedImage(*this, bitpix, dims, compression, tiles);
+    } else {
+        createImageImpl(bitpix, 2, dims.elems);
+    }
 
     // Write the header
     std::shared_ptr<daf::base::PropertyList> wcsMetadata =
@@ -1218,32 +1336,31 @@ void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const
     }
     writeMetadata(*header);
 
-    // Scale the image how we want it on disk
-    ndarray::Array<T const, 2, 2> array = makeContiguousArray(image.getArray());
-    auto pixels = scale.toFits(array, compression.quantizeLevel != 0, options.scaling.fuzz,
-                               options.compression.tiles, options.scaling.seed);
+    if (compressTiles) {
+        writeCompressedTiles(*this, tiles);
+    } else {
+        // We only want cfitsio to do the scale and zero for unsigned 64-bit integer types. For those,
+        // "double bzero" has sufficient precision to represent the appropriate value. We'll let
+        // cfitsio handle it itself.
+        // In all other cases, we will convert the image to use the appropriate scale and zero
+        // (because we want to fuzz the numbers in the quantisation), so we don't want cfitsio
+        // rescaling.
+        if (!std::is_same<T, std::uint64_t>::value) {
+            fits_set_bscale(fits, 1.0, 0.0, &status);
+            if (behavior & AUTO_CHECK) {
+                LSST_FITS_CHECK_STATUS(*this, "Setting bscale,bzero");
+            }
+        }
 
-    // We only want cfitsio to do the scale and zero for unsigned 64-bit integer types. For those,
-    // "double bzero" has sufficient precision to represent the appropriate value. We'll let
-    // cfitsio handle it itself.
-    // In all other cases, we will convert the image to use the appropriate scale and zero
-    // (because we want to fuzz the numbers in the quantisation), so we don't want cfitsio
-    // rescaling.
-    if (!std::is_same<T, std::uint64_t>::value) {
-        fits_set_bscale(fits, 1.0, 0.0, &status);
+        // Write the pixels
+        int const fitsType = scale.bitpix == 0 ? FitsType<T>::CONSTANT : fitsTypeForBitpix(scale.bitpix);
+        fits_write_img(fits, fitsType, 1, pixels->getNumElements(), const_cast<void *>(pixels->getData()),
+                       &status);
         if (behavior & AUTO_CHECK) {
-            LSST_FITS_CHECK_STATUS(*this, "Setting bscale,bzero");
+            LSST_FITS_CHECK_STATUS(*this, "Writing image");
         }
     }
 
-    // Write the pixels
-    int const fitsType = scale.bitpix == 0 ? FitsType<T>::CONSTANT : fitsTypeForBitpix(scale.bitpix);
-    fits_write_img(fits, fitsType, 1, pixels->getNumElements(), const_cast<void *>(pixels->getData()),
-                   &status);
-    if (behavior & AUTO_CHECK) {
-        LSST_FITS_CHECK_STATUS(*this, "Writing image");
-    }
-
     // Now write the headers we didn't want cfitsio to know about when we were writing the pixels
     // (because we don't want it using them to modify the pixels, and we don't want it overwriting
     // these values).
@@ -1646,7 +1763,8 @@ ImageWriteOptions::ImageWriteOptions(daf::base::PropertySet const &config)
         : compression(fits::compressionAlgorithmFromString(config.get<std::string>("compression.algorithm")),
                       std::vector<long>{config.getAsInt64("compression.columns"),
                                         config.getAsInt64("compression.rows")},
-                      config.getAsDouble("compression.quantizeLevel")),
+                      config.getAsDouble("compression.quantizeLevel"),
+                      config.exists("compression.nThreads") ? config.getAsInt("compression.nThreads") : 1),
           scaling(fits::scalingAlgorithmFromString(config.get<std::string>("scaling.algorithm")),
                   config.getAsInt("scaling.bitpix"),
                   config.exists("scaling.maskPlanes") ? config.getArray<std::string>("scaling.maskPlanes")
@@ -1678,6 +1796,7 @@ std::shared_ptr<daf::base::PropertySet> ImageWriteOptions::validate(daf::base::P
     validateEntry(*validated, config, "compression.columns", 0);
     validateEntry(*validated, config, "compression.rows", 1);
     validateEntry(*validated, config, "compression.quantizeLevel", 0.0);
+    validateEntry(*validated, config, "compression.nThreads", 1);
 
     validateEntry(*validated, config, "scaling.algorithm", std::string("NONE"));
     validateEntry(*validated, config, "scaling.bitpix", 0);
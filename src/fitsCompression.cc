@@ -1,5 +1,8 @@
 // -*- lsst-c++ -*-
 
+#include <cstdlib>
+#include <memory>
+
 #include "fitsio.h"
 extern "C" {
 #include "fitsio2.h"
@@ -7,7 +10,9 @@ extern "C" {
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/Random.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
+#include "lsst/afw/fits.h"
 #include "lsst/afw/fitsCompression.h"
 
 extern float* fits_rand_value;     // Random numbers, defined in cfitsio
@@ -89,13 +94,28 @@ int compressionAlgorithmToCfitsio(ImageCompressionOptions::CompressionAlgorithm
 }
 
 ImageCompressionOptions::ImageCompressionOptions(ImageCompressionOptions::CompressionAlgorithm algorithm_,
-                                                 int rows, float quantizeLevel_)
-        : algorithm(algorithm_), tiles(ndarray::allocate(MAX_COMPRESS_DIM)), quantizeLevel(quantizeLevel_) {
+                                                 int rows, float quantizeLevel_, int nThreads_)
+        : algorithm(algorithm_),
+          tiles(ndarray::allocate(MAX_COMPRESS_DIM)),
+          quantizeLevel(quantizeLevel_),
+          nThreads(nThreads_) {
     tiles[0] = 0;
     tiles[1] = rows;
     for (int ii = 2; ii < MAX_COMPRESS_DIM; ++ii) tiles[ii] = 1;
 }
 
+namespace detail {
+
+ndarray::Vector<long, 2> computeTileShape(ndarray::Array<long, 1> const& tiles, long width, long height) {
+    long const xTiles = tiles.getNumElements() > 0 ? tiles[0] : 0;
+    long const yTiles = tiles.getNumElements() > 1 ? tiles[1] : 0;
+    long const xTileSize = xTiles <= 0 ? width : std::min(xTiles, std::max(width, 1L));
+    long const yTileSize = yTiles < 0 ? height : (yTiles == 0 ? 1 : std::min(yTiles, std::max(height, 1L)));
+    return ndarray::makeVector(xTileSize, yTileSize);
+}
+
+}  // namespace detail
+
 ImageScalingOptions::ScalingAlgorithm scalingAlgorithmFromString(std::string const& name) {
     if (name == "NONE") return ImageScalingOptions::NONE;
     if (name == "RANGE") return ImageScalingOptions::RANGE;
@@ -372,8 +392,9 @@ public:
                                      ndarray::Array<long, 1> const& tiles) {
         std::size_t const xSize = shape[1], ySize = shape[0];
         ndarray::Array<T, 1, 1> out = ndarray::allocate(xSize * ySize);
-        std::size_t const xTileSize = tiles[0] <= 0 ? xSize : tiles[0];
-        std::size_t const yTileSize = tiles[1] < 0 ? ySize : (tiles[1] == 0 ? 1 : tiles[1]);
+        auto const tileShape = detail::computeTileShape(tiles, xSize, ySize);
+        std::size_t const xTileSize = tileShape[0];
+        std::size_t const yTileSize = tileShape[1];
         int const xNumTiles = std::ceil(xSize / static_cast<float>(xTileSize));
         int const yNumTiles = std::ceil(ySize / static_cast<float>(yTileSize));
         for (int iTile = 0, yTile = 0; yTile < yNumTiles; ++yTile) {
@@ -482,6 +503,151 @@ std::shared_ptr<detail::PixelArrayBase> ImageScale::toFits(ndarray::Array<T cons
     return detail::makePixelArray(bitpix, out);
 }
 
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+bool const HOST_IS_BIG_ENDIAN = true;
+#else
+bool const HOST_IS_BIG_ENDIAN = false;
+#endif
+
+int const RICE_BLOCKSIZE = 32;  // Pixels per block for RICE compression; cfitsio's default
+
+/// RICE-compress a tile with cfitsio, returning the number of bytes written (negative on failure)
+int riceCompress(std::uint8_t* tile, int num, unsigned char* out, int outSize) {
+    return fits_rcomp_byte(reinterpret_cast<signed char*>(tile), num, out, outSize, RICE_BLOCKSIZE);
+}
+int riceCompress(std::int16_t* tile, int num, unsigned char* out, int outSize) {
+    return fits_rcomp_short(tile, num, out, outSize, RICE_BLOCKSIZE);
+}
+int riceCompress(std::int32_t* tile, int num, unsigned char* out, int outSize) {
+    return fits_rcomp(tile, num, out, outSize, RICE_BLOCKSIZE);
+}
+template <typename T>
+int riceCompress(T*, int, unsigned char*, int) {
+    throw LSST_EXCEPT(pex::exceptions::LogicError, "RICE compression is only supported for integer pixels");
+}
+
+/// GZIP-compress a buffer with cfitsio
+std::vector<unsigned char> gzipCompress(std::vector<unsigned char>& buffer) {
+    std::size_t bufferSize = buffer.size() + buffer.size() / 1000 + 64;  // usually enough; realloc'd if not
+    char* compressed = static_cast<char*>(std::malloc(bufferSize));
+    std::size_t compressedSize = 0;
+    int status = 0;
+    compress2mem_from_mem(reinterpret_cast<char*>(buffer.data()), buffer.size(), &compressed, &bufferSize,
+                          std::realloc, &compressedSize, &status);
+    std::unique_ptr<char, void (*)(void*)> guard(compressed, std::free);
+    if (status != 0) {
+        throw LSST_EXCEPT(FitsError, makeErrorMessage("", status, "GZIP-compressing image tile"));
+    }
+    return std::vector<unsigned char>(compressed, compressed + compressedSize);
+}
+
+/// Compress a tile of pixels as cfitsio does
+template <typename T>
+std::vector<unsigned char> compressTile(ImageCompressionOptions::CompressionAlgorithm algorithm,
+                                        std::vector<T>& tile) {
+    std::size_t const num = tile.size();
+    if (algorithm == ImageCompressionOptions::RICE) {
+        // Incompressible data expand by a few bits per block, plus the first pixel and some padding
+        std::vector<unsigned char> out(num * sizeof(T) + num / RICE_BLOCKSIZE + sizeof(T) + 16);
+        int const size = riceCompress(tile.data(), num, out.data(), out.size());
+        if (size < 0) {
+            throw LSST_EXCEPT(FitsError, "Failed to RICE-compress image tile");
+        }
+        out.resize(size);
+        return out;
+    }
+    // GZIP_1 compresses the big-endian pixel values; GZIP_2 first shuffles their bytes, so that the
+    // most significant bytes of all the pixels come first, then the next most significant, etc.
+    bool const shuffle = algorithm == ImageCompressionOptions::GZIP_SHUFFLE;
+    std::vector<unsigned char> bytes(num * sizeof(T));
+    auto const in = reinterpret_cast<unsigned char const*>(tile.data());
+    for (std::size_t ii = 0; ii < num; ++ii) {
+        for (std::size_t bb = 0; bb < sizeof(T); ++bb) {
+            unsigned char const value = in[ii * sizeof(T) + (HOST_IS_BIG_ENDIAN ? bb : sizeof(T) - 1 - bb)];
+            bytes[shuffle ? bb * num + ii : ii * sizeof(T) + bb] = value;
+        }
+    }
+    return gzipCompress(bytes);
+}
+
+/// Compress the tiles of an image with pixels of a particular type
+template <typename T>
+std::vector<std::vector<unsigned char>> compressTilesImpl(ImageCompressionOptions const& options,
+                                                          T const* pixels, long width, long height) {
+    auto const tileShape = detail::computeTileShape(options.tiles, width, height);
+    long const xNumTiles = (width + tileShape[0] - 1) / tileShape[0];
+    long const yNumTiles = (height + tileShape[1] - 1) / tileShape[1];
+    std::vector<std::vector<unsigned char>> result(xNumTiles * yNumTiles);
+    int const nThreads = math::detail::resolveNThreads(options.nThreads);
+    math::detail::parallelFor(static_cast<int>(result.size()), nThreads, [&](int iTile) {
+        long const xStart = (iTile % xNumTiles) * tileShape[0];
+        long const yStart = (iTile / xNumTiles) * tileShape[1];
+        long const xStop = std::min(xStart + tileShape[0], width);
+        long const yStop = std::min(yStart + tileShape[1], height);
+        std::vector<T> tile;
+        tile.reserve((xStop - xStart) * (yStop - yStart));
+        for (long y = yStart; y < yStop; ++y) {
+            T const* row = pixels + y * width;
+            tile.insert(tile.end(), row + xStart, row + xStop);
+        }
+        result[iTile] = compressTile(options.algorithm, tile);
+    });
+    return result;
+}
+
+}  // anonymous namespace
+
+namespace detail {
+
+bool isTileCompressionSupported(ImageCompressionOptions const& options, int bitpix) {
+    bool const isInteger = bitpix == 8 || bitpix == 16 || bitpix == 32;
+    switch (options.algorithm) {
+        case ImageCompressionOptions::GZIP:
+        case ImageCompressionOptions::GZIP_SHUFFLE:
+            // Quantisation of floating-point pixels by cfitsio is not supported
+            return isInteger || ((bitpix == -32 || bitpix == -64) && options.quantizeLevel == 0.0);
+        case ImageCompressionOptions::RICE:
+            return isInteger;
+        default:
+            return false;
+    }
+}
+
+std::vector<std::vector<unsigned char>> compressTiles(ImageCompressionOptions const& options, int bitpix,
+                                                      PixelArrayBase const& pixels, long width, long height) {
+    if (!isTileCompressionSupported(options, bitpix)) {
+        std::ostringstream os;
+        os << "Unsupported tile compression: " << compressionAlgorithmToString(options.algorithm)
+           << " for bitpix=" << bitpix << " and quantizeLevel=" << options.quantizeLevel;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    if (width <= 0 || height <= 0 || pixels.getNumElements() != static_cast<std::size_t>(width * height)) {
+        std::ostringstream os;
+        os << "Cannot compress " << pixels.getNumElements() << " pixels as an image of size " << width << "x"
+           << height;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    void const* data = pixels.getData();
+    switch (bitpix) {
+        case 8:
+            return compressTilesImpl(options, static_cast<std::uint8_t const*>(data), width, height);
+        case 16:
+            return compressTilesImpl(options, static_cast<std::int16_t const*>(data), width, height);
+        case 32:
+            return compressTilesImpl(options, static_cast<std::int32_t const*>(data), width, height);
+        case -32:
+            return compressTilesImpl(options, static_cast<boost::float32_t const*>(data), width, height);
+        case -64:
+            return compressTilesImpl(options, static_cast<boost::float64_t const*>(data), width, height);
+        default:
+            std::abort();  // Programming error: should never get here
+    }
+}
+
+}  // namespace detail
+
 template <typename T>
 ndarray::Array<T, 2, 2> ImageScale::fromFits(ndarray::Array<T, 2, 2> const& image) const {
     ndarray::Array<T, 2, 2> memory = ndarray::allocate(image.getShape());
@@ -0,0 +1,338 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "Eigen/LU"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/SkyWcsApproximation.h"
+
+namespace lsst { namespace afw { namespace geom {
+
+namespace {
+
+// Convergence threshold (in pixels) and iteration limit for skyToPixel.
+double const PIXEL_TOLERANCE = 1E-9;
+int const MAX_ITERATIONS = 50;
+
+// Ratio of the reported error bound to the largest measured error; see the SkyWcsApproximation class docs.
+double const ERROR_MARGIN = 2.0;
+
+// Compute the weights (and their derivatives) of 4-point Lagrange interpolation for
+// points at -1, 0, 1, 2, evaluated at u.
+void computeLagrangeWeights(double u, double weights[4], double derivatives[4]) {
+    double const um1 = u - 1.0;
+    double const um2 = u - 2.0;
+    double const up1 = u + 1.0;
+    weights[0] = -u*um1*um2/6.0;
+    weights[1] = up1*um1*um2/2.0;
+    weights[2] = -up1*u*um2/2.0;
+    weights[3] = up1*u*um1/6.0;
+    double const u2 = u*u;
+    derivatives[0] = -(3.0*u2 - 6.0*u + 2.0)/6.0;
+    derivatives[1] = (3.0*u2 - 4.0*u - 1.0)/2.0;
+    derivatives[2] = -(3.0*u2 - 2.0*u - 2.0)/2.0;
+    derivatives[3] = (3.0*u2 - 1.0)/6.0;
+}
+
+// Compute the index of the first of the 4 grid points used to interpolate at position t (in units of
+// the grid step), and the offset of t from the second of those points.
+int computeStencil(double t, int n, double & u) {
+    // clamp before converting to int, so points far outside the grid cannot overflow
+    double const start = std::floor(std::min(std::max(t, 0.0), static_cast<double>(n)));
+    int const index = std::min(std::max(static_cast<int>(start), 1), n - 3);
+    u = t - index;
+    return index - 1;
+}
+
+Eigen::Vector3d makeUnitVector(double ra, double dec) {
+    double const cosDec = std::cos(dec);
+    return Eigen::Vector3d(cosDec*std::cos(ra), cosDec*std::sin(ra), std::sin(dec));
+}
+
+}  // namespace
+
+SkyWcsApproximation::SkyWcsApproximation(
+    SkyWcs const & wcs,
+    lsst::geom::Box2D const & bbox,
+    lsst::geom::Angle const & maxError,
+    int maxGridSize
+) : _bbox(bbox), _nx(0), _ny(0), _xStep(0.0), _yStep(0.0),
+    _maxError(std::numeric_limits<double>::quiet_NaN())
+{
+    if (!(bbox.getWidth() > 0.0 && bbox.getHeight() > 0.0)) {
+        std::ostringstream os;
+        os << "bbox = " << bbox << " has zero area";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    if (!(maxError.asRadians() > 0.0)) {
+        std::ostringstream os;
+        os << "maxError = " << maxError.asArcseconds() << " arcsec is not positive";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    if (maxGridSize < 5) {
+        std::ostringstream os;
+        os << "maxGridSize = " << maxGridSize << " < 5";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+
+    // Tangent plane basis at the center of the bounding box.
+    auto const centerSky = wcs.pixelToSky(bbox.getCenter());
+    double const ra0 = centerSky.getLongitude().asRadians();
+    double const dec0 = centerSky.getLatitude().asRadians();
+    _center = makeUnitVector(ra0, dec0);
+    _xiAxis = Eigen::Vector3d(-std::sin(ra0), std::cos(ra0), 0.0);
+    _etaAxis = Eigen::Vector3d(-std::sin(dec0)*std::cos(ra0), -std::sin(dec0)*std::sin(ra0), std::cos(dec0));
+
+    // Each pass evaluates the exact mapping on a grid with twice the resolution of the trial grid: the
+    // even points are the trial grid itself, and the others are the points at which its error is
+    // measured.  If the error is too large, the trial grid is refined and we try again.
+    int nCells = 4;
+    while (true) {
+        int const nx = nCells + 1;
+        int const ny = nCells + 1;
+        if (nx > maxGridSize) {
+            std::ostringstream os;
+            os << "Cannot approximate SkyWcs over " << bbox << " to within " << maxError.asArcseconds()
+               << " arcsec with a grid of at most " << maxGridSize << " points; error bound = "
+               << (_maxError*lsst::geom::radians).asArcseconds()
+               << " arcsec with " << _nx << "x" << _ny << " points";
+            throw LSST_EXCEPT(pex::exceptions::RuntimeError, os.str());
+        }
+        int const nxFine = 2*nCells + 1;
+        int const nyFine = 2*nCells + 1;
+        double const xStepFine = bbox.getWidth()/(nxFine - 1);
+        double const yStepFine = bbox.getHeight()/(nyFine - 1);
+        std::vector<lsst::geom::Point2D> pixels;
+        pixels.reserve(nxFine*nyFine);
+        for (int j = 0; j < nyFine; ++j) {
+            for (int i = 0; i < nxFine; ++i) {
+                pixels.emplace_back(bbox.getMinX() + i*xStepFine, bbox.getMinY() + j*yStepFine);
+            }
+        }
+        auto const sky = wcs.pixelToSky(pixels);
+
+        _nx = nx;
+        _ny = ny;
+        _xStep = 2.0*xStepFine;
+        _yStep = 2.0*yStepFine;
+        _xi.assign(nx*ny, 0.0);
+        _eta.assign(nx*ny, 0.0);
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                auto const & point = sky[2*j*nxFine + 2*i];
+                Eigen::Vector2d tangent;
+                if (!_project(point.getLongitude().asRadians(), point.getLatitude().asRadians(), tangent)) {
+                    std::ostringstream os;
+                    os << "bbox = " << bbox << " covers too large an area of the sky to approximate";
+                    throw LSST_EXCEPT(pex::exceptions::RuntimeError, os.str());
+                }
+                _xi[j*nx + i] = tangent[0];
+                _eta[j*nx + i] = tangent[1];
+            }
+        }
+
+        double error = 0.0;
+        for (int j = 0; j < nyFine; ++j) {
+            for (int i = (j % 2 == 0) ? 1 : 0; i < nxFine; i += (j % 2 == 0) ? 2 : 1) {
+                auto const & exact = sky[j*nxFine + i];
+                Eigen::Vector3d const exactVector = makeUnitVector(exact.getLongitude().asRadians(),
+                                                                   exact.getLatitude().asRadians());
+                Eigen::Vector2d const tangent = _interpolate(pixels[j*nxFine + i].getX(),
+                                                             pixels[j*nxFine + i].getY());
+                Eigen::Vector3d const approxVector = _center + tangent[0]*_xiAxis + tangent[1]*_etaAxis;
+                double const separation = std::atan2(exactVector.cross(approxVector).norm(),
+                                                     exactVector.dot(approxVector));
+                // written so that a NaN separation is treated as too large
+                if (!(separation <= error)) {
+                    error = std::isnan(separation) ? std::numeric_limits<double>::infinity() : separation;
+                }
+            }
+        }
+        _maxError = ERROR_MARGIN*error;
+        if (_maxError <= maxError.asRadians()) {
+            break;
+        }
+        nCells *= 2;
+    }
+}
+
+lsst::geom::SpherePoint SkyWcsApproximation::pixelToSky(lsst::geom::Point2D const & pixel) const {
+    double ra, dec;
+    _pixelToSky(pixel.getX(), pixel.getY(), ra, dec);
+    return lsst::geom::SpherePoint(ra*lsst::geom::radians, dec*lsst::geom::radians);
+}
+
+std::vector<lsst::geom::SpherePoint> SkyWcsApproximation::pixelToSky(
+    std::vector<lsst::geom::Point2D> const & pixels
+) const {
+    std::vector<lsst::geom::SpherePoint> result;
+    result.reserve(pixels.size());
+    for (auto const & pixel : pixels) {
+        result.push_back(pixelToSky(pixel));
+    }
+    return result;
+}
+
+void SkyWcsApproximation::pixelToSky(
+    ndarray::Array<double const, 1> const & x,
+    ndarray::Array<double const, 1> const & y,
+    ndarray::Array<double, 1> const & ra,
+    ndarray::Array<double, 1> const & dec
+) const {
+    if (y.getSize<0>() != x.getSize<0>() || ra.getSize<0>() != x.getSize<0>() ||
+        dec.getSize<0>() != x.getSize<0>()) {
+        std::ostringstream os;
+        os << "Array sizes do not match: x: " << x.getSize<0>() << ", y: " << y.getSize<0>()
+           << ", ra: " << ra.getSize<0>() << ", dec: " << dec.getSize<0>();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    for (std::size_t i = 0; i < x.getSize<0>(); ++i) {
+        _pixelToSky(x[i], y[i], ra[i], dec[i]);
+    }
+}
+
+lsst::geom::Point2D SkyWcsApproximation::skyToPixel(lsst::geom::SpherePoint const & sky) const {
+    double x, y;
+    _skyToPixel(sky.getLongitude().asRadians(), sky.getLatitude().asRadians(), x, y);
+    return lsst::geom::Point2D(x, y);
+}
+
+std::vector<lsst::geom::Point2D> SkyWcsApproximation::skyToPixel(
+    std::vector<lsst::geom::SpherePoint> const & sky
+) const {
+    std::vector<lsst::geom::Point2D> result;
+    result.reserve(sky.size());
+    for (auto const & point : sky) {
+        result.push_back(skyToPixel(point));
+    }
+    return result;
+}
+
+void SkyWcsApproximation::skyToPixel(
+    ndarray::Array<double const, 1> const & ra,
+    ndarray::Array<double const, 1> const & dec,
+    ndarray::Array<double, 1> const & x,
+    ndarray::Array<double, 1> const & y
+) const {
+    if (dec.getSize<0>() != ra.getSize<0>() || x.getSize<0>() != ra.getSize<0>() ||
+        y.getSize<0>() != ra.getSize<0>()) {
+        std::ostringstream os;
+        os << "Array sizes do not match: ra: " << ra.getSize<0>() << ", dec: " << dec.getSize<0>()
+           << ", x: " << x.getSize<0>() << ", y: " << y.getSize<0>();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    for (std::size_t i = 0; i < ra.getSize<0>(); ++i) {
+        _skyToPixel(ra[i], dec[i], x[i], y[i]);
+    }
+}
+
+Eigen::Vector2d SkyWcsApproximation::_interpolate(double x, double y, Eigen::Matrix2d * jacobian) const {
+    double u, v;
+    int const i0 = computeStencil((x - _bbox.getMinX())/_xStep, _nx, u);
+    int const j0 = computeStencil((y - _bbox.getMinY())/_yStep, _ny, v);
+    double wx[4], dwx[4], wy[4], dwy[4];
+    computeLagrangeWeights(u, wx, dwx);
+    computeLagrangeWeights(v, wy, dwy);
+    Eigen::Vector2d result = Eigen::Vector2d::Zero();
+    Eigen::Vector2d dx = Eigen::Vector2d::Zero();
+    Eigen::Vector2d dy = Eigen::Vector2d::Zero();
+    for (int j = 0; j < 4; ++j) {
+        // interpolate along x first, then combine the rows
+        double rowXi = 0.0, rowEta = 0.0, rowDXi = 0.0, rowDEta = 0.0;
+        int const offset = (j0 + j)*_nx + i0;
+        for (int i = 0; i < 4; ++i) {
+            rowXi += wx[i]*_xi[offset + i];
+            rowEta += wx[i]*_eta[offset + i];
+            rowDXi += dwx[i]*_xi[offset + i];
+            rowDEta += dwx[i]*_eta[offset + i];
+        }
+        result[0] += wy[j]*rowXi;
+        result[1] += wy[j]*rowEta;
+        dx[0] += wy[j]*rowDXi;
+        dx[1] += wy[j]*rowDEta;
+        dy[0] += dwy[j]*rowXi;
+        dy[1] += dwy[j]*rowEta;
+    }
+    if (jacobian) {
+        jacobian->col(0) = dx/_xStep;
+        jacobian->col(1) = dy/_yStep;
+    }
+    return result;
+}
+
+bool SkyWcsApproximation::_project(double ra, double dec, Eigen::Vector2d & tangent) const {
+    Eigen::Vector3d const vector = makeUnitVector(ra, dec);
+    double const cosDistance = vector.dot(_center);
+    if (!(cosDistance > 0.0)) {
+        return false;
+    }
+    tangent[0] = vector.dot(_xiAxis)/cosDistance;
+    tangent[1] = vector.dot(_etaAxis)/cosDistance;
+    return true;
+}
+
+void SkyWcsApproximation::_deproject(Eigen::Vector2d const & tangent, double & ra, double & dec) const {
+    Eigen::Vector3d const vector = _center + tangent[0]*_xiAxis + tangent[1]*_etaAxis;
+    ra = std::atan2(vector[1], vector[0]);
+    if (ra < 0.0) {
+        ra += lsst::geom::TWOPI;
+    }
+    dec = std::atan2(vector[2], std::hypot(vector[0], vector[1]));
+}
+
+void SkyWcsApproximation::_pixelToSky(double x, double y, double & ra, double & dec) const {
+    if (!(std::isfinite(x) && std::isfinite(y))) {
+        ra = dec = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    _deproject(_interpolate(x, y), ra, dec);
+}
+
+void SkyWcsApproximation::_skyToPixel(double ra, double dec, double & x, double & y) const {
+    x = y = std::numeric_limits<double>::quiet_NaN();
+    Eigen::Vector2d target;
+    if (!(std::isfinite(ra) && std::isfinite(dec)) || !_project(ra, dec, target)) {
+        return;
+    }
+    Eigen::Vector2d pixel(_bbox.getCenter().getX(), _bbox.getCenter().getY());
+    Eigen::Matrix2d jacobian;
+    for (int n = 0; n < MAX_ITERATIONS; ++n) {
+        Eigen::Vector2d const residual = target - _interpolate(pixel[0], pixel[1], &jacobian);
+        Eigen::Vector2d const step = jacobian.inverse()*residual;
+        if (!step.allFinite()) {
+            return;
+        }
+        pixel += step;
+        if (step.squaredNorm() <= PIXEL_TOLERANCE*PIXEL_TOLERANCE) {
+            x = pixel[0];
+            y = pixel[1];
+            return;
+        }
+    }
+}
+
+}}}  // namespace lsst::afw::geom
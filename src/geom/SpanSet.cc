@@ -23,6 +23,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <utility>
+#include <vector>
 #include "lsst/afw/geom/SpanSet.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -41,36 +43,6 @@ template std::shared_ptr<geom::SpanSet> table::io::PersistableFacade<geom::SpanS
 namespace geom {
 namespace {
 
-/* These classes are used in the erode operator to quickly calculate the
- * contents of the shrunken SpanSet
- */
-
-struct PrimaryRun {
-    int m, y, xmin, xmax;
-};
-
-bool comparePrimaryRun(PrimaryRun const& first, PrimaryRun const& second) {
-    if (first.y != second.y) {
-        return first.y < second.y;
-    } else if (first.m != second.m) {
-        return first.m < second.m;
-    } else {
-        return first.xmin < second.xmin;
-    }
-}
-
-class ComparePrimaryRunY {
-public:
-    bool operator()(PrimaryRun const& pr, int yval) { return pr.y < yval; }
-    bool operator()(int yval, PrimaryRun const& pr) { return yval < pr.y; }
-};
-
-class ComparePrimaryRunM {
-public:
-    bool operator()(PrimaryRun const& pr, int mval) { return pr.m < mval; }
-    bool operator()(int mval, PrimaryRun const& pr) { return mval < pr.m; }
-};
-
 /* Determine if two spans overlap
  *
  * a First Span in comparison
@@ -106,6 +78,259 @@ bool spansContiguous(Span const& a, Span const& b, bool compareY = true) {
                    : false;
 }
 
+/* Run-length helpers for the boolean and morphological operators
+ *
+ * The Spans of a normalized SpanSet are sorted by row and then by x, and the Spans in a row are neither
+ * overlapping nor contiguous.  The row operations below each merge two such rows and append the result,
+ * also normalized, to a vector of Spans, in time linear in the number of Spans involved.  The Spans of the
+ * second row may be offset by (dx0, dx1) at either end, which is how the morphological operators apply a
+ * row of their structuring element without making a shifted copy of the row.
+ */
+typedef std::vector<Span>::const_iterator SpanIter;
+
+// Return the end of the row of Spans beginning at begin
+SpanIter findRowEnd(SpanIter begin, SpanIter end) {
+    int const y = begin->getY();
+    return std::find_if(begin, end, [y](Span const& spn) { return spn.getY() != y; });
+}
+
+// Append a run to out, merging it with the last Span of out if that is in the same row and they overlap
+// or touch; the run must not begin before the last Span of out
+void appendRun(std::vector<Span>& out, int y, int x0, int x1) {
+    if (!out.empty() && out.back().getY() == y && x0 <= out.back().getMaxX() + 1) {
+        if (x1 > out.back().getMaxX()) {
+            out.back() = Span(y, out.back().getMinX(), x1);
+        }
+    } else {
+        out.push_back(Span(y, x0, x1));
+    }
+}
+
+// Append the union of the rows [a, aEnd) and [b, bEnd) to out, as row y
+void unionRows(SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y, std::vector<Span>& out,
+               int dx0 = 0, int dx1 = 0) {
+    while (a != aEnd && b != bEnd) {
+        if (a->getMinX() <= b->getMinX() + dx0) {
+            appendRun(out, y, a->getMinX(), a->getMaxX());
+            ++a;
+        } else {
+            appendRun(out, y, b->getMinX() + dx0, b->getMaxX() + dx1);
+            ++b;
+        }
+    }
+    for (; a != aEnd; ++a) {
+        appendRun(out, y, a->getMinX(), a->getMaxX());
+    }
+    for (; b != bEnd; ++b) {
+        appendRun(out, y, b->getMinX() + dx0, b->getMaxX() + dx1);
+    }
+}
+
+// Append the intersection of the rows [a, aEnd) and [b, bEnd) to out, as row y
+void intersectRows(SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y, std::vector<Span>& out,
+                   int dx0 = 0, int dx1 = 0) {
+    while (a != aEnd && b != bEnd) {
+        int const x0 = std::max(a->getMinX(), b->getMinX() + dx0);
+        int const x1 = std::min(a->getMaxX(), b->getMaxX() + dx1);
+        if (x0 <= x1) {
+            out.push_back(Span(y, x0, x1));
+        }
+        // Whichever run ends first can not overlap anything further in the other row
+        if (a->getMaxX() < b->getMaxX() + dx1) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+}
+
+// Append the pixels of the row [a, aEnd) which are not in the row [b, bEnd) to out, as row y
+void subtractRows(SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y, std::vector<Span>& out) {
+    for (; a != aEnd; ++a) {
+        int x0 = a->getMinX();
+        int const x1 = a->getMaxX();
+        // Runs of b which end before this run of a also end before every later one
+        while (b != bEnd && b->getMaxX() < x0) {
+            ++b;
+        }
+        for (SpanIter cut = b; cut != bEnd && cut->getMinX() <= x1; ++cut) {
+            if (cut->getMinX() > x0) {
+                out.push_back(Span(y, x0, cut->getMinX() - 1));
+            }
+            x0 = std::max(x0, cut->getMaxX() + 1);
+        }
+        if (x0 <= x1) {
+            out.push_back(Span(y, x0, x1));
+        }
+    }
+}
+
+/* Combine two normalized vectors of Spans row by row
+ *
+ * first, second - the Spans to combine
+ * keepFirst, keepSecond - whether to copy the rows found in only one of first and second to the output
+ * rowOperation - called as rowOperation(a, aEnd, b, bEnd, y, out) for each row y found in both
+ */
+template <typename RowOperation>
+std::vector<Span> combineRows(std::vector<Span> const& first, std::vector<Span> const& second,
+                              bool keepFirst, bool keepSecond, RowOperation rowOperation) {
+    std::vector<Span> result;
+    result.reserve(keepSecond ? first.size() + second.size() : first.size());
+    SpanIter a = first.begin();
+    SpanIter b = second.begin();
+    while ((a != first.end() && (keepFirst || b != second.end())) ||
+           (b != second.end() && (keepSecond || a != first.end()))) {
+        if (b == second.end() || (a != first.end() && a->getY() < b->getY())) {
+            SpanIter const aEnd = findRowEnd(a, first.end());
+            if (keepFirst) {
+                result.insert(result.end(), a, aEnd);
+            }
+            a = aEnd;
+        } else if (a == first.end() || b->getY() < a->getY()) {
+            SpanIter const bEnd = findRowEnd(b, second.end());
+            if (keepSecond) {
+                result.insert(result.end(), b, bEnd);
+            }
+            b = bEnd;
+        } else {
+            SpanIter const aEnd = findRowEnd(a, first.end());
+            SpanIter const bEnd = findRowEnd(b, second.end());
+            rowOperation(a, aEnd, b, bEnd, a->getY(), result);
+            a = aEnd;
+            b = bEnd;
+        }
+    }
+    return result;
+}
+
+/* Rows of Spans stored one after another in a single vector
+ *
+ * The morphological operators build many short rows; keeping them all in one vector, which grows
+ * geometrically, costs a handful of allocations rather than one per row.
+ */
+class RowArena {
+public:
+    explicit RowArena(std::size_t nRows) : _spans(), _rows(nRows, std::make_pair(0, 0)) {}
+
+    // Copy a vector of Spans to be row i
+    void setRow(std::size_t i, std::vector<Span> const& row) {
+        _rows[i] = std::make_pair(_spans.size(), _spans.size() + row.size());
+        _spans.insert(_spans.end(), row.begin(), row.end());
+    }
+
+    // Append the Spans of row i to out, as row y
+    void copyRow(std::size_t i, int y, std::vector<Span>& out) const {
+        for (auto spn = begin(i); spn != end(i); ++spn) {
+            out.push_back(Span(y, spn->getMinX(), spn->getMaxX()));
+        }
+    }
+
+    SpanIter begin(std::size_t i) const { return _spans.begin() + _rows[i].first; }
+    SpanIter end(std::size_t i) const { return _spans.begin() + _rows[i].second; }
+
+private:
+    std::vector<Span> _spans;
+    std::vector<std::pair<std::size_t, std::size_t>> _rows;
+};
+
+/* The range of Spans in each row of a normalized vector of Spans
+ *
+ * Rows outside the vector's range of y, or with no Spans, are empty.
+ */
+class RowIndex {
+public:
+    explicit RowIndex(std::vector<Span> const& spans) : _spans(spans), _y0(0), _starts(1, 0) {
+        if (spans.empty()) {
+            return;
+        }
+        _y0 = spans.front().getY();
+        int const height = spans.back().getY() - _y0 + 1;
+        _starts.resize(height + 1);
+        std::size_t i = 0;
+        for (int row = 0; row < height; ++row) {
+            _starts[row] = i;
+            while (i < spans.size() && spans[i].getY() == _y0 + row) {
+                ++i;
+            }
+        }
+        _starts[height] = spans.size();
+    }
+
+    SpanIter begin(int y) const { return _spans.begin() + _starts[_clamp(y)]; }
+    SpanIter end(int y) const { return _spans.begin() + _starts[_clamp(y + 1)]; }
+
+private:
+    // Index of the start of row y in _starts; rows past either end are empty
+    std::size_t _clamp(int y) const {
+        return std::min<std::size_t>(std::max(y - _y0, 0), _starts.size() - 1);
+    }
+
+    std::vector<Span> const& _spans;
+    int _y0;
+    std::vector<std::size_t> _starts;
+};
+
+/* Combine every window of h consecutive rows of a normalized vector of Spans
+ *
+ * This is the van Herk/Gil-Werman algorithm applied to rows of runs rather than pixels.  The rows are
+ * divided into blocks of h, and the cumulative combination of the rows from the start of each block to
+ * each row, and from each row to the end of its block, are computed.  Every window of h rows is then
+ * the combination of one of each, so each output row costs three row merges however large h is.
+ *
+ * rows - Spans to combine
+ * yBegin, yEnd - range of output rows; output row y combines rows y + dy through y + dy + h - 1
+ * rowOperation - unionRows or intersectRows; it must be associative
+ */
+template <typename RowOperation>
+std::vector<Span> combineRowWindows(std::vector<Span> const& rows, int yBegin, int yEnd, int dy, int h,
+                                    RowOperation rowOperation) {
+    std::vector<Span> result;
+    if (yBegin >= yEnd) {
+        return result;
+    }
+    RowIndex const index(rows);
+    int const y0 = yBegin + dy;  // input row i is y0 + i
+    std::size_t const nRows = yEnd - yBegin + h - 1;
+    RowArena fromStart(nRows);
+    RowArena toEnd(nRows);
+    std::vector<Span> scratch;
+    for (std::size_t blockBegin = 0; blockBegin < nRows; blockBegin += h) {
+        std::size_t const blockEnd = std::min(blockBegin + h, nRows);
+        for (std::size_t i = blockBegin; i < blockEnd; ++i) {
+            int const y = y0 + static_cast<int>(i);
+            scratch.clear();
+            if (i == blockBegin) {
+                scratch.assign(index.begin(y), index.end(y));
+            } else {
+                rowOperation(fromStart.begin(i - 1), fromStart.end(i - 1), index.begin(y), index.end(y), y,
+                             scratch);
+            }
+            fromStart.setRow(i, scratch);
+        }
+        for (std::size_t i = blockEnd; i-- > blockBegin;) {
+            int const y = y0 + static_cast<int>(i);
+            scratch.clear();
+            if (i + 1 == blockEnd) {
+                scratch.assign(index.begin(y), index.end(y));
+            } else {
+                rowOperation(index.begin(y), index.end(y), toEnd.begin(i + 1), toEnd.end(i + 1), y, scratch);
+            }
+            toEnd.setRow(i, scratch);
+        }
+    }
+    for (int y = yBegin; y < yEnd; ++y) {
+        std::size_t const first = y - yBegin;
+        std::size_t const last = first + h - 1;
+        if (first % h == 0) {
+            toEnd.copyRow(first, y, result);
+        } else {
+            rowOperation(toEnd.begin(first), toEnd.end(first), fromStart.begin(last), fromStart.end(last), y,
+                         result);
+        }
+    }
+    return result;
+}
+
 /* Determine the intersection with a mask or its logical inverse
  *
  * spanSet - SpanSet object with which to intersect the mask
@@ -554,20 +779,51 @@ std::shared_ptr<SpanSet> SpanSet::dilated(SpanSet const& other) const {
     if (other.size() == 0) {
         return std::make_shared<SpanSet>(_spanVector.begin(), _spanVector.end(), false);
     }
+    if (size() == 0) {
+        return std::make_shared<SpanSet>();
+    }
 
-    // Return a dilated Spanset by the given SpanSet
-    std::vector<Span> tempVec;
+    lsst::geom::Box2I const otherBBox = other.getBBox();
+    if (other.getArea() == static_cast<std::size_t>(otherBBox.getArea())) {
+        // A rectangular kernel (e.g. a BOX stencil) is separable: widen each row by the kernel's width,
+        // then take the union of each window of rows as high as the kernel
+        std::vector<Span> rows;
+        rows.reserve(size());
+        for (auto const& spn : _spanVector) {
+            appendRun(rows, spn.getY(), spn.getMinX() + otherBBox.getMinX(),
+                      spn.getMaxX() + otherBBox.getMaxX());
+        }
+        return std::make_shared<SpanSet>(
+                combineRowWindows(rows, _bbox.getMinY() + otherBBox.getMinY(),
+                                  _bbox.getMaxY() + otherBBox.getMaxY() + 1, -otherBBox.getMaxY(),
+                                  otherBBox.getHeight(),
+                                  [](SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y,
+                                     std::vector<Span>& out) { unionRows(a, aEnd, b, bEnd, y, out); }),
+                false);
+    }
 
-    for (auto const& spn : _spanVector) {
+    // Each row of the result is the union of the rows of this, each offset by the Spans of the kernel
+    // which bring it to that row.  Building the result a row at a time keeps it normalized, so it need
+    // not be sorted.
+    RowIndex const index(_spanVector);
+    std::vector<Span> tempVec;
+    std::vector<Span> row;
+    std::vector<Span> scratch;
+    for (int y = _bbox.getMinY() + otherBBox.getMinY(); y <= _bbox.getMaxY() + otherBBox.getMaxY(); ++y) {
+        row.clear();
         for (auto const& otherSpn : other) {
-            int const xmin = spn.getMinX() + otherSpn.getMinX();
-            int const xmax = spn.getMaxX() + otherSpn.getMaxX();
-            int const yval = spn.getY() + otherSpn.getY();
-            tempVec.push_back(Span(yval, xmin, xmax));
+            int const thisY = y - otherSpn.getY();
+            if (index.begin(thisY) == index.end(thisY)) {
+                continue;
+            }
+            scratch.clear();
+            unionRows(row.begin(), row.end(), index.begin(thisY), index.end(thisY), y, scratch,
+                      otherSpn.getMinX(), otherSpn.getMaxX());
+            std::swap(row, scratch);
         }
+        tempVec.insert(tempVec.end(), row.begin(), row.end());
     }
-    // Allow constructor to handle merging adjacent and overlapping spans
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
 }
 
 std::shared_ptr<SpanSet> SpanSet::eroded(int r, Stencil s) const {
@@ -583,97 +839,62 @@ std::shared_ptr<SpanSet> SpanSet::eroded(SpanSet const& other) const {
         return std::make_shared<SpanSet>(_spanVector.begin(), _spanVector.end(), false);
     }
 
-    // Return a SpanSet eroded by the given SpanSet
-    std::vector<Span> tempVec;
-
-    // Calculate all possible primary runs.
-    std::vector<PrimaryRun> primaryRuns;
-    for (auto const& spn : _spanVector) {
-        int m = 0;
-        for (auto const& otherSpn : other) {
-            if ((otherSpn.getMaxX() - otherSpn.getMinX()) <= (spn.getMaxX() - spn.getMinX())) {
-                int xmin = spn.getMinX() - otherSpn.getMinX();
-                int xmax = spn.getMaxX() - otherSpn.getMaxX();
-                int y = spn.getY() - otherSpn.getY();
-                primaryRuns.push_back(PrimaryRun({m, y, xmin, xmax}));
+    lsst::geom::Box2I const otherBBox = other.getBBox();
+    if (other.getArea() == static_cast<std::size_t>(otherBBox.getArea())) {
+        // A rectangular kernel (e.g. a BOX stencil) is separable: narrow each row by the kernel's width,
+        // then take the intersection of each window of rows as high as the kernel
+        std::vector<Span> rows;
+        rows.reserve(size());
+        for (auto const& spn : _spanVector) {
+            int const xmin = spn.getMinX() - otherBBox.getMinX();
+            int const xmax = spn.getMaxX() - otherBBox.getMaxX();
+            if (xmin <= xmax) {
+                rows.push_back(Span(spn.getY(), xmin, xmax));
             }
-            ++m;
         }
+        return std::make_shared<SpanSet>(
+                combineRowWindows(rows, _bbox.getMinY() - otherBBox.getMinY(),
+                                  _bbox.getMaxY() - otherBBox.getMaxY() + 1, otherBBox.getMinY(),
+                                  otherBBox.getHeight(),
+                                  [](SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y,
+                                     std::vector<Span>& out) { intersectRows(a, aEnd, b, bEnd, y, out); }),
+                false);
     }
 
-    // Iterate over the primary runs in such a way that we consider all values of m
-    // for a given y, then all m for y+1 etc.
-    std::sort(primaryRuns.begin(), primaryRuns.end(), comparePrimaryRun);
-
-    for (int y = primaryRuns.front().y; y <= primaryRuns.back().y; ++y) {
-        auto yRange = std::equal_range(primaryRuns.begin(), primaryRuns.end(), y, ComparePrimaryRunY());
-
-        /* Discard runs for any value of y for which we find fewer groups than M,
-         * the total Y range of the structuring element. This is step 3.1 of the
-         * Kim et al. algorithm.
-         */
-        // Plus one because end points are inclusive
-        auto otherYRange = other.back().getY() - other.front().getY() + 1;
-        if (std::distance(yRange.first, yRange.second) < otherYRange) {
-            continue;
-        }
-
-        /* "good" runs are those which are covered by each value of m, ie by each
-         * row in the structuring element. Our algorithm will consider each value
-         * of m in turn, gradually whittling down the list of good runs, then
-         * finally convert the remainder into Spans.
-         */
-        std::list<PrimaryRun> goodRuns;
-
-        for (int m = 0; m < otherYRange; ++m) {
-            auto mRange = std::equal_range(yRange.first, yRange.second, m, ComparePrimaryRunM());
-            if ((mRange.first == mRange.second)) {
-                // If a particular m is missing, we known that this y contains
-                // no good runs; this is equivalent to Kim et al. step 3.2.
-                goodRuns.clear();
-            } else {
-                // Consolidate all primary runs at this m so that they don't overlap.
-                std::list<PrimaryRun> candidateRuns;
-                int startX = mRange.first->xmin;
-                int endX = mRange.first->xmax;
-                for (auto run = mRange.first + 1; run != mRange.second; ++run) {
-                    if (run->xmin > endX) {
-                        // Start of a new run
-                        candidateRuns.push_back(PrimaryRun{m, y, startX, endX});
-                        startX = run->xmin;
-                        endX = run->xmax;
-                    } else {
-                        // Continuation of an existing run
-                        endX = run->xmax;
-                    }
-                }
-                candidateRuns.push_back(PrimaryRun{m, y, startX, endX});
-
-                // Otherwise, calculate the intersection of candidate runs at
-                // this m with good runs from all previous m.
-                if (m == 0) {
-                    // For m = 0 we have nothing to compare to; all runs are accepted
-                    std::swap(goodRuns, candidateRuns);
-                } else {
-                    std::list<PrimaryRun> newlist;
-                    for (auto& good : goodRuns) {
-                        for (auto& cand : candidateRuns) {
-                            int start = std::max(good.xmin, cand.xmin);
-                            int end = std::min(good.xmax, cand.xmax);
-                            if (end >= start) {
-                                newlist.push_back(PrimaryRun({m, y, start, end}));
-                            }
-                        }
+    /* A point is in the eroded SpanSet if every Span of the kernel, offset by that point, lies within a
+     * Span of this.  For a Span of the kernel, the points for which that is true in each row are the
+     * Spans of the corresponding row of this, narrowed by the kernel Span at either end; each row of
+     * the result is the intersection of those for all the Spans of the kernel.
+     */
+    RowIndex const index(_spanVector);
+    std::vector<Span> tempVec;
+    std::vector<Span> row;
+    std::vector<Span> scratch;
+    for (int y = _bbox.getMinY() - otherBBox.getMinY(); y <= _bbox.getMaxY() - otherBBox.getMaxY(); ++y) {
+        row.clear();
+        for (auto otherSpn = other.begin(); otherSpn != other.end(); ++otherSpn) {
+            int const thisY = y + otherSpn->getY();
+            if (otherSpn == other.begin()) {
+                for (auto spn = index.begin(thisY); spn != index.end(thisY); ++spn) {
+                    int const xmin = spn->getMinX() - otherSpn->getMinX();
+                    int const xmax = spn->getMaxX() - otherSpn->getMaxX();
+                    if (xmin <= xmax) {
+                        row.push_back(Span(y, xmin, xmax));
                     }
-                    std::swap(newlist, goodRuns);
                 }
+            } else {
+                scratch.clear();
+                intersectRows(row.begin(), row.end(), index.begin(thisY), index.end(thisY), y, scratch,
+                              -otherSpn->getMinX(), -otherSpn->getMaxX());
+                std::swap(row, scratch);
+            }
+            if (row.empty()) {
+                break;
             }
         }
-        for (auto& run : goodRuns) {
-            tempVec.push_back(Span(run.y, run.xmin, run.xmax));
-        }
+        tempVec.insert(tempVec.end(), row.begin(), row.end());
     }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
 }
 
 bool SpanSet::operator==(SpanSet const& other) const {
@@ -727,20 +948,12 @@ std::shared_ptr<SpanSet> SpanSet::intersect(SpanSet const& other) const {
     if (other == *this) {
         return std::make_shared<SpanSet>(this->_spanVector);
     }
-    std::vector<Span> tempVec;
-    auto otherIter = other.begin();
-    for (auto const& spn : _spanVector) {
-        while (otherIter != other.end() && otherIter->getY() <= spn.getY()) {
-            if (spansOverlap(spn, *otherIter)) {
-                auto newMin = std::max(spn.getMinX(), otherIter->getMinX());
-                auto newMax = std::min(spn.getMaxX(), otherIter->getMaxX());
-                auto newSpan = Span(spn.getY(), newMin, newMax);
-                tempVec.push_back(newSpan);
-            }
-            ++otherIter;
-        }
-    }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    // Merge the rows of the two SpanSets, keeping only the rows found in both
+    return std::make_shared<SpanSet>(
+            combineRows(_spanVector, other._spanVector, false, false,
+                        [](SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y,
+                           std::vector<Span>& out) { intersectRows(a, aEnd, b, bEnd, y, out); }),
+            false);
 }
 
 std::shared_ptr<SpanSet> SpanSet::intersectNot(SpanSet const& other) const {
@@ -752,91 +965,20 @@ std::shared_ptr<SpanSet> SpanSet::intersectNot(SpanSet const& other) const {
     if (other == *this) {
         return std::make_shared<SpanSet>();
     }
-    /* This function must find all the areas in this and not in other. These SpanSets
-     * may be overlapping with this less than other a1|    b1|   a2|    b2|,
-     * with this greater than other b1|    a1|     b2|    a2|,
-     * with this containing other a1|    b1|     b2|     a2|,
-     * or with other containing this  b1|    a1|    a2|   b2|
-     */
-    std::vector<Span> tempVec;
-    auto otherIter = other.begin();
-    for (auto const& spn : _spanVector) {
-        bool added = false;
-        bool spanStarted = false;
-        int spanBottom = 0;
-        while (otherIter != other.end() && otherIter->getY() <= spn.getY()) {
-            if (spansOverlap(spn, *otherIter)) {
-                added = true;
-                /* To handle one span containing the other, the spans will be added
-                 * piecewise, and let the SpanSet constructor normalize spans which
-                 * end up contiguous. In the case where this is contained in other,
-                 * these statements will all be false, and nothing will be added,
-                 * which is the expected behavior.
-                 *
-                 * Intersection with the logical not of another SpanSet requires that the Intersection
-                 * be tested against the condition that multiple Spans may be present in the other
-                 * SpanSet at the same Y coordinate. I.E. If one row in *this would contain two
-                 * disconnected Spans in other, the result should be three new Spans.
-                 */
-                // Check if a span is in the process of being created
-                if (!spanStarted) {
-                    // If the minimum value of the Span in  *this is less than that of other, add a new Span
-                    if (spn.getMinX() < otherIter->getMinX()) {
-                        tempVec.push_back(Span(spn.getY(), spn.getMinX(), otherIter->getMinX() - 1));
-                    }
-                    // Conversely if the maximum value of the Span in *this is greater than that of other,
-                    // Start a new span, and record what the minimum value of that span should be. This is
-                    // because SpanSets can be disconnected, and the function must check if there are any
-                    // additional Spans which fall in the same row
-                    if (spn.getMaxX() > otherIter->getMaxX()) {
-                        spanStarted = true;
-                        spanBottom = otherIter->getMaxX() + 1;
-                    }
-                } else {
-                    // A span is in the process of being created and should be finished and added
-                    tempVec.push_back(
-                            Span(spn.getY(), spanBottom, std::min(spn.getMaxX(), otherIter->getMinX() - 1)));
-                    spanStarted = false;
-                    // Check if the span in *this extends past that of the Span from other, if so
-                    // begin a new Span
-                    if (spn.getMaxX() > otherIter->getMaxX()) {
-                        spanStarted = true;
-                        spanBottom = otherIter->getMaxX() + 1;
-                    }
-                }
-            }
-            if (otherIter->getMaxX() > spn.getMaxX()) {
-                break;
-            }
-            ++otherIter;
-        }
-        // Check if a span has been started but not finished, if that is the case that means there are
-        // no further spans on this row to consider and the span should be closed and added
-        if (spanStarted) {
-            tempVec.push_back(Span(spn.getY(), spanBottom, spn.getMaxX()));
-        }
-        /* If added is still zero, that means it did not overlap any of the spans in other
-         * and should be included in the new span
-         */
-        if (!added) {
-            tempVec.push_back(Span(spn));
-        }
-    }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    // Merge the rows of the two SpanSets; rows found only in this are kept whole, and rows found only
+    // in other contribute nothing
+    return std::make_shared<SpanSet>(combineRows(_spanVector, other._spanVector, true, false, subtractRows),
+                                     false);
 }
 
 std::shared_ptr<SpanSet> SpanSet::union_(SpanSet const& other) const {
-    /* Simply include Spans from both SpanSets in a new vector and let the SpanSet
-     * constructor normalize any of the SpanSets which may be contiguous
-     */
-    std::size_t combineSize = size() + other.size();
-    std::vector<Span> tempVec;
-    tempVec.reserve(combineSize);
-    // Copy this
-    tempVec.insert(tempVec.end(), _spanVector.begin(), _spanVector.end());
-    // Copy other
-    tempVec.insert(tempVec.end(), other.begin(), other.end());
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    // Merge the rows of the two SpanSets, combining any Spans which overlap or touch as they are merged,
+    // rather than concatenating them and sorting the result
+    return std::make_shared<SpanSet>(
+            combineRows(_spanVector, other._spanVector, true, true,
+                        [](SpanIter a, SpanIter aEnd, SpanIter b, SpanIter bEnd, int y,
+                           std::vector<Span>& out) { unionRows(a, aEnd, b, bEnd, y, out); }),
+            false);
 }
 
 std::shared_ptr<SpanSet> SpanSet::transformedBy(lsst::geom::LinearTransform const& t) const {
@@ -19,6 +19,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <array>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+#include "fitsio.h"
+
 #include "lsst/log/Log.h"
 
 #include "lsst/afw/image/Calib.h"
@@ -28,6 +35,7 @@
 #include "lsst/afw/image/ApCorrMap.h"
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/image/TransmissionCurve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/image/ExposureFitsReader.h"
 
 namespace lsst { namespace afw { namespace image {
@@ -36,6 +44,49 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("afw.image.fits.ExposureFitsReader");
 
+bool endsWith(std::string const & str, std::string const & suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Whether the HDUs of a file can be read concurrently through independent CFITSIO handles on its
+// contents in memory.  This requires a thread-safe CFITSIO and a plain FITS file on disk: URLs, filters
+// and whole-file compression are only understood by CFITSIO when it opens the file itself.
+bool canReadConcurrently(std::string const & fileName) {
+    if (!fits_is_reentrant() || fileName.empty() || fileName == "-" ||
+        fileName.find("://") != std::string::npos || fileName.find('[') != std::string::npos) {
+        return false;
+    }
+    for (auto const & suffix : {".gz", ".Z", ".zip", ".bz2", ".fz"}) {
+        if (endsWith(fileName, suffix)) {
+            return false;
+        }
+    }
+    // CFITSIO recognizes compressed files by their contents, not their names: gzip, compress and pack
+    // files start with 0x1f, PKZIP files with "PK" and bzip2 files with "BZ".
+    std::array<char, 2> magic = {{0, 0}};
+    std::ifstream stream(fileName, std::ios::binary);
+    if (!stream.read(magic.data(), magic.size())) {
+        return false;
+    }
+    bool const isZip = magic[0] == 'P' && magic[1] == 'K';
+    bool const isBzip2 = magic[0] == 'B' && magic[1] == 'Z';
+    return magic[0] != '\x1f' && !isZip && !isBzip2;
+}
+
+std::vector<char> readFileContents(std::string const & fileName) {
+    std::vector<char> contents;
+    std::ifstream stream(fileName, std::ios::binary | std::ios::ate);
+    if (stream) {
+        contents.resize(stream.tellg());
+        stream.seekg(0);
+        stream.read(contents.data(), contents.size());
+    }
+    if (!stream) {
+        throw LSST_EXCEPT(pex::exceptions::IoError, "Could not read file " + fileName);
+    }
+    return contents;
+}
+
 }  // anonymous
 
 class ExposureFitsReader::MetadataReader {
@@ -152,6 +203,16 @@ public:
         return _archive.get<T>(_ids[c]);
     }
 
+    // Return the HDU of an archive that has not been loaded yet, or -1 if there is nothing to load.
+    int getUnloadedHdu() const { return _state == ArchiveState::PRESENT ? _hdu : -1; }
+
+    // Provide the archive read (by the caller) from the HDU returned by getUnloadedHdu.
+    void setArchive(table::io::InputArchive archive) {
+        assert(_state == ArchiveState::PRESENT);
+        _archive = std::move(archive);
+        _state = ArchiveState::LOADED;
+    }
+
 private:
 
     bool _ensureLoaded(afw::fits::Fits * fitsFile) {
@@ -160,8 +221,7 @@ private:
         }
         if (_state == ArchiveState::PRESENT) {
             afw::fits::HduMoveGuard guard(*fitsFile, _hdu);
-            _archive = table::io::InputArchive::readFits(*fitsFile);
-            _state = ArchiveState::LOADED;
+            setArchive(table::io::InputArchive::readFits(*fitsFile));
         }
         assert(_state == ArchiveState::LOADED);  // constructor body should guarantee it's not UNKNOWN
         return true;
@@ -177,6 +237,7 @@ private:
 
 
 ExposureFitsReader::ExposureFitsReader(std::string const& fileName) :
+    _fileName(fileName),
     _maskedImageReader(fileName)
 {}
 
@@ -369,11 +430,12 @@ MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> ExposureFitsReader::readMas
     lsst::geom::Box2I const & bbox,
     ImageOrigin origin,
     bool conformMasks,
-    bool allowUnsafe
+    bool allowUnsafe,
+    int nThreads
 ) {
-    return _maskedImageReader.read<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks,
-                                                                            /* needAllHdus= */false,
-                                                                            allowUnsafe);
+    return _readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks,
+                                                                     allowUnsafe, nThreads,
+                                                                     /* loadArchive= */false);
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
@@ -381,13 +443,112 @@ Exposure<ImagePixelT, MaskPixelT, VariancePixelT> ExposureFitsReader::read(
     lsst::geom::Box2I const & bbox,
     ImageOrigin origin,
     bool conformMasks,
-    bool allowUnsafe
+    bool allowUnsafe,
+    int nThreads
 ) {
-    auto mi = readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks,
-                                                                       allowUnsafe);
+    auto mi = _readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks,
+                                                                        allowUnsafe, nThreads,
+                                                                        /* loadArchive= */true);
     return Exposure<ImagePixelT, MaskPixelT, VariancePixelT>(mi, readExposureInfo());
 }
 
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> ExposureFitsReader::_readMaskedImage(
+    lsst::geom::Box2I const & bbox,
+    ImageOrigin origin,
+    bool conformMasks,
+    bool allowUnsafe,
+    int nThreads,
+    bool loadArchive
+) {
+    nThreads = math::detail::resolveNThreads(nThreads);
+    int const imageHdu = _maskedImageReader._imageReader.getHdu();
+    // Independent handles can only be opened on a plain file, and (as in MaskedImageFitsReader) the mask
+    // and variance are only read when the image is in its standard HDU.
+    if (nThreads <= 1 || imageHdu != 1 || !canReadConcurrently(_fileName)) {
+        return _maskedImageReader.read<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks,
+                                                                                /* needAllHdus= */false,
+                                                                                allowUnsafe);
+    }
+    int archiveHdu = -1;
+    if (loadArchive) {
+        _ensureReaders();
+        archiveHdu = _archiveReader->getUnloadedHdu();
+    }
+
+    // CFITSIO shares one internal state (including the current HDU and I/O buffers) among all handles it
+    // opens on the same file, even through different paths, and does not lock it.  The tasks instead
+    // open their handles on one read-only copy of the file in memory, each with its own non-owning
+    // manager, which CFITSIO treats as separate files.
+    std::vector<char> contents = readFileContents(_fileName);
+    std::array<fits::MemFileManager, 4> managers;
+    for (auto & manager : managers) {
+        manager.reset(contents.data(), contents.size());
+    }
+
+    // Each task reads one HDU into arrays through its own handle.  The images themselves are
+    // constructed (and the mask planes conformed, which modifies global state) only after all tasks
+    // have finished.  As in MaskedImageFitsReader::read, an unreadable mask or variance is replaced
+    // by a default one, while errors reading the image or the archive are propagated.
+    ndarray::Array<ImagePixelT, 2, 2> imageArray;
+    ndarray::Array<MaskPixelT, 2, 2> maskArray;
+    ndarray::Array<VariancePixelT, 2, 2> varianceArray;
+    lsst::geom::Point2I xy0;
+    std::unique_ptr<MaskFitsReader> maskReader;
+    std::string maskError;
+    std::string varianceError;
+    table::io::InputArchive archive;
+    std::vector<std::function<void()>> tasks;
+    tasks.push_back([&]() {
+        ImageFitsReader reader(managers[0], imageHdu);
+        imageArray = reader.readArray<ImagePixelT>(bbox, origin, allowUnsafe);
+        xy0 = reader.readXY0(bbox, origin);
+    });
+    tasks.push_back([&]() {
+        try {
+            auto reader = std::make_unique<MaskFitsReader>(managers[1], imageHdu + 1);
+            maskArray = reader->readArray<MaskPixelT>(bbox, origin, allowUnsafe);
+            maskReader = std::move(reader);
+        } catch (fits::FitsError & e) {
+            maskError = e.what();
+        }
+    });
+    tasks.push_back([&]() {
+        try {
+            ImageFitsReader reader(managers[2], imageHdu + 2);
+            varianceArray = reader.readArray<VariancePixelT>(bbox, origin, allowUnsafe);
+        } catch (fits::FitsError & e) {
+            varianceError = e.what();
+        }
+    });
+    if (archiveHdu >= 0) {
+        tasks.push_back([&]() {
+            fits::Fits fitsFile(managers[3], "r", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+            fitsFile.setHdu(archiveHdu);
+            archive = table::io::InputArchive::readFits(fitsFile);
+        });
+    }
+    math::detail::parallelFor(static_cast<int>(tasks.size()), nThreads, [&tasks](int i) { tasks[i](); });
+
+    auto image = std::make_shared<Image<ImagePixelT>>(imageArray, false, xy0);
+    std::shared_ptr<Mask<MaskPixelT>> mask;
+    std::shared_ptr<Image<VariancePixelT>> variance;
+    if (maskReader) {
+        mask = std::make_shared<Mask<MaskPixelT>>(maskReader->_makeMask(maskArray, xy0, conformMasks));
+    } else {
+        LOGLS_WARN(_log, "Mask unreadable (" << maskError << "); using default");
+    }
+    if (varianceError.empty()) {
+        variance = std::make_shared<Image<VariancePixelT>>(varianceArray, false, xy0);
+    } else {
+        LOGLS_WARN(_log, "Variance unreadable (" << varianceError << "); using default");
+    }
+    if (archiveHdu >= 0) {
+        _archiveReader->setArchive(std::move(archive));
+    }
+    return MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(image, mask, variance);
+}
+
 void ExposureFitsReader::_ensureReaders() {
     if (!_metadataReader) {
         auto metadataReader = std::make_unique<MetadataReader>(
@@ -405,7 +566,7 @@ void ExposureFitsReader::_ensureReaders() {
     template Exposure<ImagePixelT, MaskPixel, VariancePixel> ExposureFitsReader::read( \
         lsst::geom::Box2I const &, \
         ImageOrigin, \
-        bool, bool \
+        bool, bool, int \
     ); \
     template Image<ImagePixelT> ExposureFitsReader::readImage( \
         lsst::geom::Box2I const &, \
@@ -419,7 +580,7 @@ void ExposureFitsReader::_ensureReaders() {
     template MaskedImage<ImagePixelT, MaskPixel, VariancePixel> ExposureFitsReader::readMaskedImage( \
         lsst::geom::Box2I const &, \
         ImageOrigin, \
-        bool, bool \
+        bool, bool, int \
     )
 
 INSTANTIATE(std::uint16_t);
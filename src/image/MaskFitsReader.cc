@@ -27,7 +27,13 @@ namespace lsst { namespace afw { namespace image {
 template <typename PixelT>
 Mask<PixelT> MaskFitsReader::read(lsst::geom::Box2I const & bbox, ImageOrigin origin, bool conformMasks,
                                   bool allowUnsafe) {
-    Mask<PixelT> result(readArray<PixelT>(bbox, origin, allowUnsafe), false, readXY0(bbox, origin));
+    return _makeMask(readArray<PixelT>(bbox, origin, allowUnsafe), readXY0(bbox, origin), conformMasks);
+}
+
+template <typename PixelT>
+Mask<PixelT> MaskFitsReader::_makeMask(ndarray::Array<PixelT, 2, 2> const & array,
+                                       lsst::geom::Point2I const & xy0, bool conformMasks) {
+    Mask<PixelT> result(array, false, xy0);
     auto metadata = readMetadata();
     // look for mask planes in the file
     detail::MaskPlaneDict fileMaskDict = Mask<PixelT>::parseMaskPlaneMetadata(metadata);
@@ -45,7 +51,9 @@ Mask<PixelT> MaskFitsReader::read(lsst::geom::Box2I const & bbox, ImageOrigin or
 }
 
 #define INSTANTIATE(T) \
-    template Mask<T> MaskFitsReader::read(lsst::geom::Box2I const &, ImageOrigin, bool, bool)
+    template Mask<T> MaskFitsReader::read(lsst::geom::Box2I const &, ImageOrigin, bool, bool); \
+    template Mask<T> MaskFitsReader::_makeMask(ndarray::Array<T, 2, 2> const &, \
+                                               lsst::geom::Point2I const &, bool)
 
 INSTANTIATE(MaskPixel);
 
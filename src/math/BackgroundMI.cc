@@ -34,6 +34,8 @@
 #include "lsst/afw/math/Approximate.h"
 #include "lsst/afw/math/Background.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/math/detail/PiecewiseCubic.h"
 
 namespace lsst {
 namespace ex = pex::exceptions;
@@ -90,20 +92,28 @@ BackgroundMI::BackgroundMI(ImageT const& img, BackgroundControl const& bgCtrl)
     image::MaskedImage<InternalPixelT>::Image& im = *_statsImage.getImage();
     image::MaskedImage<InternalPixelT>::Variance& var = *_statsImage.getVariance();
 
+    // The cells are independent, so we may measure them concurrently.  The subimages are made
+    // (and destroyed) here rather than in the threads, as ndarray's reference counting isn't thread safe
+    std::vector<ImageT> subimgs;
+    subimgs.reserve(nxSample * nySample);
     for (int iX = 0; iX < nxSample; ++iX) {
         for (int iY = 0; iY < nySample; ++iY) {
-            ImageT subimg = ImageT(img,
-                                   lsst::geom::Box2I(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
-                                                     lsst::geom::Extent2I(_xsize[iX], _ysize[iY])),
-                                   image::LOCAL);
-
-            std::pair<double, double> res = makeStatistics(subimg, bgCtrl.getStatisticsProperty() | ERRORS,
-                                                           *bgCtrl.getStatisticsControl())
-                                                    .getResult();
-            im(iX, iY) = res.first;
-            var(iX, iY) = res.second;
+            subimgs.push_back(ImageT(img,
+                                     lsst::geom::Box2I(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
+                                                       lsst::geom::Extent2I(_xsize[iX], _ysize[iY])),
+                                     image::LOCAL));
         }
     }
+
+    detail::parallelFor(nxSample * nySample, detail::resolveNThreads(bgCtrl.getNThreads()), [&](int i) {
+        std::pair<double, double> res = makeStatistics(subimgs[i], bgCtrl.getStatisticsProperty() | ERRORS,
+                                                       *bgCtrl.getStatisticsControl())
+                                                .getResult();
+        int const iX = i / nySample;
+        int const iY = i % nySample;
+        im(iX, iY) = res.first;
+        var(iX, iY) = res.second;
+    });
 }
 BackgroundMI::BackgroundMI(lsst::geom::Box2I const imageBBox,
                            image::MaskedImage<InternalPixelT> const& statsImage)
@@ -127,6 +137,12 @@ void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
     std::vector<double> ycenTmp, gridTmp;
     cullNan(_ycen, _grid, ycenTmp, gridTmp);
 
+    // ypix is 0, 1, ..., height - 1, so we can interpolate along the whole column in one go
+    if (detail::PiecewiseCubic::isSupported(interpStyle, gridTmp.size())) {
+        detail::PiecewiseCubic(ycenTmp, gridTmp, interpStyle).interpolate(0, height, _gridColumns[iX].data());
+        return;
+    }
+
     std::shared_ptr<Interpolate> intobj;
     try {
         intobj = makeInterpolate(ycenTmp, gridTmp, interpStyle);
@@ -284,20 +300,20 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
         ypix[iY] = iY;
     }
 
+    int const nThreads = detail::resolveNThreads(_bctrl->getNThreads());
+
     _gridColumns.resize(width);
-    for (int iX = 0; iX < nxSample; ++iX) {
-        _setGridColumns(interpStyle, undersampleStyle, iX, ypix);
-    }
+    detail::parallelFor(nxSample, nThreads,
+                        [&](int iX) { _setGridColumns(interpStyle, undersampleStyle, iX, ypix); });
 
     // create a shared_ptr to put the background image in and return to caller
     // start with xy0 = 0 and set final xy0 later
     std::shared_ptr<image::Image<PixelT>> bg =
             std::shared_ptr<image::Image<PixelT>>(new image::Image<PixelT>(bbox.getDimensions()));
 
-    // go through row by row
+    // go through row by row, in bands of rows that may be processed concurrently
     // - interpolate on the gridcolumns that were pre-computed by the constructor
     // - copy the values to an ImageT to return to the caller.
-    std::vector<double> xcenTmp, bgTmp;
 
     // N.b. There's no API to set defaultValue to other than NaN (due to issues with persistence
     // that I don't feel like fixing;  #2825).  If we want to address this, this is the place
@@ -305,54 +321,72 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
     // us to put a NaN into the outputs some changes will be needed
     double defaultValue = std::numeric_limits<double>::quiet_NaN();
 
-    for (int y = 0, iY = bboxOff.getY(); y < bbox.getHeight(); ++y, ++iY) {
-        // build an interp object for this row
+    std::vector<int> const bands = detail::computeBandBoundaries(0, bbox.getHeight(), nThreads);
+    int const nBands = bands.empty() ? 0 : bands.size() - 1;
+
+    // Get the array here, as ndarray's reference counting isn't thread safe
+    ndarray::Array<PixelT, 2, 1> const bgArray = bg->getArray();
+
+    detail::parallelFor(nBands, nThreads, [&](int band) {
+        std::vector<double> xcenTmp, bgTmp;
         std::vector<double> bg_x(nxSample);
-        for (int iX = 0; iX < nxSample; iX++) {
-            bg_x[iX] = static_cast<double>(_gridColumns[iX][iY]);
-        }
-        cullNan(_xcen, bg_x, xcenTmp, bgTmp, defaultValue);
-
-        std::shared_ptr<Interpolate> intobj;
-        try {
-            intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
-        } catch (pex::exceptions::OutOfRangeError& e) {
-            switch (undersampleStyle) {
-                case THROW_EXCEPTION:
-                    LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-                    throw;
-                case REDUCE_INTERP_ORDER: {
-                    if (bgTmp.empty()) {
-                        xcenTmp.push_back(0);
-                        bgTmp.push_back(defaultValue);
-
-                        intobj = makeInterpolate(xcenTmp, bgTmp, Interpolate::CONSTANT);
-                        break;
-                    } else {
-                        intobj = makeInterpolate(xcenTmp, bgTmp, lookupMaxInterpStyle(bgTmp.size()));
-                    }
-                } break;
-                case INCREASE_NXNYSAMPLE:
-                    LSST_EXCEPT_ADD(
-                            e,
-                            "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE is not supported.");
-                    throw;
-                default:
-                    LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
-                                                         "UndersampleStyle %d is not defined.") %
-                                           undersampleStyle));
-                    throw;
+
+        for (int y = bands[band], iY = bboxOff.getY() + bands[band]; y < bands[band + 1]; ++y, ++iY) {
+            // build an interp object for this row
+            for (int iX = 0; iX < nxSample; iX++) {
+                bg_x[iX] = static_cast<double>(_gridColumns[iX][iY]);
+            }
+            cullNan(_xcen, bg_x, xcenTmp, bgTmp, defaultValue);
+
+            // Usually we can compute the spline's coefficients and fill the row without calling GSL
+            if (detail::PiecewiseCubic::isSupported(interpStyle, bgTmp.size())) {
+                detail::PiecewiseCubic(xcenTmp, bgTmp, interpStyle)
+                        .interpolate(bboxOff.getX(), bboxOff.getX() + bbox.getWidth(),
+                                     bgArray.getData() + y * bgArray.template getStride<0>());
+                continue;
             }
-        } catch (ex::Exception& e) {
-            LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-            throw;
-        }
 
-        // fill the image with interpolated values
-        for (int iX = bboxOff.getX(), x = 0; x < bbox.getWidth(); ++iX, ++x) {
-            (*bg)(x, y) = static_cast<PixelT>(intobj->interpolate(iX));
+            std::shared_ptr<Interpolate> intobj;
+            try {
+                intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
+            } catch (pex::exceptions::OutOfRangeError& e) {
+                switch (undersampleStyle) {
+                    case THROW_EXCEPTION:
+                        LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+                        throw;
+                    case REDUCE_INTERP_ORDER: {
+                        if (bgTmp.empty()) {
+                            xcenTmp.push_back(0);
+                            bgTmp.push_back(defaultValue);
+
+                            intobj = makeInterpolate(xcenTmp, bgTmp, Interpolate::CONSTANT);
+                            break;
+                        } else {
+                            intobj = makeInterpolate(xcenTmp, bgTmp, lookupMaxInterpStyle(bgTmp.size()));
+                        }
+                    } break;
+                    case INCREASE_NXNYSAMPLE:
+                        LSST_EXCEPT_ADD(e,
+                                        "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE is not "
+                                        "supported.");
+                        throw;
+                    default:
+                        LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
+                                                             "UndersampleStyle %d is not defined.") %
+                                               undersampleStyle));
+                        throw;
+                }
+            } catch (ex::Exception& e) {
+                LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+                throw;
+            }
+
+            // fill the image with interpolated values
+            for (int iX = bboxOff.getX(), x = 0; x < bbox.getWidth(); ++iX, ++x) {
+                (*bg)(x, y) = static_cast<PixelT>(intobj->interpolate(iX));
+            }
         }
-    }
+    });
     bg->setXY0(bbox.getMin());
 
     return bg;
@@ -278,16 +278,17 @@ Interpolate::Style lookupMaxInterpStyle(int const n) {
     } else if (n > 4) {
         return Interpolate::AKIMA_SPLINE;
     } else {
-        static std::vector<Interpolate::Style> styles;
-        if (styles.empty()) {
-            styles.resize(5);
+        // initialised once, as this may be called from several threads
+        static std::vector<Interpolate::Style> const styles = []() {
+            std::vector<Interpolate::Style> styles(5);
 
             styles[0] = Interpolate::UNKNOWN;  // impossible to reach as we check for n < 1
             styles[1] = Interpolate::CONSTANT;
             styles[2] = Interpolate::LINEAR;
             styles[3] = Interpolate::CUBIC_SPLINE;
             styles[4] = Interpolate::CUBIC_SPLINE;
-        }
+            return styles;
+        }();
         return styles[n];
     }
 }
@@ -312,9 +313,9 @@ ndarray::Array<double, 1> Interpolate::interpolate(ndarray::Array<double const,
 }
 
 int lookupMinInterpPoints(Interpolate::Style const style) {
-    static std::vector<int> minPoints;
-    if (minPoints.empty()) {
-        minPoints.resize(Interpolate::NUM_STYLES);
+    // initialised once, as this may be called from several threads
+    static std::vector<int> const minPoints = []() {
+        std::vector<int> minPoints(Interpolate::NUM_STYLES);
         minPoints[Interpolate::CONSTANT] = 1;
         minPoints[Interpolate::LINEAR] = 2;
         minPoints[Interpolate::NATURAL_SPLINE] = 3;
@@ -322,7 +323,8 @@ int lookupMinInterpPoints(Interpolate::Style const style) {
         minPoints[Interpolate::CUBIC_SPLINE_PERIODIC] = 3;
         minPoints[Interpolate::AKIMA_SPLINE] = 5;
         minPoints[Interpolate::AKIMA_SPLINE_PERIODIC] = 5;
-    }
+        return minPoints;
+    }();
 
     if (style >= 0 && style < Interpolate::NUM_STYLES) {
         return minPoints[style];
@@ -26,6 +26,7 @@
  * Provide functions to stack images
  *
  */
+#include <algorithm>
 #include <vector>
 #include <cassert>
 #include <memory>
@@ -34,6 +35,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/Stack.h"
 #include "lsst/afw/math/MaskedVector.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -103,55 +105,32 @@ void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> con
  *
  * ************************************************************************** */
 
-//@{
 /**
- * @internal A function to handle MaskedImage stacking
- *
- * A boolean template variable has been used to allow the compiler to generate the different instantiations
- *   to handle cases when we are, or are not, weighting
+ * @internal Compute rows [yBegin, yEnd) of a stack of MaskedImages
  *
- * Additionally, we may or may not want to weight based on the variance -- another template boolean
+ * pixelSet and weights are scratch space, with one element per input image; they are reused for every
+ * pixel.  If useVariance is false, weights must already contain the weights of the images.
  */
 template <typename PixelT, bool isWeighted, bool useVariance>
-void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
-                             std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
-                             Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
-                             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
-                             WeightVector const &wvector = WeightVector()) {
+void computeMaskedImageStackRows(image::MaskedImage<PixelT> &imgStack,
+                                 std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
+                                 int yBegin, int yEnd, Property flags, StatisticsControl const &sctrl,
+                                 image::MaskPixel const clipped,
+                                 std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                                 MaskedVector<PixelT> &pixelSet, WeightVector &weights) {
     // get a list of row_begin iterators
     typedef typename image::MaskedImage<PixelT>::x_iterator x_iterator;
     std::vector<x_iterator> rows;
     rows.reserve(images.size());
 
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
-    WeightVector weights;                          // weights; non-const version
-    //
-    StatisticsControl sctrlTmp(sctrl);
-
-    if (useVariance) {  // weight using the variance image
-        assert(isWeighted);
-        assert(wvector.empty());
-
-        weights.resize(images.size());
-
-        sctrlTmp.setWeighted(true);
-    } else if (isWeighted) {
-        weights.assign(wvector.begin(), wvector.end());
-
-        sctrlTmp.setWeighted(true);
-    }
-    assert(weights.empty() || weights.size() == images.size());
+    Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
 
     // loop over x,y ... the loop over the stack to fill pixelSet
     // - get the stats on pixelSet and put the value in the output image at x,y
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
+    for (int y = yBegin; y != yEnd; ++y) {
+        rows.clear();
         for (unsigned int i = 0; i < images.size(); ++i) {
-            x_iterator ptr = images[i]->row_begin(y);
-            if (y == 0) {
-                rows.push_back(ptr);
-            } else {
-                rows[i] = ptr;
-            }
+            rows.push_back(images[i]->row_begin(y));
         }
 
         for (x_iterator ptr = imgStack.row_begin(y), end = imgStack.row_end(y); ptr != end; ++ptr) {
@@ -164,15 +143,14 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
                 }
             }
 
-            Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
-            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
-                                         : makeStatistics(pixelSet, eflags, sctrlTmp);
+            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrl)
+                                         : makeStatistics(pixelSet, eflags, sctrl);
 
             PixelT variance = ::pow(stat.getError(flags), 2);
             image::MaskPixel msk(stat.getOrMask());
             int const npoint = stat.getValue(NPOINT);
             if (npoint == 0) {
-                msk = sctrlTmp.getNoGoodPixelsMask();
+                msk = sctrl.getNoGoodPixelsMask();
             } else if (npoint == 1) {
                 /*
                  * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
@@ -200,6 +178,62 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
         }
     }
 }
+
+//@{
+/**
+ * @internal A function to handle MaskedImage stacking
+ *
+ * A boolean template variable has been used to allow the compiler to generate the different instantiations
+ *   to handle cases when we are, or are not, weighting
+ *
+ * Additionally, we may or may not want to weight based on the variance -- another template boolean
+ *
+ * The output is divided into bands of rows, which are computed by up to sctrl.getNThreads() threads;
+ * each band has its own scratch space, so the result does not depend on the number of threads.
+ */
+template <typename PixelT, bool isWeighted, bool useVariance>
+void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
+                             std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
+                             Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
+                             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                             WeightVector const &wvector = WeightVector()) {
+    WeightVector weights;  // weights; non-const version
+    //
+    StatisticsControl sctrlTmp(sctrl);
+
+    if (useVariance) {  // weight using the variance image
+        assert(isWeighted);
+        assert(wvector.empty());
+
+        weights.resize(images.size());
+
+        sctrlTmp.setWeighted(true);
+    } else if (isWeighted) {
+        weights.assign(wvector.begin(), wvector.end());
+
+        sctrlTmp.setWeighted(true);
+    }
+    assert(weights.empty() || weights.size() == images.size());
+
+    int const nThreads = detail::resolveNThreads(sctrl.getNThreads());
+    std::vector<int> const bands = detail::computeBandBoundaries(0, imgStack.getHeight(), nThreads);
+    int const nBands = bands.empty() ? 0 : bands.size() - 1;
+
+    // Allocate the scratch space here rather than in the threads, as a MaskedVector's mask
+    // refers to the global mask plane dictionary
+    std::vector<MaskedVector<PixelT>> pixelSets;  // a pixel from x,y for each image, for each band
+    pixelSets.reserve(nBands);
+    for (int band = 0; band < nBands; ++band) {
+        pixelSets.emplace_back(images.size());
+    }
+    std::vector<WeightVector> bandWeights(nBands, weights);
+
+    detail::parallelFor(nBands, nThreads, [&](int band) {
+        computeMaskedImageStackRows<PixelT, isWeighted, useVariance>(
+                imgStack, images, bands[band], bands[band + 1], flags, sctrlTmp, clipped, maskMap,
+                pixelSets[band], bandWeights[band]);
+    });
+}
 template <typename PixelT, bool isWeighted, bool useVariance>
 void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
                              std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
@@ -286,6 +320,40 @@ void statisticsStack(image::MaskedImage<PixelT> &out,
     }
 }
 
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out,
+                     std::vector<MaskedImageBlockReader<PixelT>> const &readers, Property flags,
+                     StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                     int blockHeight) {
+    checkObjectsAndWeights(readers, wvector);
+    checkOnlyOneFlag(flags);
+    if (blockHeight <= 0) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          str(boost::format("blockHeight = %d <= 0") % blockHeight));
+    }
+
+    lsst::geom::Box2I const bbox = out.getBBox();
+    std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> blocks(readers.size());
+    for (int y = bbox.getMinY(); y <= bbox.getMaxY(); y += blockHeight) {
+        int const height = std::min(blockHeight, bbox.getMaxY() - y + 1);
+        lsst::geom::Box2I const blockBBox(lsst::geom::Point2I(bbox.getMinX(), y),
+                                          lsst::geom::Extent2I(bbox.getWidth(), height));
+        // Read in the calling thread: readers (e.g. FITS files or Python callables) need not be thread-safe
+        for (std::size_t i = 0; i < readers.size(); ++i) {
+            blocks[i].reset();  // release the previous block before reading the next
+            blocks[i] = readers[i](blockBBox);
+            if (!blocks[i]) {
+                throw LSST_EXCEPT(pexExcept::RuntimeError,
+                                  str(boost::format("Reader %d returned no image for rows %d-%d") % i %
+                                      blockBBox.getMinY() % blockBBox.getMaxY()));
+            }
+        }
+        image::MaskedImage<PixelT> outBlock(out, blockBBox, image::PARENT);
+        statisticsStack(outBlock, blocks, flags, sctrl, wvector, clipped, maskMap);
+    }
+}
+
 namespace {
 /* ************************************************************************** *
  *
@@ -306,30 +374,39 @@ template <typename PixelT, bool isWeighted>
 void computeImageStack(image::Image<PixelT> &imgStack,
                        std::vector<std::shared_ptr<image::Image<PixelT>>> &images, Property flags,
                        StatisticsControl const &sctrl, WeightVector const &weights = WeightVector()) {
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
     StatisticsControl sctrlTmp(sctrl);
 
-    // set the mask to be an infinite iterator
-    MaskImposter<image::MaskPixel> msk;
-
     if (!weights.empty()) {
         sctrlTmp.setWeighted(true);
     }
 
+    int const nThreads = detail::resolveNThreads(sctrl.getNThreads());
+    std::vector<int> const bands = detail::computeBandBoundaries(0, imgStack.getHeight(), nThreads);
+    int const nBands = bands.empty() ? 0 : bands.size() - 1;
+
+    std::vector<MaskedVector<PixelT>> pixelSets;  // a pixel from x,y for each image, for each band
+    pixelSets.reserve(nBands);
+    for (int band = 0; band < nBands; ++band) {
+        pixelSets.emplace_back(images.size());
+    }
+
     // get the desired statistic
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
-        for (int x = 0; x != imgStack.getWidth(); ++x) {
-            for (unsigned int i = 0; i != images.size(); ++i) {
-                (*pixelSet.getImage())(i, 0) = (*images[i])(x, y);
-            }
+    detail::parallelFor(nBands, nThreads, [&](int band) {
+        MaskedVector<PixelT> &pixelSet = pixelSets[band];
+        for (int y = bands[band]; y != bands[band + 1]; ++y) {
+            for (int x = 0; x != imgStack.getWidth(); ++x) {
+                for (unsigned int i = 0; i != images.size(); ++i) {
+                    (*pixelSet.getImage())(i, 0) = (*images[i])(x, y);
+                }
 
-            if (isWeighted) {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
-            } else {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                if (isWeighted) {
+                    imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                } else {
+                    imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                }
             }
         }
-    }
+    });
 }
 
 }  // end anonymous namespace
@@ -546,6 +623,10 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
             image::MaskedImage<TYPE> & out, std::vector<std::shared_ptr<image::MaskedImage<TYPE>>> & images, \
             Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &);                             \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out, std::vector<MaskedImageBlockReader<TYPE>> const &readers,        \
+            Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int);                        \
     template std::vector<TYPE> statisticsStack<TYPE>(                                       \
             std::vector<std::vector<TYPE>> & vectors, Property flags,                       \
             StatisticsControl const &sctrl, WeightVector const &wvector);                                    \
@@ -25,6 +25,7 @@
 /*
  * Support statistical operations on images
  */
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -33,6 +34,7 @@
 #include <memory>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/Image.h"
@@ -51,6 +53,12 @@ double const NaN = std::numeric_limits<double>::quiet_NaN();
 double const MAX_DOUBLE = std::numeric_limits<double>::max();
 double const IQ_TO_STDEV = 0.741301109252802;  // 1 sigma in units of iqrange (assume Gaussian)
 
+// Parameters for computing quantiles of non-integral images by histogramming (see selectQuantiles)
+int const SELECTION_MIN_PIXELS = 1024;    // smallest image to use it for; copying is as fast below this
+int const SELECTION_PIXELS_PER_BIN = 16;  // number of pixels per histogram bin
+int const SELECTION_MAX_BINS = 1 << 16;   // maximum number of histogram bins
+double const SELECTION_HALF_RANGE = 4.0;  // half-width of the histogram range, in standard deviations
+
 /// @internal A boolean functor which always returns true (for templated conditionals)
 class AlwaysTrue {
 public:
@@ -695,6 +703,119 @@ namespace {
     }
 }
 
+/**
+ * @internal Compute quantiles of the good pixels of an image without copying all of them
+ *
+ * The good (finite and unmasked) pixels are histogrammed over [lo, hi), with pixels outside that
+ * range counted in the first or last bin, and only the pixels in the bins containing the needed ranks
+ * are copied and partially sorted.  As the bin is a non-decreasing function of the pixel value, the
+ * values found are exactly those that std::nth_element finds in a copy of all the good pixels, and the
+ * quantiles are interpolated as in percentile(); the range only affects the speed.
+ *
+ * @param img        an afw::Image
+ * @param msk        mask
+ * @param andMask    mask of bad pixels
+ * @param lo         minimum of the histogram range
+ * @param hi         maximum of the histogram range; must be > lo
+ * @param fractions  the desired quantiles
+ *
+ * Only for non-integral types; for integral types, percentile() and medianAndQuartiles() handle ties.
+ */
+template <typename ImageT, typename MaskT>
+std::vector<double> selectQuantiles(ImageT const &img, MaskT const &msk, int const andMask, double const lo,
+                                    double const hi, std::vector<double> const &fractions) {
+    assert(hi > lo);
+    int const nPix = img.getWidth() * img.getHeight();
+    int const nBins = std::max(1, std::min(nPix / SELECTION_PIXELS_PER_BIN, SELECTION_MAX_BINS));
+    double const scale = nBins / (hi - lo);
+    auto binOf = [lo, scale, nBins](double const value) {
+        double const bin = (value - lo) * scale;
+        return (bin <= 0) ? 0 : ((bin >= nBins) ? nBins - 1 : static_cast<int>(bin));
+    };
+
+    // start[i] is the number of good pixels in bins < i
+    std::vector<int> start(nBins + 1, 0);
+    for (int iY = 0; iY < img.getHeight(); ++iY) {
+        typename MaskT::x_iterator mptr = msk.row_begin(iY);
+        for (typename ImageT::x_iterator ptr = img.row_begin(iY), end = img.row_end(iY); ptr != end;
+             ++ptr, ++mptr) {
+            if (CheckFinite()(*ptr) && !(*mptr & andMask)) {
+                ++start[binOf(*ptr) + 1];
+            }
+        }
+    }
+    for (int bin = 0; bin < nBins; ++bin) {
+        start[bin + 1] += start[bin];
+    }
+    int const n = start[nBins];
+
+    std::vector<double> result(fractions.size(), NaN);
+    if (n == 0) {
+        return result;
+    }
+
+    // the ranks of the values on either side of each quantile, and the bins containing them
+    std::vector<int> ranks;
+    std::vector<int> rankBins;
+    std::vector<int> offsets(nBins, -1);  // offset of each needed bin in selected; -1 if not needed
+    for (double const fraction : fractions) {
+        int const q1 = static_cast<int>(fraction * (n - 1));
+        for (int const rank : {q1, std::min(q1 + 1, n - 1)}) {
+            int const bin = std::upper_bound(start.begin(), start.end(), rank) - start.begin() - 1;
+            ranks.push_back(rank);
+            rankBins.push_back(bin);
+            offsets[bin] = 0;
+        }
+    }
+    int nSelected = 0;
+    for (int bin = 0; bin < nBins; ++bin) {
+        if (offsets[bin] >= 0) {
+            offsets[bin] = nSelected;
+            nSelected += start[bin + 1] - start[bin];
+        }
+    }
+
+    // copy the pixels in the needed bins, grouped by bin
+    std::vector<typename ImageT::Pixel> selected(nSelected);
+    std::vector<int> cursors(offsets);
+    for (int iY = 0; iY < img.getHeight(); ++iY) {
+        typename MaskT::x_iterator mptr = msk.row_begin(iY);
+        for (typename ImageT::x_iterator ptr = img.row_begin(iY), end = img.row_end(iY); ptr != end;
+             ++ptr, ++mptr) {
+            if (CheckFinite()(*ptr) && !(*mptr & andMask)) {
+                int &cursor = cursors[binOf(*ptr)];
+                if (cursor >= 0) {
+                    selected[cursor++] = *ptr;
+                }
+            }
+        }
+    }
+
+    std::vector<double> values(ranks.size());
+    for (std::size_t i = 0; i < ranks.size(); ++i) {
+        int const bin = rankBins[i];
+        auto begin = selected.begin() + offsets[bin];
+        auto nth = begin + (ranks[i] - start[bin]);
+        std::nth_element(begin, nth, begin + (start[bin + 1] - start[bin]));
+        values[i] = static_cast<double>(*nth);
+    }
+
+    // interpolate linearly between the adjacent values
+    for (std::size_t i = 0; i < fractions.size(); ++i) {
+        if (n == 1) {
+            result[i] = values[2 * i];
+        } else {
+            double const idx = fractions[i] * (n - 1);
+            int const q1 = static_cast<int>(idx);
+            int const q2 = q1 + 1;
+            double w1 = (static_cast<double>(q2) - idx);
+            double w2 = (idx - static_cast<double>(q1));
+            result[i] = w1 * values[2 * i] + w2 * values[2 * i + 1];
+        }
+    }
+    return result;
+}
+
 /**
  * @internal A function to copy an image into a vector
  *
@@ -884,23 +1005,42 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
         _nMasked = num - _n;
     }
 
-    // copy the image for any routines that will use median or quantiles
+    // get the median and quartiles for any routines that will use them
     if (flags & (MEDIAN | IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
-        // make a vector copy of the image to get the median and quartiles (will move values)
-        std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
-        if (_sctrl.getNanSafe()) {
-            imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
+        // if we *only* want the median, don't compute the quartiles
+        bool const onlyMedian =
+                (flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP));
+
+        // For large non-integral images, histogram the values about the mean rather than copying them
+        double const halfRange = SELECTION_HALF_RANGE * std::sqrt(_variance.first);
+        if (!std::is_integral<typename ImageT::Pixel>::value && _sctrl.getNanSafe() &&
+            num >= SELECTION_MIN_PIXELS && std::isfinite(_mean.first) && std::isfinite(halfRange) &&
+            halfRange > 0) {
+            std::vector<double> const fractions =
+                    onlyMedian ? std::vector<double>{0.5} : std::vector<double>{0.5, 0.25, 0.75};
+            std::vector<double> const quantiles =
+                    selectQuantiles(img, msk, _sctrl.getAndMask(), _mean.first - halfRange,
+                                    _mean.first + halfRange, fractions);
+            _median = Value(quantiles[0], NaN);
+            if (!onlyMedian) {
+                _iqrange = quantiles[2] - quantiles[1];
+            }
         } else {
-            imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
-        }
+            // make a vector copy of the image to get the median and quartiles (will move values)
+            std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
+            if (_sctrl.getNanSafe()) {
+                imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
+            } else {
+                imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
+            }
 
-        // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
-        if ((flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP))) {
-            _median = Value(percentile(*imgcp, 0.5), NaN);
-        } else {
-            MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
-            _median = Value(std::get<0>(mq), NaN);
-            _iqrange = std::get<2>(mq) - std::get<1>(mq);
+            if (onlyMedian) {
+                _median = Value(percentile(*imgcp, 0.5), NaN);
+            } else {
+                MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
+                _median = Value(std::get<0>(mq), NaN);
+                _iqrange = std::get<2>(mq) - std::get<1>(mq);
+            }
         }
 
         if (flags & (MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
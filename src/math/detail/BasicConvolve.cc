@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdint>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 #include "lsst/pex/exceptions.h"
@@ -38,6 +39,8 @@
 #include "lsst/afw/math/ConvolveImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/ConvolveRows.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -131,6 +134,150 @@ inline OutPixelT kernelDotProduct(
     }
     return outPixel;
 }
+
+/**
+ * @internal Make one copy of a kernel for each band of a threaded convolution
+ *
+ * Evaluating a spatially varying kernel modifies cached state in the kernel,
+ * so concurrently processed bands must each have their own copy.
+ * The copies are made by the calling thread.
+ *
+ * @param kernel kernel to copy
+ * @param nBands number of bands
+ * @returns one copy per band, or an empty list if nBands <= 1, in which case kernel may be used directly
+ */
+std::vector<std::shared_ptr<lsst::afw::math::Kernel>> makeBandKernels(lsst::afw::math::Kernel const& kernel,
+                                                                       int nBands) {
+    std::vector<std::shared_ptr<lsst::afw::math::Kernel>> bandKernels;
+    if (nBands > 1) {
+        bandKernels.reserve(nBands);
+        for (int band = 0; band < nBands; ++band) {
+            bandKernels.push_back(kernel.clone());
+        }
+    }
+    return bandKernels;
+}
+
+/**
+ * @internal Convolve a band of rows with a spatially invariant kernel image using vectorized row dot products
+ *
+ * This generic version handles pixel types for which vectorized dot products are not available;
+ * it does nothing and returns false, so the caller must do the convolution itself.
+ *
+ * @returns true if the band was convolved
+ */
+template <typename OutImageT, typename InImageT>
+bool convolveRowsWithKernelImage(OutImageT& convolvedImage, InImageT const& inImage,
+                                 lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> const& kernelImage,
+                                 int cnvStartX, int cnvWidth, int cnvStartY, int cnvYBegin, int cnvYEnd) {
+    return false;
+}
+
+/**
+ * @internal Convolve a band of rows with a spatially invariant kernel image using vectorized row dot products
+ *
+ * @param[out] convolvedImage convolved image
+ * @param[in] inImage image to convolve
+ * @param[in] kernelImage kernel image
+ * @param[in] cnvStartX x index of first good output column
+ * @param[in] cnvWidth number of good output columns
+ * @param[in] cnvStartY y index of first good output row
+ * @param[in] cnvYBegin y index of first output row of band
+ * @param[in] cnvYEnd y index of last output row of band + 1
+ * @returns true
+ */
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<lsst::afw::math::detail::IsConvolveRowsType<OutPixelT, InPixelT>::value, bool>::type
+convolveRowsWithKernelImage(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                            lsst::afw::image::Image<InPixelT> const& inImage,
+                            lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> const& kernelImage,
+                            int cnvStartX, int cnvWidth, int cnvStartY, int cnvYBegin, int cnvYEnd) {
+    auto const cnvArray = convolvedImage.getArray();
+    auto const inArray = inImage.getArray();
+    auto const kernelArray = kernelImage.getArray();
+    int const kWidth = kernelImage.getWidth();
+    for (int cnvY = cnvYBegin; cnvY < cnvYEnd; ++cnvY) {
+        int const inStartY = cnvY - cnvStartY;
+        OutPixelT* const cnvRow = cnvArray[cnvY].getData() + cnvStartX;
+        for (int kernelY = 0; kernelY < kernelImage.getHeight(); ++kernelY) {
+            lsst::afw::math::detail::rowDotProducts(cnvRow, inArray[inStartY + kernelY].getData(),
+                                                    kernelArray[kernelY].getData(), kWidth, cnvWidth,
+                                                    kernelY > 0);
+        }
+    }
+    return true;
+}
+
+/**
+ * @internal Convolve a band of rows with a spatially invariant separable kernel using vectorized dot products
+ *
+ * This generic version handles pixel types for which vectorized dot products are not available;
+ * it does nothing and returns false, so the caller must do the convolution itself.
+ *
+ * @returns true if the band was convolved
+ */
+template <typename OutImageT, typename InImageT>
+bool convolveRowsWithSeparableKernel(OutImageT& convolvedImage, InImageT const& inImage,
+                                     std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                                     std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec,
+                                     lsst::geom::Box2I const& goodBBox, int bandStart, int bandEnd) {
+    return false;
+}
+
+/**
+ * @internal Convolve a band of rows with a spatially invariant separable kernel using vectorized dot products
+ *
+ * The sequence of operations is the same as in the generic SeparableKernel basicConvolve,
+ * and so is the result: each row of input is convolved with the kernel x vector into a circular buffer,
+ * then each column of the buffer is dotted with the (rotated) kernel y vector to compute a row of output.
+ *
+ * @param[out] convolvedImage convolved image
+ * @param[in] inImage image to convolve
+ * @param[in] kernelXVec kernel x vector
+ * @param[in] kernelYVec kernel y vector
+ * @param[in] goodBBox good region of convolvedImage
+ * @param[in] bandStart offset of first row of band from first good row
+ * @param[in] bandEnd offset of last row of band + 1 from first good row
+ * @returns true
+ */
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<lsst::afw::math::detail::IsConvolveRowsType<OutPixelT, InPixelT>::value, bool>::type
+convolveRowsWithSeparableKernel(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                                lsst::afw::image::Image<InPixelT> const& inImage,
+                                std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                                std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec,
+                                lsst::geom::Box2I const& goodBBox, int bandStart, int bandEnd) {
+    int const kWidth = static_cast<int>(kernelXVec.size());
+    int const kHeight = static_cast<int>(kernelYVec.size());
+    int const goodWidth = goodBBox.getWidth();
+    auto const cnvArray = convolvedImage.getArray();
+    auto const inArray = inImage.getArray();
+
+    // circular buffer for x-convolved data, as in basicConvolve
+    std::vector<OutPixelT> buffer(static_cast<std::size_t>(goodWidth) * kHeight);
+    std::vector<OutPixelT const*> bufferRows(kHeight);
+    for (int bufY = 0; bufY < kHeight; ++bufY) {
+        bufferRows[bufY] = buffer.data() + static_cast<std::size_t>(goodWidth) * bufY;
+    }
+    std::vector<lsst::afw::math::Kernel::Pixel> rotatedKernelYVec(kernelYVec);
+
+    for (int bufY = 0; bufY < kHeight - 1; ++bufY) {
+        lsst::afw::math::detail::rowDotProducts(buffer.data() + static_cast<std::size_t>(goodWidth) * bufY,
+                                                inArray[bandStart + bufY].getData(), kernelXVec.data(),
+                                                kWidth, goodWidth, false);
+    }
+    for (int offset = bandStart, bufY = kHeight - 1; offset < bandEnd; ++offset) {
+        lsst::afw::math::detail::rowDotProducts(buffer.data() + static_cast<std::size_t>(goodWidth) * bufY,
+                                                inArray[offset + kHeight - 1].getData(), kernelXVec.data(),
+                                                kWidth, goodWidth, false);
+        lsst::afw::math::detail::columnDotProducts(
+                cnvArray[goodBBox.getMinY() + offset].getData() + goodBBox.getMinX(), bufferRows.data(),
+                rotatedKernelYVec.data(), kHeight, goodWidth, false);
+        bufY = (bufY + 1) % kHeight;
+        std::rotate(rotatedKernelYVec.begin(), rotatedKernelYVec.end() - 1, rotatedKernelYVec.end());
+    }
+    return true;
+}
 }  // anonymous namespace
 
 namespace lsst {
@@ -165,7 +312,11 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Ker
         return;
     }
     // OK, use general (and slower) form
-    if (kernel.isSpatiallyVarying() && (convolutionControl.getMaxInterpolationDistance() > 1)) {
+    if (canConvolveWithFft(convolvedImage, inImage, kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve", "generic basicConvolve: using FFT");
+        assertDimensionsOK(convolvedImage, inImage, kernel);
+        convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (kernel.isSpatiallyVarying() && (convolutionControl.getMaxInterpolationDistance() > 1)) {
         // use linear interpolation
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "generic basicConvolve: using linear interpolation");
@@ -196,25 +347,34 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
 
     LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve", "DeltaFunctionKernel basicConvolve");
 
-    for (int i = 0; i < cnvHeight; ++i) {
-        typename InImageT::x_iterator inPtr = inImage.x_at(inStartX, i + inStartY);
-        for (typename OutImageT::x_iterator cnvPtr = convolvedImage.x_at(cnvStartX, i + cnvStartY),
-                                            cnvEnd = cnvPtr + cnvWidth;
-             cnvPtr != cnvEnd; ++cnvPtr, ++inPtr) {
-            *cnvPtr = *inPtr;
+    int const nThreads = resolveNThreads(convolutionControl.getNThreads());
+    std::vector<int> const bands = computeBandBoundaries(0, cnvHeight, nThreads);
+    parallelFor(static_cast<int>(bands.size()) - 1, nThreads, [&](int band) {
+        for (int i = bands[band]; i < bands[band + 1]; ++i) {
+            typename InImageT::x_iterator inPtr = inImage.x_at(inStartX, i + inStartY);
+            for (typename OutImageT::x_iterator cnvPtr = convolvedImage.x_at(cnvStartX, i + cnvStartY),
+                                                cnvEnd = cnvPtr + cnvWidth;
+                 cnvPtr != cnvEnd; ++cnvPtr, ++inPtr) {
+                *cnvPtr = *inPtr;
+            }
         }
-    }
+    });
 }
 
 template <typename OutImageT, typename InImageT>
 void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
                    math::LinearCombinationKernel const& kernel,
                    math::ConvolutionControl const& convolutionControl) {
-    if (!kernel.isSpatiallyVarying()) {
+    if (canConvolveWithFft(convolvedImage, inImage, kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: spatially invariant; using FFT");
+        assertDimensionsOK(convolvedImage, inImage, kernel);
+        return convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (!kernel.isSpatiallyVarying()) {
         // use the standard algorithm for the spatially invariant case
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "basicConvolve for LinearCombinationKernel: spatially invariant; using brute force");
-        return convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl.getDoNormalize());
+        return convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl);
     } else {
         // refactor the kernel if this is reasonable and possible;
         // then use the standard algorithm for the spatially varying case
@@ -237,8 +397,7 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
             LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                        "basicConvolve for LinearCombinationKernel: maxInterpolationError < 0; using brute "
                        "force");
-            return convolveWithBruteForce(convolvedImage, inImage, *refKernelPtr,
-                                          convolutionControl.getDoNormalize());
+            return convolveWithBruteForce(convolvedImage, inImage, *refKernelPtr, convolutionControl);
         }
     }
 }
@@ -260,32 +419,43 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
     lsst::geom::Box2I const fullBBox = inImage.getBBox(image::LOCAL);
     lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(fullBBox);
 
-    KernelVector kernelXVec(kernel.getWidth());
-    KernelVector kernelYVec(kernel.getHeight());
+    int const nThreads = resolveNThreads(convolutionControl.getNThreads());
 
     if (kernel.isSpatiallyVarying()) {
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "SeparableKernel basicConvolve: kernel is spatially varying");
 
-        for (int cnvY = goodBBox.getMinY(); cnvY <= goodBBox.getMaxY(); ++cnvY) {
-            double const rowPos = inImage.indexToPosition(cnvY, image::Y);
-
-            InXYLocator inImLoc = inImage.xy_at(0, cnvY - goodBBox.getMinY());
-            OutXIterator cnvXIter = convolvedImage.row_begin(cnvY) + goodBBox.getMinX();
-            for (int cnvX = goodBBox.getMinX(); cnvX <= goodBBox.getMaxX();
-                 ++cnvX, ++inImLoc.x(), ++cnvXIter) {
-                double const colPos = inImage.indexToPosition(cnvX, image::X);
-
-                KernelPixel kSum = kernel.computeVectors(kernelXVec, kernelYVec,
-                                                         convolutionControl.getDoNormalize(), colPos, rowPos);
-
-                // why does this trigger warnings? It did not in the past.
-                *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelXVec, kernelYVec);
-                if (convolutionControl.getDoNormalize()) {
-                    *cnvXIter = *cnvXIter / kSum;
+        std::vector<int> const bands =
+                computeBandBoundaries(goodBBox.getMinY(), goodBBox.getMaxY() + 1, nThreads);
+        int const nBands = static_cast<int>(bands.size()) - 1;
+        auto const bandKernels = makeBandKernels(kernel, nBands);
+        parallelFor(nBands, nThreads, [&](int band) {
+            math::SeparableKernel const& bandKernel =
+                    bandKernels.empty() ? kernel
+                                        : static_cast<math::SeparableKernel const&>(*bandKernels[band]);
+            KernelVector kernelXVec(kernel.getWidth());
+            KernelVector kernelYVec(kernel.getHeight());
+
+            for (int cnvY = bands[band]; cnvY < bands[band + 1]; ++cnvY) {
+                double const rowPos = inImage.indexToPosition(cnvY, image::Y);
+
+                InXYLocator inImLoc = inImage.xy_at(0, cnvY - goodBBox.getMinY());
+                OutXIterator cnvXIter = convolvedImage.row_begin(cnvY) + goodBBox.getMinX();
+                for (int cnvX = goodBBox.getMinX(); cnvX <= goodBBox.getMaxX();
+                     ++cnvX, ++inImLoc.x(), ++cnvXIter) {
+                    double const colPos = inImage.indexToPosition(cnvX, image::X);
+
+                    KernelPixel kSum = bandKernel.computeVectors(
+                            kernelXVec, kernelYVec, convolutionControl.getDoNormalize(), colPos, rowPos);
+
+                    // why does this trigger warnings? It did not in the past.
+                    *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelXVec, kernelYVec);
+                    if (convolutionControl.getDoNormalize()) {
+                        *cnvXIter = *cnvXIter / kSum;
+                    }
                 }
             }
-        }
+        });
     } else {
         // kernel is spatially invariant
         // The basic sequence:
@@ -295,60 +465,82 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
         // The x-convolved data is stored in a kernel-height by good-width buffer.
         // This is circular buffer along y (to avoid shifting pixels before setting each new row);
         // so for each new row the kernel y vector is rotated to match the order of the x-convolved data.
+        //
+        // When threaded, each band of output rows has its own buffer. Bands start a multiple of
+        // the kernel height after the first good row, so the buffer and kernel y vector start
+        // in the same phase as for a serial convolution and the sums are computed in the same order.
 
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "SeparableKernel basicConvolve: kernel is spatially invariant");
 
-        kernel.computeVectors(kernelXVec, kernelYVec, convolutionControl.getDoNormalize());
+        KernelVector kernelXVec(kernel.getWidth());
+        KernelVector initialKernelYVec(kernel.getHeight());
+        kernel.computeVectors(kernelXVec, initialKernelYVec, convolutionControl.getDoNormalize());
         KernelIterator const kernelXVecBegin = kernelXVec.begin();
-        KernelIterator const kernelYVecBegin = kernelYVec.begin();
-
-        // buffer for x-convolved data
-        OutImageT buffer(lsst::geom::Extent2I(goodBBox.getWidth(), kernel.getHeight()));
-
-        // pre-fill x-convolved data buffer with all but one row of data
-        int yInd = 0;  // during initial fill bufY = inImageY
-        int const yPrefillEnd = buffer.getHeight() - 1;
-        for (; yInd < yPrefillEnd; ++yInd) {
-            OutXIterator bufXIter = buffer.x_at(0, yInd);
-            OutXIterator const bufXEnd = buffer.x_at(goodBBox.getWidth(), yInd);
-            InXIterator inXIter = inImage.x_at(0, yInd);
-            for (; bufXIter != bufXEnd; ++bufXIter, ++inXIter) {
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
+
+        std::vector<int> const bands = computeBandBoundaries(0, goodBBox.getHeight(), nThreads,
+                                                             kernel.getHeight());
+        parallelFor(static_cast<int>(bands.size()) - 1, nThreads, [&](int band) {
+            int const bandStart = bands[band];  // offset of first row of band from first good row
+            int const bandEnd = bands[band + 1];
+
+            // use vectorized dot products if the pixel types support them
+            if (convolveRowsWithSeparableKernel(convolvedImage, inImage, kernelXVec, initialKernelYVec,
+                                                goodBBox, bandStart, bandEnd)) {
+                return;
             }
-        }
 
-        // compute output pixels using the sequence described above
-        int inY = yPrefillEnd;
-        int bufY = yPrefillEnd;
-        int cnvY = goodBBox.getMinY();
-        while (true) {
-            // fill next buffer row and compute output row
-            InXIterator inXIter = inImage.x_at(0, inY);
-            OutXIterator bufXIter = buffer.x_at(0, bufY);
-            OutXIterator cnvXIter = convolvedImage.x_at(goodBBox.getMinX(), cnvY);
-            for (int bufX = 0; bufX < goodBBox.getWidth(); ++bufX, ++cnvXIter, ++bufXIter, ++inXIter) {
-                // note: bufXIter points to the row of the buffer that is being updated,
-                // whereas bufYIter points to row 0 of the buffer
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
-
-                OutYIterator bufYIter = buffer.y_at(bufX, 0);
-                *cnvXIter = kernelDotProduct<OutPixel, OutYIterator, KernelIterator, KernelPixel>(
-                        bufYIter, kernelYVecBegin, kernel.getHeight());
+            KernelVector kernelYVec(initialKernelYVec);
+            KernelIterator const kernelYVecBegin = kernelYVec.begin();
+
+            // buffer for x-convolved data
+            OutImageT buffer(lsst::geom::Extent2I(goodBBox.getWidth(), kernel.getHeight()));
+
+            // pre-fill x-convolved data buffer with all but one row of data
+            int yInd = 0;  // during initial fill bufY = inImageY - bandStart
+            int const yPrefillEnd = buffer.getHeight() - 1;
+            for (; yInd < yPrefillEnd; ++yInd) {
+                OutXIterator bufXIter = buffer.x_at(0, yInd);
+                OutXIterator const bufXEnd = buffer.x_at(goodBBox.getWidth(), yInd);
+                InXIterator inXIter = inImage.x_at(0, bandStart + yInd);
+                for (; bufXIter != bufXEnd; ++bufXIter, ++inXIter) {
+                    *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
+                            inXIter, kernelXVecBegin, kernel.getWidth());
+                }
             }
 
-            // test for done now, instead of the start of the loop,
-            // to avoid an unnecessary extra rotation of the kernel Y vector
-            if (cnvY >= goodBBox.getMaxY()) break;
+            // compute output pixels using the sequence described above
+            int inY = bandStart + yPrefillEnd;
+            int bufY = yPrefillEnd;
+            int cnvY = goodBBox.getMinY() + bandStart;
+            int const cnvEndY = goodBBox.getMinY() + bandEnd;  // end index + 1
+            while (true) {
+                // fill next buffer row and compute output row
+                InXIterator inXIter = inImage.x_at(0, inY);
+                OutXIterator bufXIter = buffer.x_at(0, bufY);
+                OutXIterator cnvXIter = convolvedImage.x_at(goodBBox.getMinX(), cnvY);
+                for (int bufX = 0; bufX < goodBBox.getWidth(); ++bufX, ++cnvXIter, ++bufXIter, ++inXIter) {
+                    // note: bufXIter points to the row of the buffer that is being updated,
+                    // whereas bufYIter points to row 0 of the buffer
+                    *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
+                            inXIter, kernelXVecBegin, kernel.getWidth());
+
+                    OutYIterator bufYIter = buffer.y_at(bufX, 0);
+                    *cnvXIter = kernelDotProduct<OutPixel, OutYIterator, KernelIterator, KernelPixel>(
+                            bufYIter, kernelYVecBegin, kernel.getHeight());
+                }
 
-            // update y indices, including bufY, and rotate the kernel y vector to match
-            ++inY;
-            bufY = (bufY + 1) % kernel.getHeight();
-            ++cnvY;
-            std::rotate(kernelYVec.begin(), kernelYVec.end() - 1, kernelYVec.end());
-        }
+                // test for done now, instead of the start of the loop,
+                // to avoid an unnecessary extra rotation of the kernel Y vector
+                if (cnvY >= cnvEndY - 1) break;
+
+                // update y indices, including bufY, and rotate the kernel y vector to match
+                ++inY;
+                bufY = (bufY + 1) % kernel.getHeight();
+                ++cnvY;
+                std::rotate(kernelYVec.begin(), kernelYVec.end() - 1, kernelYVec.end());
+            }
+        });
     }
 }
 
@@ -380,52 +572,71 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
     int const cnvEndX = cnvStartX + cnvWidth;   // end index + 1
     int const cnvEndY = cnvStartY + cnvHeight;  // end index + 1
 
-    KernelImage kernelImage(kernel.getDimensions());
-    KernelXYLocator const kernelLoc = kernelImage.xy_at(0, 0);
+    int const nThreads = resolveNThreads(convolutionControl.getNThreads());
+    std::vector<int> const bands = computeBandBoundaries(cnvStartY, cnvEndY, nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
 
     if (kernel.isSpatiallyVarying()) {
         LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithBruteForce",
                    "convolveWithBruteForce: kernel is spatially varying");
 
-        for (int cnvY = cnvStartY; cnvY != cnvEndY; ++cnvY) {
-            double const rowPos = inImage.indexToPosition(cnvY, image::Y);
+        auto const bandKernels = makeBandKernels(kernel, nBands);
+        parallelFor(nBands, nThreads, [&](int band) {
+            math::Kernel const& bandKernel = bandKernels.empty() ? kernel : *bandKernels[band];
+            KernelImage kernelImage(kernel.getDimensions());
+            KernelXYLocator const kernelLoc = kernelImage.xy_at(0, 0);
 
-            InXYLocator inImLoc = inImage.xy_at(0, cnvY - cnvStartY);
-            OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
-            for (int cnvX = cnvStartX; cnvX != cnvEndX; ++cnvX, ++inImLoc.x(), ++cnvXIter) {
-                double const colPos = inImage.indexToPosition(cnvX, image::X);
+            for (int cnvY = bands[band]; cnvY != bands[band + 1]; ++cnvY) {
+                double const rowPos = inImage.indexToPosition(cnvY, image::Y);
 
-                KernelPixel kSum = kernel.computeImage(kernelImage, false, colPos, rowPos);
-                *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelLoc, kWidth, kHeight);
-                if (doNormalize) {
-                    *cnvXIter = *cnvXIter / kSum;
+                InXYLocator inImLoc = inImage.xy_at(0, cnvY - cnvStartY);
+                OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
+                for (int cnvX = cnvStartX; cnvX != cnvEndX; ++cnvX, ++inImLoc.x(), ++cnvXIter) {
+                    double const colPos = inImage.indexToPosition(cnvX, image::X);
+
+                    KernelPixel kSum = bandKernel.computeImage(kernelImage, false, colPos, rowPos);
+                    *cnvXIter =
+                            math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelLoc, kWidth, kHeight);
+                    if (doNormalize) {
+                        *cnvXIter = *cnvXIter / kSum;
+                    }
                 }
             }
-        }
+        });
     } else {
         LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithBruteForce",
                    "convolveWithBruteForce: kernel is spatially invariant");
 
+        KernelImage kernelImage(kernel.getDimensions());
         (void)kernel.computeImage(kernelImage, doNormalize);
 
-        for (int inStartY = 0, cnvY = cnvStartY; inStartY < cnvHeight; ++inStartY, ++cnvY) {
-            KernelXIterator kernelXIter = kernelImage.x_at(0, 0);
-            InXIterator inXIter = inImage.x_at(0, inStartY);
-            OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
-            for (int x = 0; x < cnvWidth; ++x, ++cnvXIter, ++inXIter) {
-                *cnvXIter = kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
-                        inXIter, kernelXIter, kWidth);
+        // the kernel image is only read, so all bands share it
+        parallelFor(nBands, nThreads, [&](int band) {
+            // use vectorized dot products if the pixel types support them
+            if (convolveRowsWithKernelImage(convolvedImage, inImage, kernelImage, cnvStartX, cnvWidth,
+                                            cnvStartY, bands[band], bands[band + 1])) {
+                return;
             }
-            for (int kernelY = 1, inY = inStartY + 1; kernelY < kHeight; ++inY, ++kernelY) {
-                KernelXIterator kernelXIter = kernelImage.x_at(0, kernelY);
-                InXIterator inXIter = inImage.x_at(0, inY);
+            for (int cnvY = bands[band], inStartY = cnvY - cnvStartY; cnvY < bands[band + 1];
+                 ++inStartY, ++cnvY) {
+                KernelXIterator kernelXIter = kernelImage.x_at(0, 0);
+                InXIterator inXIter = inImage.x_at(0, inStartY);
                 OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
                 for (int x = 0; x < cnvWidth; ++x, ++cnvXIter, ++inXIter) {
-                    *cnvXIter += kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
+                    *cnvXIter = kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
                             inXIter, kernelXIter, kWidth);
                 }
+                for (int kernelY = 1, inY = inStartY + 1; kernelY < kHeight; ++inY, ++kernelY) {
+                    KernelXIterator kernelXIter = kernelImage.x_at(0, kernelY);
+                    InXIterator inXIter = inImage.x_at(0, inY);
+                    OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
+                    for (int x = 0; x < cnvWidth; ++x, ++cnvXIter, ++inXIter) {
+                        *cnvXIter += kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
+                                inXIter, kernelXIter, kWidth);
+                    }
+                }
             }
-        }
+        });
     }
 }
 
@@ -0,0 +1,312 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Definition of the vectorized convolution inner loops declared in detail/ConvolveRows.h
+ *
+ * The SIMD versions are compiled with per-function target attributes, so this file needs no special
+ * compiler flags, and the instruction set is chosen at run time from what the CPU supports.
+ * Every SIMD version computes each output pixel using the same operations, in the same order,
+ * as the scalar version: multiply in double precision, round to the output type, accumulate
+ * in the output type. Fused multiply-add must not be used, as it would change the rounding.
+ */
+#include <atomic>
+#include <vector>
+
+#include "lsst/afw/math/detail/ConvolveRows.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LSST_AFW_CONVOLVE_ROWS_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef LSST_AFW_CONVOLVE_ROWS_X86
+#if defined(__clang__)
+// clang does not contract separate intrinsic calls into fused multiply-adds
+#define LSST_AFW_TARGET(ISA) __attribute__((target(ISA)))
+#else
+#define LSST_AFW_TARGET(ISA) __attribute__((target(ISA), optimize("fp-contract=off")))
+// the optimize attribute makes gcc warn spuriously about the "undefined" vectors used inside intrinsics
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+namespace {
+
+enum class InstructionSet { SCALAR, AVX2, AVX512 };
+
+InstructionSet detectInstructionSet() {
+#ifdef LSST_AFW_CONVOLVE_ROWS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+InstructionSet getSupportedInstructionSet() {
+    static InstructionSet const supported = detectInstructionSet();
+    return supported;
+}
+
+std::atomic<bool> simdEnabled(true);
+
+InstructionSet getInstructionSet() {
+    return simdEnabled ? getSupportedInstructionSet() : InstructionSet::SCALAR;
+}
+
+/*
+ * Compute out[i] (+)= sum over k of (OutPixelT)(rows[k][i] * kernel[k]) for i in [begin, end)
+ */
+template <typename OutPixelT, typename InPixelT>
+void dotProductsScalar(OutPixelT* out, InPixelT const* const* rows, double const* kernel, int kSize,
+                       int begin, int end, bool doAdd) {
+    for (int i = begin; i < end; ++i) {
+        OutPixelT sum(0);
+        for (int k = 0; k < kSize; ++k) {
+            double const kVal = kernel[k];
+            if (kVal != 0) {
+                sum += static_cast<OutPixelT>(rows[k][i] * kVal);
+            }
+        }
+        out[i] = doAdd ? out[i] + sum : sum;
+    }
+}
+
+#ifdef LSST_AFW_CONVOLVE_ROWS_X86
+
+/*
+ * SIMD versions: each handles as many whole vectors as it can and returns the index of the first
+ * output pixel it did not compute; the caller finishes the row with dotProductsScalar.
+ *
+ * Zero kernel values are skipped, as in the scalar version; this matters when the input contains
+ * non-finite values and for the sign of zero.
+ */
+
+LSST_AFW_TARGET("avx2")
+int dotProductsAvx2(float* out, float const* const* rows, double const* kernel, int kSize, int n,
+                    bool doAdd) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m256d const kVal = _mm256_set1_pd(kernel[k]);
+                __m256d const inLo = _mm256_cvtps_pd(_mm_loadu_ps(rows[k] + i));
+                __m256d const inHi = _mm256_cvtps_pd(_mm_loadu_ps(rows[k] + i + 4));
+                __m128 const lo = _mm256_cvtpd_ps(_mm256_mul_pd(inLo, kVal));
+                __m128 const hi = _mm256_cvtpd_ps(_mm256_mul_pd(inHi, kVal));
+                sum = _mm256_add_ps(sum, _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+            }
+        }
+        if (doAdd) {
+            sum = _mm256_add_ps(_mm256_loadu_ps(out + i), sum);
+        }
+        _mm256_storeu_ps(out + i, sum);
+    }
+    return i;
+}
+
+LSST_AFW_TARGET("avx2")
+int dotProductsAvx2(double* out, float const* const* rows, double const* kernel, int kSize, int n,
+                    bool doAdd) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m256d const in = _mm256_cvtps_pd(_mm_loadu_ps(rows[k] + i));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(in, _mm256_set1_pd(kernel[k])));
+            }
+        }
+        if (doAdd) {
+            sum = _mm256_add_pd(_mm256_loadu_pd(out + i), sum);
+        }
+        _mm256_storeu_pd(out + i, sum);
+    }
+    return i;
+}
+
+LSST_AFW_TARGET("avx2")
+int dotProductsAvx2(double* out, double const* const* rows, double const* kernel, int kSize, int n,
+                    bool doAdd) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m256d const in = _mm256_loadu_pd(rows[k] + i);
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(in, _mm256_set1_pd(kernel[k])));
+            }
+        }
+        if (doAdd) {
+            sum = _mm256_add_pd(_mm256_loadu_pd(out + i), sum);
+        }
+        _mm256_storeu_pd(out + i, sum);
+    }
+    return i;
+}
+
+LSST_AFW_TARGET("avx512f")
+int dotProductsAvx512(float* out, float const* const* rows, double const* kernel, int kSize, int n,
+                      bool doAdd) {
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 sum = _mm512_setzero_ps();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m512d const kVal = _mm512_set1_pd(kernel[k]);
+                __m512d const inLo = _mm512_cvtps_pd(_mm256_loadu_ps(rows[k] + i));
+                __m512d const inHi = _mm512_cvtps_pd(_mm256_loadu_ps(rows[k] + i + 8));
+                __m256 const lo = _mm512_cvtpd_ps(_mm512_mul_pd(inLo, kVal));
+                __m256 const hi = _mm512_cvtpd_ps(_mm512_mul_pd(inHi, kVal));
+                __m512 const prod = _mm512_castpd_ps(_mm512_insertf64x4(
+                        _mm512_castpd256_pd512(_mm256_castps_pd(lo)), _mm256_castps_pd(hi), 1));
+                sum = _mm512_add_ps(sum, prod);
+            }
+        }
+        if (doAdd) {
+            sum = _mm512_add_ps(_mm512_loadu_ps(out + i), sum);
+        }
+        _mm512_storeu_ps(out + i, sum);
+    }
+    return i;
+}
+
+LSST_AFW_TARGET("avx512f")
+int dotProductsAvx512(double* out, float const* const* rows, double const* kernel, int kSize, int n,
+                      bool doAdd) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d sum = _mm512_setzero_pd();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m512d const in = _mm512_cvtps_pd(_mm256_loadu_ps(rows[k] + i));
+                sum = _mm512_add_pd(sum, _mm512_mul_pd(in, _mm512_set1_pd(kernel[k])));
+            }
+        }
+        if (doAdd) {
+            sum = _mm512_add_pd(_mm512_loadu_pd(out + i), sum);
+        }
+        _mm512_storeu_pd(out + i, sum);
+    }
+    return i;
+}
+
+LSST_AFW_TARGET("avx512f")
+int dotProductsAvx512(double* out, double const* const* rows, double const* kernel, int kSize, int n,
+                      bool doAdd) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d sum = _mm512_setzero_pd();
+        for (int k = 0; k < kSize; ++k) {
+            if (kernel[k] != 0) {
+                __m512d const in = _mm512_loadu_pd(rows[k] + i);
+                sum = _mm512_add_pd(sum, _mm512_mul_pd(in, _mm512_set1_pd(kernel[k])));
+            }
+        }
+        if (doAdd) {
+            sum = _mm512_add_pd(_mm512_loadu_pd(out + i), sum);
+        }
+        _mm512_storeu_pd(out + i, sum);
+    }
+    return i;
+}
+
+#endif  // LSST_AFW_CONVOLVE_ROWS_X86
+
+template <typename OutPixelT, typename InPixelT>
+void dotProducts(OutPixelT* out, InPixelT const* const* rows, double const* kernel, int kSize, int n,
+                 bool doAdd) {
+    int begin = 0;
+#ifdef LSST_AFW_CONVOLVE_ROWS_X86
+    switch (getInstructionSet()) {
+        case InstructionSet::AVX512:
+            begin = dotProductsAvx512(out, rows, kernel, kSize, n, doAdd);
+            break;
+        case InstructionSet::AVX2:
+            begin = dotProductsAvx2(out, rows, kernel, kSize, n, doAdd);
+            break;
+        case InstructionSet::SCALAR:
+            break;
+    }
+#endif
+    dotProductsScalar(out, rows, kernel, kSize, begin, n, doAdd);
+}
+
+}  // anonymous namespace
+
+template <typename OutPixelT, typename InPixelT>
+void rowDotProducts(OutPixelT* out, InPixelT const* in, double const* kernel, int kSize, int n,
+                    bool doAdd) {
+    std::vector<InPixelT const*> rows(kSize);
+    for (int k = 0; k < kSize; ++k) {
+        rows[k] = in + k;
+    }
+    dotProducts(out, rows.data(), kernel, kSize, n, doAdd);
+}
+
+template <typename OutPixelT, typename InPixelT>
+void columnDotProducts(OutPixelT* out, InPixelT const* const* rows, double const* kernel, int kSize, int n,
+                       bool doAdd) {
+    dotProducts(out, rows, kernel, kSize, n, doAdd);
+}
+
+std::string getConvolveRowsInstructionSet() {
+    switch (getInstructionSet()) {
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::SCALAR:
+            break;
+    }
+    return "scalar";
+}
+
+void setConvolveRowsSimdEnabled(bool enabled) { simdEnabled = enabled; }
+
+/*
+ * Explicit instantiation
+ */
+/// @cond
+#define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)                                                                 \
+    template void rowDotProducts(OUTPIXTYPE*, INPIXTYPE const*, double const*, int, int, bool);           \
+    template void columnDotProducts(OUTPIXTYPE*, INPIXTYPE const* const*, double const*, int, int, bool);
+
+INSTANTIATE(float, float)
+INSTANTIATE(double, double)
+INSTANTIATE(double, float)
+/// @endcond
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
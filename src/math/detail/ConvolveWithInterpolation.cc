@@ -38,6 +38,7 @@
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -76,18 +77,63 @@ void convolveWithInterpolation(OutImageT &outImage, InImageT const &inImage, mat
     LOGL_DEBUG("TRACE3.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: divide into %d x %d subregions", nx, ny);
 
-    ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
-    RowOfKernelImagesForRegion regionRow(nx, ny);
-    while (goodRegion.computeNextRow(regionRow)) {
-        for (RowOfKernelImagesForRegion::ConstIterator rgnIter = regionRow.begin(), rgnEnd = regionRow.end();
-             rgnIter != rgnEnd; ++rgnIter) {
-            LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
-                       "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
-                       (*rgnIter)->getBBox().getMinX(), (*rgnIter)->getBBox().getMinY(),
-                       (*rgnIter)->getBBox().getWidth(), (*rgnIter)->getBBox().getHeight());
-            convolveRegionWithInterpolation(outImage, inImage, **rgnIter, workingImages);
+    int const nThreads = resolveNThreads(convolutionControl.getNThreads());
+    if (nThreads <= 1 || ny <= 1) {
+        ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+        RowOfKernelImagesForRegion regionRow(nx, ny);
+        while (goodRegion.computeNextRow(regionRow)) {
+            for (RowOfKernelImagesForRegion::ConstIterator rgnIter = regionRow.begin(),
+                                                            rgnEnd = regionRow.end();
+                 rgnIter != rgnEnd; ++rgnIter) {
+                LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
+                           "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
+                           (*rgnIter)->getBBox().getMinX(), (*rgnIter)->getBBox().getMinY(),
+                           (*rgnIter)->getBBox().getWidth(), (*rgnIter)->getBBox().getHeight());
+                convolveRegionWithInterpolation(outImage, inImage, **rgnIter, workingImages);
+            }
         }
+        return;
+    }
+
+    // Threaded version: divide the rows of subregions into bands and convolve each band
+    // with its own copy of the kernel. The band starting at subregion row iy uses a region that
+    // extends from that row to the top of the good region, divided into ny - iy rows, which
+    // reproduces the subregion boundaries (and thus the kernel images) of the serial version.
+    std::vector<int> const rowHeights =
+            KernelImagesForRegion::computeSubregionLengths(goodBBox.getHeight(), ny);
+    std::vector<int> rowStarts(1, goodBBox.getMinY());
+    for (int height : rowHeights) {
+        rowStarts.push_back(rowStarts.back() + height);
+    }
+    std::vector<int> const bands = computeBandBoundaries(0, ny, nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    std::vector<std::shared_ptr<Kernel>> bandKernels;
+    bandKernels.reserve(nBands);
+    for (int band = 0; band < nBands; ++band) {
+        bandKernels.push_back(kernel.clone());
     }
+    LOGL_DEBUG("TRACE3.afw.math.convolve.convolveWithInterpolation",
+               "convolveWithInterpolation: convolve %d bands using %d threads", nBands, nThreads);
+
+    parallelFor(nBands, nThreads, [&](int band) {
+        int const yIndStart = bands[band];
+        int const yIndEnd = bands[band + 1];
+        lsst::geom::Box2I const bandBBox(
+                lsst::geom::Point2I(goodBBox.getMinX(), rowStarts[yIndStart]),
+                lsst::geom::Point2I(goodBBox.getMaxX(), goodBBox.getMaxY()));
+        KernelImagesForRegion bandRegion(bandKernels[band], bandBBox, inImage.getXY0(),
+                                         convolutionControl.getDoNormalize());
+        ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+        RowOfKernelImagesForRegion regionRow(nx, ny - yIndStart);
+        for (int yInd = yIndStart; yInd < yIndEnd; ++yInd) {
+            bandRegion.computeNextRow(regionRow);
+            for (RowOfKernelImagesForRegion::ConstIterator rgnIter = regionRow.begin(),
+                                                            rgnEnd = regionRow.end();
+                 rgnIter != rgnEnd; ++rgnIter) {
+                convolveRegionWithInterpolation(outImage, inImage, **rgnIter, workingImages);
+            }
+        }
+    });
 }
 
 template <typename OutImageT, typename InImageT>
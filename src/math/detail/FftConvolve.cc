@@ -0,0 +1,519 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Definition of convolveWithFft declared in detail/Convolve.h
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "fftw3.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/log/Log.h"
+#include "lsst/geom.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/ConvolveImage.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+namespace {
+
+/// Smallest FFT size used; smaller images are transformed in a single tile
+int const MIN_FFT_SIZE = 256;
+
+// The FFTW planner is not thread-safe (only fftw_execute and its new-array variants are)
+std::mutex fftwPlannerMutex;
+
+struct FftwFree {
+    void operator()(void *ptr) const { fftw_free(ptr); }
+};
+typedef std::unique_ptr<double[], FftwFree> RealArray;
+typedef std::unique_ptr<fftw_complex[], FftwFree> ComplexArray;
+
+RealArray allocateRealArray(std::size_t size) {
+    RealArray array(static_cast<double *>(fftw_malloc(sizeof(double) * size)));
+    if (!array) {
+        throw std::bad_alloc();
+    }
+    return array;
+}
+
+ComplexArray allocateComplexArray(std::size_t size) {
+    ComplexArray array(static_cast<fftw_complex *>(fftw_malloc(sizeof(fftw_complex) * size)));
+    if (!array) {
+        throw std::bad_alloc();
+    }
+    return array;
+}
+
+/**
+ * @internal Return the smallest n' >= n whose prime factors are all <= 7 (sizes FFTW handles efficiently)
+ */
+int computeFftSize(int n) {
+    for (;; ++n) {
+        int remainder = n;
+        for (int factor : {2, 3, 5, 7}) {
+            while (remainder % factor == 0) {
+                remainder /= factor;
+            }
+        }
+        if (remainder == 1) {
+            return n;
+        }
+    }
+}
+
+/**
+ * @internal Forward (real to complex) and inverse (complex to real) FFTW plans for one 2-d array size
+ *
+ * The plans are executed with the new-array interface, so one set of plans may be shared by
+ * all threads, each transforming its own arrays (which must be allocated with fftw_malloc).
+ */
+class FftPlans final {
+public:
+    FftPlans(int width, int height) : _width(width), _height(height) {
+        RealArray real = allocateRealArray(getRealSize());
+        ComplexArray complex = allocateComplexArray(getComplexSize());
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+        _forward = fftw_plan_dft_r2c_2d(height, width, real.get(), complex.get(), FFTW_ESTIMATE);
+        _inverse = fftw_plan_dft_c2r_2d(height, width, complex.get(), real.get(), FFTW_ESTIMATE);
+        if (!_forward || !_inverse) {
+            _destroy();
+            throw LSST_EXCEPT(pexExcept::RuntimeError, "Could not create FFTW plans");
+        }
+    }
+
+    FftPlans(FftPlans const &) = delete;
+    FftPlans &operator=(FftPlans const &) = delete;
+
+    ~FftPlans() {
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+        _destroy();
+    }
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+    std::size_t getRealSize() const { return static_cast<std::size_t>(_width) * _height; }
+    std::size_t getComplexSize() const { return static_cast<std::size_t>(_width / 2 + 1) * _height; }
+
+    void forward(double *real, fftw_complex *complex) const { fftw_execute_dft_r2c(_forward, real, complex); }
+    void inverse(fftw_complex *complex, double *real) const { fftw_execute_dft_c2r(_inverse, complex, real); }
+
+private:
+    void _destroy() {
+        if (_forward) fftw_destroy_plan(_forward);
+        if (_inverse) fftw_destroy_plan(_inverse);
+    }
+
+    int _width;
+    int _height;
+    fftw_plan _forward = nullptr;
+    fftw_plan _inverse = nullptr;
+};
+
+/**
+ * @internal Compute the transform of a kernel image, ready to be multiplied by the transform of a tile
+ *
+ * The kernel is flipped (so that the product computes the correlation that afw calls convolution)
+ * and scaled by 1/(number of FFT pixels) (so the inverse transform needs no further scaling).
+ *
+ * @param plans FFT plans
+ * @param kernelImage kernel image
+ * @param doSquare if true, transform the square of the kernel (for convolving variance)
+ */
+ComplexArray transformKernel(FftPlans const &plans, image::Image<Kernel::Pixel> const &kernelImage,
+                             bool doSquare) {
+    int const kWidth = kernelImage.getWidth();
+    int const kHeight = kernelImage.getHeight();
+    double const scale = 1.0 / static_cast<double>(plans.getRealSize());
+    RealArray real = allocateRealArray(plans.getRealSize());
+    std::fill(real.get(), real.get() + plans.getRealSize(), 0.0);
+    for (int y = 0; y < kHeight; ++y) {
+        image::Image<Kernel::Pixel>::const_x_iterator kIter = kernelImage.row_begin(y);
+        double *realRow = real.get() + static_cast<std::size_t>(kHeight - 1 - y) * plans.getWidth();
+        for (int x = 0; x < kWidth; ++x, ++kIter) {
+            double const kVal = *kIter;
+            realRow[kWidth - 1 - x] = (doSquare ? kVal * kVal : kVal) * scale;
+        }
+    }
+    ComplexArray complex = allocateComplexArray(plans.getComplexSize());
+    plans.forward(real.get(), complex.get());
+    return complex;
+}
+
+/**
+ * @internal Convolve one plane of an image using overlap-save FFT convolution
+ *
+ * The good region of the output is divided into tiles; each tile reads the input pixels it depends on
+ * (zero-padded to the FFT size), multiplies their transform by the kernel transform and keeps
+ * the part of the inverse transform that is not affected by wrap-around. Non-finite input pixels
+ * are replaced by zero; the caller must recompute any output pixel that depends on them.
+ *
+ * @param[out] outPlane output image plane; only the good region is set
+ * @param[in] inPlane input image plane
+ * @param[in] plans FFT plans for one tile
+ * @param[in] kernelFft transformed kernel, as computed by transformKernel
+ * @param[in] kWidth, kHeight kernel dimensions
+ * @param[in] cnvStartX, cnvStartY index of the first good output pixel
+ * @param[in] nThreads number of threads to use
+ */
+template <typename OutPixelT, typename InPixelT>
+void convolvePlaneWithFft(image::Image<OutPixelT> &outPlane, image::Image<InPixelT> const &inPlane,
+                          FftPlans const &plans, fftw_complex const *kernelFft, int kWidth, int kHeight,
+                          int cnvStartX, int cnvStartY, int nThreads) {
+    int const cnvWidth = inPlane.getWidth() + 1 - kWidth;
+    int const cnvHeight = inPlane.getHeight() + 1 - kHeight;
+    int const tileWidth = plans.getWidth() + 1 - kWidth;
+    int const tileHeight = plans.getHeight() + 1 - kHeight;
+    int const nTilesX = (cnvWidth + tileWidth - 1) / tileWidth;
+    int const nTilesY = (cnvHeight + tileHeight - 1) / tileHeight;
+    int const fftWidth = plans.getWidth();
+
+    parallelFor(nTilesX * nTilesY, nThreads, [&](int tile) {
+        int const x0 = tileWidth * (tile % nTilesX);  // offset of tile in good region and input image
+        int const y0 = tileHeight * (tile / nTilesX);
+        int const width = std::min(tileWidth, cnvWidth - x0);  // good pixels in this tile
+        int const height = std::min(tileHeight, cnvHeight - y0);
+
+        RealArray real = allocateRealArray(plans.getRealSize());
+        ComplexArray complex = allocateComplexArray(plans.getComplexSize());
+        std::fill(real.get(), real.get() + plans.getRealSize(), 0.0);
+        for (int y = 0; y < height + kHeight - 1; ++y) {
+            typename image::Image<InPixelT>::const_x_iterator inIter = inPlane.x_at(x0, y0 + y);
+            double *realRow = real.get() + static_cast<std::size_t>(y) * fftWidth;
+            for (int x = 0; x < width + kWidth - 1; ++x, ++inIter) {
+                double const value = *inIter;
+                realRow[x] = std::isfinite(value) ? value : 0.0;
+            }
+        }
+
+        plans.forward(real.get(), complex.get());
+        for (std::size_t i = 0, size = plans.getComplexSize(); i < size; ++i) {
+            double const re = complex[i][0] * kernelFft[i][0] - complex[i][1] * kernelFft[i][1];
+            double const im = complex[i][0] * kernelFft[i][1] + complex[i][1] * kernelFft[i][0];
+            complex[i][0] = re;
+            complex[i][1] = im;
+        }
+        plans.inverse(complex.get(), real.get());
+
+        for (int y = 0; y < height; ++y) {
+            typename image::Image<OutPixelT>::x_iterator outIter =
+                    outPlane.x_at(cnvStartX + x0, cnvStartY + y0 + y);
+            double const *realRow =
+                    real.get() + static_cast<std::size_t>(y + kHeight - 1) * fftWidth + (kWidth - 1);
+            for (int x = 0; x < width; ++x, ++outIter) {
+                *outIter = static_cast<OutPixelT>(realRow[x]);
+            }
+        }
+    });
+}
+
+/**
+ * @internal Set the good region of a mask plane to the OR of the input mask over the nonzero kernel pixels
+ *
+ * This matches the mask computed by direct convolution.
+ */
+template <typename MaskPixelT>
+void smearMask(image::Mask<MaskPixelT> &outMask, image::Mask<MaskPixelT> const &inMask,
+               image::Image<Kernel::Pixel> const &kernelImage, int cnvStartX, int cnvStartY, int nThreads) {
+    int const kWidth = kernelImage.getWidth();
+    int const kHeight = kernelImage.getHeight();
+    int const cnvWidth = inMask.getWidth() + 1 - kWidth;
+    int const cnvHeight = inMask.getHeight() + 1 - kHeight;
+
+    // list the nonzero kernel pixels, and note if every row has the same nonzero columns
+    std::vector<std::vector<int>> nonzeroCols(kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        image::Image<Kernel::Pixel>::const_x_iterator kIter = kernelImage.row_begin(y);
+        for (int x = 0; x < kWidth; ++x, ++kIter) {
+            if (*kIter != 0) {
+                nonzeroCols[y].push_back(x);
+            }
+        }
+    }
+    bool const isUniform =
+            std::all_of(nonzeroCols.begin(), nonzeroCols.end(),
+                        [&](std::vector<int> const &cols) { return cols == nonzeroCols[0]; });
+
+    // OR of one input row over a list of kernel columns, for each good output column
+    auto orInputRow = [&](int inY, std::vector<int> const &cols, std::vector<MaskPixelT> &rowOr) {
+        std::fill(rowOr.begin(), rowOr.end(), 0);
+        for (int kx : cols) {
+            typename image::Mask<MaskPixelT>::const_x_iterator inIter = inMask.x_at(kx, inY);
+            for (int x = 0; x < cnvWidth; ++x, ++inIter) {
+                rowOr[x] |= static_cast<MaskPixelT>(*inIter);
+            }
+        }
+    };
+
+    std::vector<int> const bands = computeBandBoundaries(0, cnvHeight, nThreads);
+    parallelFor(static_cast<int>(bands.size()) - 1, nThreads, [&](int band) {
+        // if every kernel row has the same nonzero columns then each input row is ORed once
+        // and kept in a circular buffer of kHeight rows; otherwise rows are ORed as needed
+        std::vector<std::vector<MaskPixelT>> rowOrs(isUniform ? kHeight : 1,
+                                                    std::vector<MaskPixelT>(cnvWidth));
+        std::vector<MaskPixelT> outRow(cnvWidth);
+        if (isUniform) {
+            for (int inY = bands[band]; inY < bands[band] + kHeight - 1; ++inY) {
+                orInputRow(inY, nonzeroCols[0], rowOrs[inY % kHeight]);
+            }
+        }
+        for (int y = bands[band]; y < bands[band + 1]; ++y) {
+            std::fill(outRow.begin(), outRow.end(), 0);
+            if (isUniform) {
+                orInputRow(y + kHeight - 1, nonzeroCols[0], rowOrs[(y + kHeight - 1) % kHeight]);
+            }
+            for (int ky = 0; ky < kHeight; ++ky) {
+                if (!isUniform) {
+                    if (nonzeroCols[ky].empty()) {
+                        continue;
+                    }
+                    orInputRow(y + ky, nonzeroCols[ky], rowOrs[0]);
+                }
+                std::vector<MaskPixelT> const &rowOr = isUniform ? rowOrs[(y + ky) % kHeight] : rowOrs[0];
+                for (int x = 0; x < cnvWidth; ++x) {
+                    outRow[x] |= rowOr[x];
+                }
+            }
+            typename image::Mask<MaskPixelT>::x_iterator outIter = outMask.x_at(cnvStartX, cnvStartY + y);
+            for (int x = 0; x < cnvWidth; ++x, ++outIter) {
+                *outIter = outRow[x];
+            }
+        }
+    });
+}
+
+/**
+ * @internal Return a map of the input pixels that the FFT cannot handle (non-finite image or variance)
+ *
+ * @returns a flag per input pixel (row-major), or an empty vector if all pixels are finite
+ */
+template <typename ImageT>
+std::vector<bool> findNonFinitePixels(ImageT const &inImage, image::detail::Image_tag) {
+    std::vector<bool> nonFinite;
+    for (int y = 0; y < inImage.getHeight(); ++y) {
+        typename ImageT::const_x_iterator inIter = inImage.row_begin(y);
+        for (int x = 0; x < inImage.getWidth(); ++x, ++inIter) {
+            if (!std::isfinite(static_cast<double>(*inIter))) {
+                if (nonFinite.empty()) {
+                    nonFinite.resize(static_cast<std::size_t>(inImage.getWidth()) * inImage.getHeight(),
+                                     false);
+                }
+                nonFinite[static_cast<std::size_t>(y) * inImage.getWidth() + x] = true;
+            }
+        }
+    }
+    return nonFinite;
+}
+
+template <typename ImageT>
+std::vector<bool> findNonFinitePixels(ImageT const &inImage, image::detail::MaskedImage_tag) {
+    std::vector<bool> nonFinite;
+    for (int y = 0; y < inImage.getHeight(); ++y) {
+        typename ImageT::Image::const_x_iterator imIter = inImage.getImage()->row_begin(y);
+        typename ImageT::Variance::const_x_iterator varIter = inImage.getVariance()->row_begin(y);
+        for (int x = 0; x < inImage.getWidth(); ++x, ++imIter, ++varIter) {
+            if (!std::isfinite(static_cast<double>(*imIter)) ||
+                !std::isfinite(static_cast<double>(*varIter))) {
+                if (nonFinite.empty()) {
+                    nonFinite.resize(static_cast<std::size_t>(inImage.getWidth()) * inImage.getHeight(),
+                                     false);
+                }
+                nonFinite[static_cast<std::size_t>(y) * inImage.getWidth() + x] = true;
+            }
+        }
+    }
+    return nonFinite;
+}
+
+template <typename OutImageT, typename InImageT>
+void convolvePlanesWithFft(OutImageT &convolvedImage, InImageT const &inImage,
+                           image::Image<Kernel::Pixel> const &kernelImage, FftPlans const &plans,
+                           int cnvStartX, int cnvStartY, int nThreads, image::detail::Image_tag) {
+    ComplexArray kernelFft = transformKernel(plans, kernelImage, false);
+    convolvePlaneWithFft(convolvedImage, inImage, plans, kernelFft.get(), kernelImage.getWidth(),
+                         kernelImage.getHeight(), cnvStartX, cnvStartY, nThreads);
+}
+
+template <typename OutImageT, typename InImageT>
+void convolvePlanesWithFft(OutImageT &convolvedImage, InImageT const &inImage,
+                           image::Image<Kernel::Pixel> const &kernelImage, FftPlans const &plans,
+                           int cnvStartX, int cnvStartY, int nThreads, image::detail::MaskedImage_tag) {
+    ComplexArray kernelFft = transformKernel(plans, kernelImage, false);
+    convolvePlaneWithFft(*convolvedImage.getImage(), *inImage.getImage(), plans, kernelFft.get(),
+                         kernelImage.getWidth(), kernelImage.getHeight(), cnvStartX, cnvStartY, nThreads);
+    kernelFft = transformKernel(plans, kernelImage, true);
+    convolvePlaneWithFft(*convolvedImage.getVariance(), *inImage.getVariance(), plans, kernelFft.get(),
+                         kernelImage.getWidth(), kernelImage.getHeight(), cnvStartX, cnvStartY, nThreads);
+    smearMask(*convolvedImage.getMask(), *inImage.getMask(), kernelImage, cnvStartX, cnvStartY, nThreads);
+}
+
+}  // anonymous namespace
+
+template <typename OutImageT, typename InImageT>
+bool canConvolveWithFft(OutImageT const &convolvedImage, InImageT const &inImage, math::Kernel const &kernel,
+                        math::ConvolutionControl const &convolutionControl) {
+    typedef typename image::GetImage<OutImageT>::type::Pixel OutPixel;
+    int const minFftKernelSize = convolutionControl.getMinFftKernelSize();
+    return std::is_floating_point<OutPixel>::value && (minFftKernelSize > 0) &&
+           !kernel.isSpatiallyVarying() && (kernel.getWidth() >= minFftKernelSize) &&
+           (kernel.getHeight() >= minFftKernelSize);
+}
+
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT &convolvedImage, InImageT const &inImage, math::Kernel const &kernel,
+                     math::ConvolutionControl const &convolutionControl) {
+    typedef typename image::GetImage<OutImageT>::type::Pixel OutPixel;
+    typedef image::Image<Kernel::Pixel> KernelImage;
+
+    if (!std::is_floating_point<OutPixel>::value) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          "FFT convolution requires an output image with floating-point pixels");
+    }
+    if (kernel.isSpatiallyVarying()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          "FFT convolution requires a spatially invariant kernel");
+    }
+    if (convolvedImage.getDimensions() != inImage.getDimensions()) {
+        std::ostringstream os;
+        os << "convolvedImage dimensions = ( " << convolvedImage.getWidth() << ", "
+           << convolvedImage.getHeight() << ") != (" << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") = inImage dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if ((kernel.getWidth() < 1) || (kernel.getHeight() < 1) || (inImage.getWidth() < kernel.getWidth()) ||
+        (inImage.getHeight() < kernel.getHeight())) {
+        std::ostringstream os;
+        os << "inImage dimensions = ( " << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") and kernel dimensions = (" << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") incompatible: kernel must be at least 1 x 1 and no larger than inImage";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+
+    int const kWidth = kernel.getWidth();
+    int const kHeight = kernel.getHeight();
+    int const cnvWidth = inImage.getWidth() + 1 - kWidth;
+    int const cnvHeight = inImage.getHeight() + 1 - kHeight;
+    int const cnvStartX = kernel.getCtrX();
+    int const cnvStartY = kernel.getCtrY();
+    int const nThreads = resolveNThreads(convolutionControl.getNThreads());
+
+    KernelImage kernelImage(kernel.getDimensions());
+    (void)kernel.computeImage(kernelImage, convolutionControl.getDoNormalize());
+
+    // Use tiles whose FFT is at least MIN_FFT_SIZE and four times the kernel size on a side,
+    // unless the image is smaller than that, so the work wasted on the overlap is modest
+    // and the memory used per thread is bounded.
+    int const fftWidth = computeFftSize(
+            std::min(cnvWidth, std::max(MIN_FFT_SIZE, 4 * kWidth) + 1 - kWidth) + kWidth - 1);
+    int const fftHeight = computeFftSize(
+            std::min(cnvHeight, std::max(MIN_FFT_SIZE, 4 * kHeight) + 1 - kHeight) + kHeight - 1);
+    LOGL_DEBUG("TRACE3.afw.math.convolve.convolveWithFft",
+               "convolveWithFft: kernel %d x %d; FFT size %d x %d; %d threads", kWidth, kHeight, fftWidth,
+               fftHeight, nThreads);
+    FftPlans const plans(fftWidth, fftHeight);
+
+    convolvePlanesWithFft(convolvedImage, inImage, kernelImage, plans, cnvStartX, cnvStartY, nThreads,
+                          typename image::detail::image_traits<OutImageT>::image_category());
+
+    // Recompute output pixels that depend on non-finite input pixels directly, so that
+    // they are affected exactly as in direct convolution (where a NaN only spreads to pixels
+    // for which it lies under a nonzero kernel pixel) rather than spreading over a whole tile.
+    std::vector<bool> const nonFinite = findNonFinitePixels(
+            inImage, typename image::detail::image_traits<InImageT>::image_category());
+    if (!nonFinite.empty()) {
+        std::vector<bool> recompute(static_cast<std::size_t>(cnvWidth) * cnvHeight, false);
+        for (int inY = 0; inY < inImage.getHeight(); ++inY) {
+            for (int inX = 0; inX < inImage.getWidth(); ++inX) {
+                if (!nonFinite[static_cast<std::size_t>(inY) * inImage.getWidth() + inX]) {
+                    continue;
+                }
+                for (int y = std::max(0, inY + 1 - kHeight), yEnd = std::min(cnvHeight, inY + 1); y < yEnd;
+                     ++y) {
+                    for (int x = std::max(0, inX + 1 - kWidth), xEnd = std::min(cnvWidth, inX + 1);
+                         x < xEnd; ++x) {
+                        recompute[static_cast<std::size_t>(y) * cnvWidth + x] = true;
+                    }
+                }
+            }
+        }
+        typename KernelImage::const_xy_locator const kernelLoc = kernelImage.xy_at(0, 0);
+        for (int y = 0; y < cnvHeight; ++y) {
+            typename OutImageT::x_iterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvStartY + y);
+            for (int x = 0; x < cnvWidth; ++x, ++cnvXIter) {
+                if (recompute[static_cast<std::size_t>(y) * cnvWidth + x]) {
+                    *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImage.xy_at(x, y), kernelLoc,
+                                                                            kWidth, kHeight);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Explicit instantiation
+ */
+/// @cond
+#define IMAGE(PIXTYPE) image::Image<PIXTYPE>
+#define MASKEDIMAGE(PIXTYPE) image::MaskedImage<PIXTYPE, image::MaskPixel, image::VariancePixel>
+#define NL /* */
+// Instantiate Image or MaskedImage versions
+#define INSTANTIATE_IM_OR_MI(IMGMACRO, OUTPIXTYPE, INPIXTYPE)                                             \
+    template bool canConvolveWithFft(IMGMACRO(OUTPIXTYPE) const &, IMGMACRO(INPIXTYPE) const &,           \
+                                     math::Kernel const &, math::ConvolutionControl const &);             \
+    NL template void convolveWithFft(IMGMACRO(OUTPIXTYPE) &, IMGMACRO(INPIXTYPE) const &,                 \
+                                     math::Kernel const &, math::ConvolutionControl const &);
+// Instantiate both Image and MaskedImage versions
+#define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)             \
+    INSTANTIATE_IM_OR_MI(IMAGE, OUTPIXTYPE, INPIXTYPE) \
+    INSTANTIATE_IM_OR_MI(MASKEDIMAGE, OUTPIXTYPE, INPIXTYPE)
+
+INSTANTIATE(double, double)
+INSTANTIATE(double, float)
+INSTANTIATE(double, int)
+INSTANTIATE(double, std::uint16_t)
+INSTANTIATE(float, float)
+INSTANTIATE(float, int)
+INSTANTIATE(float, std::uint16_t)
+INSTANTIATE(int, int)
+INSTANTIATE(std::uint16_t, std::uint16_t)
+/// @endcond
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,69 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+#include "lsst/afw/math/detail/LanczosTable.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+LanczosTable::LanczosTable(int order, int oversampling) : _order(order), _oversampling(oversampling) {
+    if (order < 1 || oversampling < 1) {
+        std::ostringstream os;
+        os << "order = " << order << " and/or oversampling = " << oversampling << " < 1";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    // use the same function as LanczosWarpingKernel, so the table agrees with it exactly at the nodes;
+    // the extra entry at the end allows interpolation at t = order
+    LanczosFunction1<double> const lanczos(order);
+    int const nValues = 2 * order * oversampling + 2;
+    _values.reserve(nValues);
+    for (int i = 0; i < nValues; ++i) {
+        _values.push_back(lanczos(-order + static_cast<double>(i) / oversampling));
+    }
+}
+
+double LanczosTable::getMaxError(int order, int oversampling) {
+    // max|L''| = |L''(0)| = pi^2 (1 + 1/n^2) / 3, and linear interpolation between nodes spaced by h
+    // has error at most h^2 max|L''| / 8
+    return lsst::geom::PI * lsst::geom::PI * (1.0 + 1.0 / (static_cast<double>(order) * order)) /
+           (24.0 * static_cast<double>(oversampling) * oversampling);
+}
+
+void LanczosTable::_throwOutOfRange(double fracPos, int ctr) const {
+    std::ostringstream os;
+    os << "fracPos = " << fracPos << " and ctr = " << ctr
+       << " are not valid for a Lanczos warping kernel of order " << _order;
+    throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,72 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <thread>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+int resolveNThreads(int nThreads) {
+    if (nThreads < 0) {
+        std::ostringstream os;
+        os << "nThreads = " << nThreads << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (nThreads == 0) {
+        // hardware_concurrency may return 0 if the value is not computable
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    return nThreads;
+}
+
+std::vector<int> computeBandBoundaries(int begin, int end, int nBands, int alignment) {
+    if ((nBands < 1) || (alignment < 1)) {
+        std::ostringstream os;
+        os << "nBands = " << nBands << " and/or alignment = " << alignment << " < 1";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    std::vector<int> boundaries;
+    if (end <= begin) {
+        return boundaries;
+    }
+    int const nUnits = (end - begin + alignment - 1) / alignment;  // number of aligned units, rounded up
+    nBands = std::min(nBands, nUnits);
+    boundaries.reserve(nBands + 1);
+    for (int i = 0; i < nBands; ++i) {
+        boundaries.push_back(begin + alignment * static_cast<int>((static_cast<long>(nUnits) * i) / nBands));
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
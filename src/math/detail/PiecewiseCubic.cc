@@ -0,0 +1,215 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/detail/PiecewiseCubic.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+namespace {
+/*
+ * The coefficients of a natural cubic spline, as computed by GSL's cspline
+ *
+ * The second derivatives (c) at the interior points satisfy a symmetric tridiagonal system, which
+ * we solve by Cholesky-like decomposition just as GSL does
+ */
+void setNaturalSplineCoeffs(std::vector<double> const& x, std::vector<double> const& y,
+                            std::vector<double>& b, std::vector<double>& c, std::vector<double>& d) {
+    std::size_t const n = x.size();
+    std::size_t const sysSize = n - 2;  // number of interior points
+
+    std::vector<double> cc(n, 0.0);  // c at each point; zero at the ends
+    std::vector<double> diag(sysSize), offdiag(sysSize), g(sysSize);
+    for (std::size_t i = 0; i < sysSize; ++i) {
+        double const h_i = x[i + 1] - x[i];
+        double const h_ip1 = x[i + 2] - x[i + 1];
+        double const ydiff_i = y[i + 1] - y[i];
+        double const ydiff_ip1 = y[i + 2] - y[i + 1];
+        double const g_i = (h_i != 0.0) ? 1.0 / h_i : 0.0;
+        double const g_ip1 = (h_ip1 != 0.0) ? 1.0 / h_ip1 : 0.0;
+        offdiag[i] = h_ip1;
+        diag[i] = 2.0 * (h_ip1 + h_i);
+        g[i] = 3.0 * (ydiff_ip1 * g_ip1 - ydiff_i * g_i);
+    }
+
+    if (sysSize == 1) {
+        cc[1] = g[0] / diag[0];
+    } else {
+        std::vector<double> gamma(sysSize), alpha(sysSize), z(sysSize);
+        alpha[0] = diag[0];
+        gamma[0] = offdiag[0] / alpha[0];
+        for (std::size_t i = 1; i < sysSize - 1; ++i) {
+            alpha[i] = diag[i] - offdiag[i - 1] * gamma[i - 1];
+            gamma[i] = offdiag[i] / alpha[i];
+        }
+        alpha[sysSize - 1] = diag[sysSize - 1] - offdiag[sysSize - 2] * gamma[sysSize - 2];
+
+        z[0] = g[0];
+        for (std::size_t i = 1; i < sysSize; ++i) {
+            z[i] = g[i] - gamma[i - 1] * z[i - 1];
+        }
+        for (std::size_t i = 0; i < sysSize; ++i) {
+            z[i] /= alpha[i];
+        }
+        cc[sysSize] = z[sysSize - 1];
+        for (std::size_t i = sysSize - 1; i > 0; --i) {
+            cc[i] = z[i - 1] - gamma[i - 1] * cc[i + 1];
+        }
+    }
+
+    for (std::size_t i = 0; i < n - 1; ++i) {
+        double const dx = x[i + 1] - x[i];
+        double const dy = y[i + 1] - y[i];
+        b[i] = dy / dx - dx * (cc[i + 1] + 2.0 * cc[i]) / 3.0;
+        c[i] = cc[i];
+        d[i] = (cc[i + 1] - cc[i]) / (3.0 * dx);
+    }
+}
+
+/*
+ * The coefficients of an Akima spline with non-periodic boundary conditions, as computed by GSL's akima
+ */
+void setAkimaCoeffs(std::vector<double> const& x, std::vector<double> const& y, std::vector<double>& b,
+                    std::vector<double>& c, std::vector<double>& d) {
+    int const n = x.size();
+    std::vector<double> slopes(n + 3);  // the slopes of the intervals, padded by two at each end
+    double* m = slopes.data() + 2;      // so m[-2] and m[-1] are valid
+    for (int i = 0; i < n - 1; ++i) {
+        m[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+    }
+    m[-2] = 3.0 * m[0] - 2.0 * m[1];
+    m[-1] = 2.0 * m[0] - m[1];
+    m[n - 1] = 2.0 * m[n - 2] - m[n - 3];
+    m[n] = 3.0 * m[n - 2] - 2.0 * m[n - 3];
+
+    for (int i = 0; i < n - 1; ++i) {
+        double const NE = std::fabs(m[i + 1] - m[i]) + std::fabs(m[i - 1] - m[i - 2]);
+        if (NE == 0.0) {
+            b[i] = m[i];
+            c[i] = 0.0;
+            d[i] = 0.0;
+        } else {
+            double const h_i = x[i + 1] - x[i];
+            double const NE_next = std::fabs(m[i + 2] - m[i + 1]) + std::fabs(m[i] - m[i - 1]);
+            double const alpha_i = std::fabs(m[i - 1] - m[i - 2]) / NE;
+            double tL_ip1;
+            if (NE_next == 0.0) {
+                tL_ip1 = m[i];
+            } else {
+                double const alpha_ip1 = std::fabs(m[i] - m[i - 1]) / NE_next;
+                tL_ip1 = (1.0 - alpha_ip1) * m[i] + alpha_ip1 * m[i + 1];
+            }
+            b[i] = (1.0 - alpha_i) * m[i - 1] + alpha_i * m[i];
+            c[i] = (3.0 * m[i] - 2.0 * b[i] - tL_ip1) / h_i;
+            d[i] = (b[i] + tL_ip1 - 2.0 * m[i]) / (h_i * h_i);
+        }
+    }
+}
+}  // namespace
+
+bool PiecewiseCubic::isSupported(Interpolate::Style style, int nPoints) {
+    switch (style) {
+        case Interpolate::LINEAR:
+        case Interpolate::NATURAL_SPLINE:
+        case Interpolate::CUBIC_SPLINE:
+        case Interpolate::AKIMA_SPLINE:
+            return nPoints >= lookupMinInterpPoints(style);
+        default:
+            return false;
+    }
+}
+
+PiecewiseCubic::PiecewiseCubic(std::vector<double> const& x, std::vector<double> const& y,
+                               Interpolate::Style style)
+        : _x(x), _y(y) {
+    if (x.size() != y.size()) {
+        std::ostringstream os;
+        os << "Dimensions of x and y must match; " << x.size() << " != " << y.size();
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (!isSupported(style, x.size())) {
+        std::ostringstream os;
+        os << "Unable to interpolate " << x.size() << " points with style " << style;
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+
+    std::size_t const nInterval = x.size() - 1;
+    _b.resize(nInterval);
+    _c.assign(nInterval, 0.0);
+    _d.assign(nInterval, 0.0);
+    switch (style) {
+        case Interpolate::LINEAR:
+            for (std::size_t i = 0; i < nInterval; ++i) {
+                _b[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+            }
+            break;
+        case Interpolate::AKIMA_SPLINE:
+            setAkimaCoeffs(x, y, _b, _c, _d);
+            break;
+        default:  // both of the cubic splines are natural, as in makeInterpolate
+            setNaturalSplineCoeffs(x, y, _b, _c, _d);
+            break;
+    }
+}
+
+double PiecewiseCubic::interpolate(double x) const {
+    if (x < _x.front() || x > _x.back()) {
+        return _extrapolate(x);
+    }
+    // the interval containing x; the last interval includes its upper end
+    int const i = std::min<int>(std::upper_bound(_x.begin(), _x.end(), x) - _x.begin(), _x.size() - 1) - 1;
+    double const dx = x - _x[i];
+    return _y[i] + dx * (_b[i] + dx * (_c[i] + dx * _d[i]));
+}
+
+double PiecewiseCubic::_extrapolate(double x) const {
+    // Use the value, first and second derivatives at the nearer end, as does Interpolate
+    double x0, y0, deriv, deriv2;
+    if (x < _x.front()) {
+        x0 = _x.front();
+        y0 = _y.front();
+        deriv = _b.front();
+        deriv2 = 2.0 * _c.front();
+    } else {
+        std::size_t const i = _b.size() - 1;
+        double const dx = _x.back() - _x[i];
+        x0 = _x.back();
+        y0 = _y.back();
+        deriv = _b[i] + dx * (2.0 * _c[i] + 3.0 * _d[i] * dx);
+        deriv2 = 2.0 * _c[i] + 6.0 * _d[i] * dx;
+    }
+    return y0 + (x - x0) * deriv + 0.5 * (x - x0) * (x - x0) * deriv2;
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
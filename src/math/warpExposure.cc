@@ -48,6 +48,7 @@
 #include "lsst/afw/geom.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/Calib.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/math/detail/WarpAtOnePoint.h"
 
 namespace pexExcept = lsst::pex::exceptions;
@@ -234,6 +235,24 @@ void WarpingControl::_testWarpingKernels(SeparableKernel const &warpingKernel,
     }
 }
 
+void WarpingControl::setNThreads(int nThreads) {
+    if (nThreads < 0) {
+        std::ostringstream os;
+        os << "nThreads = " << nThreads << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    _nThreads = nThreads;
+}
+
+void WarpingControl::setLanczosTableOversampling(int oversampling) {
+    if (oversampling < 0) {
+        std::ostringstream os;
+        os << "oversampling = " << oversampling << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    _lanczosTableOversampling = oversampling;
+}
+
 template <typename DestExposureT, typename SrcExposureT>
 int warpExposure(DestExposureT &destExposure, SrcExposureT const &srcExposure, WarpingControl const &control,
                  typename DestExposureT::MaskedImageT::SinglePixel padValue) {
@@ -278,6 +297,208 @@ inline double computeRelativeArea(
     return std::abs(dSrcA.getX() * dSrcB.getY() - dSrcA.getY() * dSrcB.getX());
 }
 
+/**
+ * @internal Warp a band of rows of an image, using linear interpolation of the source positions
+ *
+ * The source positions are computed by a recurrence that starts at destination row -1,
+ * so this computes (but does not warp) the rows before the band, in order that the result
+ * is the same no matter how the image is divided into bands.
+ *
+ * @returns the number of good pixels in the band
+ */
+template <typename DestImageT, typename SrcImageT>
+int warpRowsWithInterpolation(
+        DestImageT &destImage,                                           ///< @internal remapped %image
+        detail::WarpAtOnePoint<DestImageT, SrcImageT> &warpAtOnePoint,  ///< @internal pixel warper
+        geom::TransformPoint2ToPoint2 const &localDestToParentSrc,  ///< @internal local dest to parent src
+        int interpLength,                                          ///< @internal interpolation length
+        int rowBegin,                                              ///< @internal first row of band
+        int rowEnd)                                                ///< @internal last row of band + 1
+{
+    int const destWidth = destImage.getWidth();
+    int const destHeight = destImage.getHeight();
+    int const maxCol = destWidth - 1;
+    int const maxRow = destHeight - 1;
+
+    int numGoodPixels = 0;
+
+    // Estimate for number of horizontal interpolation band edges, to reserve memory in vectors
+    int const numColEdges = 2 + ((destWidth - 1) / interpLength);
+
+    // A list of edge column indices for interpolation bands;
+    // starts at -1, increments by interpLen (except the final interval), and ends at destWidth-1
+    std::vector<int> edgeColList;
+    edgeColList.reserve(numColEdges);
+
+    // A list of 1/column width for horizontal interpolation bands; the first value is garbage.
+    // The inverse is used for speed because the values are always multiplied.
+    std::vector<double> invWidthList;
+    invWidthList.reserve(numColEdges);
+
+    // Compute edgeColList and invWidthList
+    edgeColList.push_back(-1);
+    invWidthList.push_back(0.0);
+    for (int prevEndCol = -1; prevEndCol < maxCol; prevEndCol += interpLength) {
+        int endCol = prevEndCol + interpLength;
+        if (endCol > maxCol) {
+            endCol = maxCol;
+        }
+        edgeColList.push_back(endCol);
+        assert(endCol - prevEndCol > 0);
+        invWidthList.push_back(1.0 / static_cast<double>(endCol - prevEndCol));
+    }
+    assert(edgeColList.back() == maxCol);
+
+    // A list of delta source positions along the edge columns of the horizontal interpolation bands
+    std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
+
+    // A cache of pixel positions on the source corresponding to the previous or current row
+    // of the destination image.
+    // The first value is for column -1 because the previous source position is used to compute relative
+    // area To simplify the indexing, use an iterator that starts at begin+1, thus: srcPosView =
+    // srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row srcPosView[col] and
+    // higher indices are for the previous row
+    std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
+    std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
+
+    std::vector<lsst::geom::Point2D> endColPosList;
+    endColPosList.reserve(numColEdges);
+
+    // Initialize srcPosList for row -1
+    for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+        int const endCol = edgeColList[colBand];
+        endColPosList.emplace_back(lsst::geom::Point2D(endCol, -1));
+    }
+    auto rightSrcPosList = localDestToParentSrc.applyForward(endColPosList);
+    srcPosView[-1] = rightSrcPosList[0];
+    for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+        int const prevEndCol = edgeColList[colBand - 1];
+        int const endCol = edgeColList[colBand];
+        lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+
+        lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
+
+        for (int col = prevEndCol + 1; col <= endCol; ++col) {
+            srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
+        }
+    }
+
+    int endRow = -1;
+    while (endRow + 1 < rowEnd) {
+        // Next horizontal interpolation band
+
+        int prevEndRow = endRow;
+        endRow = prevEndRow + interpLength;
+        if (endRow > maxRow) {
+            endRow = maxRow;
+        }
+        assert(endRow - prevEndRow > 0);
+        double interpInvHeight = 1.0 / static_cast<double>(endRow - prevEndRow);
+
+        // Set yDeltaSrcPosList for this horizontal interpolation band
+        std::vector<lsst::geom::Point2D> destRowPosList;
+        destRowPosList.reserve(edgeColList.size());
+        for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+            int endCol = edgeColList[colBand];
+            destRowPosList.emplace_back(lsst::geom::Point2D(endCol, endRow));
+        }
+        auto bottomSrcPosList = localDestToParentSrc.applyForward(destRowPosList);
+        for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+            int endCol = edgeColList[colBand];
+            yDeltaSrcPosList[colBand] = (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
+        }
+
+        for (int row = prevEndRow + 1; row <= endRow && row < rowEnd; ++row) {
+            // rows before the band are only needed to update srcPosList
+            bool const doWarp = row >= rowBegin;
+            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+            srcPosView[-1] += yDeltaSrcPosList[0];
+            for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+                // Next vertical interpolation band
+
+                int const prevEndCol = edgeColList[colBand - 1];
+                int const endCol = edgeColList[colBand];
+
+                // Compute xDeltaSrcPos; remember that srcPosView contains
+                // positions for this row in prevEndCol and smaller indices,
+                // and positions for the previous row for larger indices (including endCol)
+                lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+                lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
+                lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
+
+                for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
+                    lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
+                    lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
+                    if (doWarp) {
+                        double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
+                        if (warpAtOnePoint(
+                                    destXIter, srcPos, relativeArea,
+                                    typename image::detail::image_traits<DestImageT>::image_category())) {
+                            ++numGoodPixels;
+                        }
+                    }
+
+                    srcPosView[col] = srcPos;
+                }  // for col
+            }      // for col band
+        }          // for row
+    }              // while next row band
+
+    return numGoodPixels;
+}
+
+/**
+ * @internal Warp a band of rows of an image, computing the source position of every pixel
+ *
+ * @returns the number of good pixels in the band
+ */
+template <typename DestImageT, typename SrcImageT>
+int warpRowsWithoutInterpolation(
+        DestImageT &destImage,                                           ///< @internal remapped %image
+        detail::WarpAtOnePoint<DestImageT, SrcImageT> &warpAtOnePoint,  ///< @internal pixel warper
+        geom::TransformPoint2ToPoint2 const &localDestToParentSrc,  ///< @internal local dest to parent src
+        int rowBegin,                                              ///< @internal first row of band
+        int rowEnd)                                                ///< @internal last row of band + 1
+{
+    int const destWidth = destImage.getWidth();
+
+    int numGoodPixels = 0;
+
+    // prevSrcPosList = source positions from the previous row; these are used to compute pixel area;
+    // to begin, compute sources positions corresponding to the row before the band
+    std::vector<lsst::geom::Point2D> destPosList;
+    destPosList.reserve(1 + destWidth);
+    for (int col = -1; col < destWidth; ++col) {
+        destPosList.emplace_back(lsst::geom::Point2D(col, rowBegin - 1));
+    }
+    auto prevSrcPosList = localDestToParentSrc.applyForward(destPosList);
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        destPosList.clear();
+        for (int col = -1; col < destWidth; ++col) {
+            destPosList.emplace_back(lsst::geom::Point2D(col, row));
+        }
+        auto srcPosList = localDestToParentSrc.applyForward(destPosList);
+
+        typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+        for (int col = 0; col < destWidth; ++col, ++destXIter) {
+            // column index = column + 1 because the first entry in srcPosList is for column -1
+            auto srcPos = srcPosList[col + 1];
+            double relativeArea = computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
+
+            if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                               typename image::detail::image_traits<DestImageT>::image_category())) {
+                ++numGoodPixels;
+            }
+        }  // for col
+        // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
+        // because it will be reallocated anyway)
+        swap(srcPosList, prevSrcPosList);
+    }  // for row
+
+    return numGoodPixels;
+}
+
 }  // namespace
 
 template <typename DestImageT, typename SrcImageT>
@@ -337,172 +558,52 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
     // Set each pixel of destExposure's MaskedImage
     LOGL_DEBUG("TRACE3.afw.math.warp", "Remapping masked image");
 
-    int const maxCol = destWidth - 1;
-    int const maxRow = destHeight - 1;
-
-    detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
-
-    if (interpLength > 0) {
-        // Use interpolation. Note that 1 produces the same result as no interpolation
-        // but uses this code branch, thus providing an easy way to compare the two branches.
-
-        // Estimate for number of horizontal interpolation band edges, to reserve memory in vectors
-        int const numColEdges = 2 + ((destWidth - 1) / interpLength);
-
-        // A list of edge column indices for interpolation bands;
-        // starts at -1, increments by interpLen (except the final interval), and ends at destWidth-1
-        std::vector<int> edgeColList;
-        edgeColList.reserve(numColEdges);
-
-        // A list of 1/column width for horizontal interpolation bands; the first value is garbage.
-        // The inverse is used for speed because the values are always multiplied.
-        std::vector<double> invWidthList;
-        invWidthList.reserve(numColEdges);
-
-        // Compute edgeColList and invWidthList
-        edgeColList.push_back(-1);
-        invWidthList.push_back(0.0);
-        for (int prevEndCol = -1; prevEndCol < maxCol; prevEndCol += interpLength) {
-            int endCol = prevEndCol + interpLength;
-            if (endCol > maxCol) {
-                endCol = maxCol;
-            }
-            edgeColList.push_back(endCol);
-            assert(endCol - prevEndCol > 0);
-            invWidthList.push_back(1.0 / static_cast<double>(endCol - prevEndCol));
-        }
-        assert(edgeColList.back() == maxCol);
-
-        // A list of delta source positions along the edge columns of the horizontal interpolation bands
-        std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
-
-        // A cache of pixel positions on the source corresponding to the previous or current row
-        // of the destination image.
-        // The first value is for column -1 because the previous source position is used to compute relative
-        // area To simplify the indexing, use an iterator that starts at begin+1, thus: srcPosView =
-        // srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row srcPosView[col] and
-        // higher indices are for the previous row
-        std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
-        std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
-
-        std::vector<lsst::geom::Point2D> endColPosList;
-        endColPosList.reserve(numColEdges);
-
-        // Initialize srcPosList for row -1
-        for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-            int const endCol = edgeColList[colBand];
-            endColPosList.emplace_back(lsst::geom::Point2D(endCol, -1));
+    auto warpRows = [&](detail::WarpAtOnePoint<DestImageT, SrcImageT> &warpAtOnePoint,
+                        geom::TransformPoint2ToPoint2 const &transform, int rowBegin, int rowEnd) {
+        if (interpLength > 0) {
+            // Use interpolation. Note that 1 produces the same result as no interpolation
+            // but uses this code branch, thus providing an easy way to compare the two branches.
+            return warpRowsWithInterpolation(destImage, warpAtOnePoint, transform, interpLength, rowBegin,
+                                             rowEnd);
+        } else {
+            return warpRowsWithoutInterpolation(destImage, warpAtOnePoint, transform, rowBegin, rowEnd);
         }
-        auto rightSrcPosList = localDestToParentSrc->applyForward(endColPosList);
-        srcPosView[-1] = rightSrcPosList[0];
-        for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-            int const prevEndCol = edgeColList[colBand - 1];
-            int const endCol = edgeColList[colBand];
-            lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-
-            lsst::geom::Extent2D xDeltaSrcPos =
-                    (rightSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
-
-            for (int col = prevEndCol + 1; col <= endCol; ++col) {
-                srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
+    };
+
+    int const nThreads = detail::resolveNThreads(control.getNThreads());
+    std::vector<int> const bands = detail::computeBandBoundaries(0, destHeight, nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    if (nBands <= 1) {
+        detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
+        numGoodPixels = warpRows(warpAtOnePoint, *localDestToParentSrc, 0, destHeight);
+    } else {
+        // The warping kernels and the transform hold mutable state, so each band gets its own copies.
+        // These are made (and the kernel caches computed) by the calling thread.
+        std::vector<std::unique_ptr<detail::WarpAtOnePoint<DestImageT, SrcImageT>>> bandWarpers;
+        std::vector<std::unique_ptr<geom::TransformPoint2ToPoint2>> bandTransforms;
+        bandWarpers.reserve(nBands);
+        bandTransforms.reserve(nBands);
+        for (int band = 0; band < nBands; ++band) {
+            WarpingControl bandControl(control);
+            bandControl.setWarpingKernel(*control.getWarpingKernel());
+            if (control.hasMaskWarpingKernel()) {
+                bandControl.setMaskWarpingKernel(*control.getMaskWarpingKernel());
             }
+            bandWarpers.emplace_back(
+                    new detail::WarpAtOnePoint<DestImageT, SrcImageT>(srcImage, bandControl, padValue));
+            // copy the mapping without simplifying it, so the copy computes exactly the same positions
+            bandTransforms.emplace_back(
+                    new geom::TransformPoint2ToPoint2(*localDestToParentSrc->getMapping(), false));
         }
-
-        int endRow = -1;
-        while (endRow < maxRow) {
-            // Next horizontal interpolation band
-
-            int prevEndRow = endRow;
-            endRow = prevEndRow + interpLength;
-            if (endRow > maxRow) {
-                endRow = maxRow;
-            }
-            assert(endRow - prevEndRow > 0);
-            double interpInvHeight = 1.0 / static_cast<double>(endRow - prevEndRow);
-
-            // Set yDeltaSrcPosList for this horizontal interpolation band
-            std::vector<lsst::geom::Point2D> destRowPosList;
-            destRowPosList.reserve(edgeColList.size());
-            for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                int endCol = edgeColList[colBand];
-                destRowPosList.emplace_back(lsst::geom::Point2D(endCol, endRow));
-            }
-            auto bottomSrcPosList = localDestToParentSrc->applyForward(destRowPosList);
-            for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                int endCol = edgeColList[colBand];
-                yDeltaSrcPosList[colBand] =
-                        (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
-            }
-
-            for (int row = prevEndRow + 1; row <= endRow; ++row) {
-                typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-                srcPosView[-1] += yDeltaSrcPosList[0];
-                for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                    // Next vertical interpolation band
-
-                    int const prevEndCol = edgeColList[colBand - 1];
-                    int const endCol = edgeColList[colBand];
-
-                    // Compute xDeltaSrcPos; remember that srcPosView contains
-                    // positions for this row in prevEndCol and smaller indices,
-                    // and positions for the previous row for larger indices (including endCol)
-                    lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-                    lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
-                    lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
-
-                    for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
-                        lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
-                        lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
-                        double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
-
-                        srcPosView[col] = srcPos;
-
-                        if (warpAtOnePoint(
-                                    destXIter, srcPos, relativeArea,
-                                    typename image::detail::image_traits<DestImageT>::image_category())) {
-                            ++numGoodPixels;
-                        }
-                    }  // for col
-                }      // for col band
-            }          // for row
-        }              // while next row band
-
-    } else {
-        // No interpolation
-
-        // prevSrcPosList = source positions from the previous row; these are used to compute pixel area;
-        // to begin, compute sources positions corresponding to destination row = -1
-        std::vector<lsst::geom::Point2D> destPosList;
-        destPosList.reserve(1 + destWidth);
-        for (int col = -1; col < destWidth; ++col) {
-            destPosList.emplace_back(lsst::geom::Point2D(col, -1));
+        std::vector<int> bandNumGoodPixels(nBands, 0);
+        detail::parallelFor(nBands, nThreads, [&](int band) {
+            bandNumGoodPixels[band] =
+                    warpRows(*bandWarpers[band], *bandTransforms[band], bands[band], bands[band + 1]);
+        });
+        for (int band = 0; band < nBands; ++band) {
+            numGoodPixels += bandNumGoodPixels[band];
         }
-        auto prevSrcPosList = localDestToParentSrc->applyForward(destPosList);
-
-        for (int row = 0; row < destHeight; ++row) {
-            destPosList.clear();
-            for (int col = -1; col < destWidth; ++col) {
-                destPosList.emplace_back(lsst::geom::Point2D(col, row));
-            }
-            auto srcPosList = localDestToParentSrc->applyForward(destPosList);
-
-            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-            for (int col = 0; col < destWidth; ++col, ++destXIter) {
-                // column index = column + 1 because the first entry in srcPosList is for column -1
-                auto srcPos = srcPosList[col + 1];
-                double relativeArea =
-                        computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
-
-                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
-                                   typename image::detail::image_traits<DestImageT>::image_category())) {
-                    ++numGoodPixels;
-                }
-            }  // for col
-            // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
-            // because it will be reallocated anyway)
-            swap(srcPosList, prevSrcPosList);
-        }  // for row
-    }      // if interp
+    }
 
     return numGoodPixels;
 }
@@ -54,6 +54,7 @@ public:
     std::shared_ptr<BaseTable> makeTable(io::FitsSchemaInputMapper &mapper,
                                          std::shared_ptr<daf::base::PropertyList> metadata, int ioFlags,
                                          bool stripMetadata) const override {
+        mapper.require(AmpInfoTable::makeMinimalSchema());
         std::shared_ptr<AmpInfoTable> table = AmpInfoTable::make(mapper.finalize());
         table->setMetadata(metadata);
         return table;
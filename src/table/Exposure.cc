@@ -307,6 +307,7 @@ public:
             PersistableObjectColumnReader<cameraGeom::Detector,
                                           &ExposureRecord::setDetector>::setup("detector", mapper);
         }
+        mapper.require(ExposureTable::makeMinimalSchema());
         std::shared_ptr<ExposureTable> table = ExposureTable::make(mapper.finalize());
         table->setMetadata(metadata);
         return table;
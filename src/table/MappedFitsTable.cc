@@ -0,0 +1,452 @@
+// -*- lsst-c++ -*-
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "boost/format.hpp"
+#include "boost/preprocessor/seq/for_each.hpp"
+#include "boost/regex.hpp"
+
+#include "fitsio.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/daf/base/PropertyList.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/table/MappedFitsTable.h"
+#include "lsst/afw/table/io/FitsSchemaInputMapper.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+bool const HOST_IS_BIG_ENDIAN = true;
+#else
+bool const HOST_IS_BIG_ENDIAN = false;
+#endif
+
+// A read-only memory map of a range of bytes in a file.
+class FileMapping {
+public:
+    FileMapping(std::string const &filename, std::size_t offset, std::size_t size) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw LSST_EXCEPT(pex::exceptions::IoError, (boost::format("Could not open '%s': %s") %
+                                                         filename % std::strerror(errno))
+                                                                .str());
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < offset + size) {
+            ::close(fd);
+            throw LSST_EXCEPT(fits::FitsError,
+                              (boost::format("File '%s' does not contain the table data; is it compressed?") %
+                               filename)
+                                      .str());
+        }
+        // mmap requires an offset that is a multiple of the page size
+        std::size_t const pageSize = ::sysconf(_SC_PAGESIZE);
+        std::size_t const start = offset - offset % pageSize;
+        _length = offset + size - start;
+        _base = ::mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, start);
+        int const mmapErrno = errno;
+        ::close(fd);
+        if (_base == MAP_FAILED) {
+            throw LSST_EXCEPT(pex::exceptions::IoError, (boost::format("Could not map '%s': %s") % filename %
+                                                         std::strerror(mmapErrno))
+                                                                .str());
+        }
+        _data = static_cast<char const *>(_base) + (offset - start);
+    }
+
+    // Neither copyable nor moveable.
+    FileMapping(FileMapping const &) = delete;
+    FileMapping(FileMapping &&) = delete;
+    FileMapping &operator=(FileMapping const &) = delete;
+    FileMapping &operator=(FileMapping &&) = delete;
+
+    ~FileMapping() { ::munmap(_base, _length); }
+
+    /// Return a pointer to the byte at the offset passed to the constructor.
+    char const *getData() const { return _data; }
+
+private:
+    void *_base;
+    std::size_t _length;
+    char const *_data;
+};
+
+// The layout of a FITS binary table column, as described by its TFORMn, TZEROn and TSCALn keys.
+struct ColumnLayout {
+    char code;              // FITS type code
+    bool isVariableLength;  // true for 'P' and 'Q' (heap descriptor) columns
+    int repeat;             // number of elements (bits for 'X' columns)
+    std::size_t offset;     // offset of the column from the start of the row, in bytes
+    double zero;
+    double scale;
+
+    std::size_t getWidth() const {
+        if (isVariableLength) {
+            return code == 'Q' ? 16 : 8;
+        }
+        switch (code) {
+            case 'X':
+                return (repeat + 7) / 8;
+            case 'I':
+                return 2 * repeat;
+            case 'J':
+            case 'E':
+                return 4 * repeat;
+            case 'K':
+            case 'D':
+            case 'C':
+                return 8 * repeat;
+            case 'M':
+                return 16 * repeat;
+            default:  // 'L', 'B', 'S' and 'A'
+                return repeat;
+        }
+    }
+};
+
+ColumnLayout parseColumnLayout(daf::base::PropertyList const &metadata, int n, std::size_t offset) {
+    // Regex to unpack a FITS TFORM value: an optional repeat count, an optional P or Q for a variable-length
+    // array (followed by the real type code), then the type code; anything after that is ignored.
+    static boost::regex const regex("(\\d+)?([PQ])?(\\u).*", boost::regex::perl);
+    std::string const suffix = std::to_string(n + 1);
+    std::string const tform = metadata.get<std::string>("TFORM" + suffix);
+    boost::smatch m;
+    if (!boost::regex_match(tform, m, regex)) {
+        throw LSST_EXCEPT(fits::FitsError, (boost::format("Invalid TFORM%d: '%s'") % (n + 1) % tform).str());
+    }
+    ColumnLayout layout;
+    layout.isVariableLength = m[2].matched;
+    layout.code = layout.isVariableLength ? m[2].str()[0] : m[3].str()[0];
+    layout.repeat = m[1].matched ? std::stoi(m[1].str()) : 1;
+    layout.offset = offset;
+    layout.zero = metadata.exists("TZERO" + suffix) ? metadata.getAsDouble("TZERO" + suffix) : 0.0;
+    layout.scale = metadata.exists("TSCAL" + suffix) ? metadata.getAsDouble("TSCAL" + suffix) : 1.0;
+    return layout;
+}
+
+// The type of a field's elements on disk, and how to convert them to the field type.
+template <typename T>
+struct ColumnTraits {
+    typedef T Stored;
+    static T convert(Stored value) { return value; }
+};
+
+template <>
+struct ColumnTraits<lsst::geom::Angle> {
+    typedef double Stored;
+    static lsst::geom::Angle convert(Stored value) { return value * lsst::geom::radians; }
+};
+
+// The FITS type code of the column that holds each field type.
+template <typename T>
+char getFitsCode();
+template <>
+char getFitsCode<std::uint8_t>() {
+    return 'B';
+}
+template <>
+char getFitsCode<std::uint16_t>() {
+    return 'I';
+}
+template <>
+char getFitsCode<std::int32_t>() {
+    return 'J';
+}
+template <>
+char getFitsCode<std::int64_t>() {
+    return 'K';
+}
+template <>
+char getFitsCode<float>() {
+    return 'E';
+}
+template <>
+char getFitsCode<double>() {
+    return 'D';
+}
+template <>
+char getFitsCode<lsst::geom::Angle>() {
+    return 'D';
+}
+
+// Return the offset (TZEROn) that cfitsio applies to an element type, or throw if the column is scaled in
+// a way we don't support.  The only offsets cfitsio uses when writing the types we can read are the ones
+// that store unsigned integers in signed FITS columns.
+template <typename T>
+typename ColumnTraits<T>::Stored getZero(ColumnLayout const &layout, std::string const &name) {
+    typedef typename ColumnTraits<T>::Stored Stored;
+    if (layout.scale == 1.0 && layout.zero == 0.0) {
+        return 0;
+    }
+    if (std::is_unsigned<Stored>::value && sizeof(Stored) > 1 && layout.scale == 1.0 &&
+        layout.zero == std::ldexp(1.0, 8 * sizeof(Stored) - 1)) {
+        return static_cast<Stored>(layout.zero);
+    }
+    throw LSST_EXCEPT(pex::exceptions::LogicError,
+                      (boost::format("Column '%s' has unsupported scaling (TZERO=%g, TSCAL=%g)") % name %
+                       layout.zero % layout.scale)
+                              .str());
+}
+
+// Read a big-endian element from the table data.
+template <typename T>
+T readElement(char const *data, typename ColumnTraits<T>::Stored zero) {
+    typedef typename ColumnTraits<T>::Stored Stored;
+    char bytes[sizeof(Stored)];
+    if (HOST_IS_BIG_ENDIAN) {
+        std::copy(data, data + sizeof(Stored), bytes);
+    } else {
+        std::reverse_copy(data, data + sizeof(Stored), bytes);
+    }
+    Stored value;
+    std::memcpy(&value, bytes, sizeof(Stored));
+    return ColumnTraits<T>::convert(static_cast<Stored>(value + zero));
+}
+
+}  // namespace
+
+class MappedFitsTable::Impl {
+public:
+    Impl(std::string const &filename, int hdu);
+
+    // Return the layout of the column that holds the given field.
+    template <typename T>
+    ColumnLayout const &findColumn(std::string const &name, int elementCount) const;
+
+    // Return a pointer to a cell in the mapped table data.
+    char const *getCell(std::size_t row, ColumnLayout const &layout) const {
+        return data + row * rowLength + layout.offset;
+    }
+
+    // Return true if a column can be returned as a view into the mapped table data.
+    template <typename T>
+    bool isViewable(ColumnLayout const &layout, typename ColumnTraits<T>::Stored zero) const {
+        return (HOST_IS_BIG_ENDIAN || sizeof(T) == 1) && zero == 0 && rowLength % sizeof(T) == 0 &&
+               reinterpret_cast<std::uintptr_t>(getCell(0, layout)) % alignof(T) == 0;
+    }
+
+    // Return a view of the cached array for the given cache key, calling make() and caching its result if
+    // there is none.  The array is made without holding the lock, so different columns can be converted
+    // at once; if two threads convert the same column, the first to finish wins.  The cached array itself
+    // is never copied, as its ndarray manager's reference count is not thread-safe; instead each view
+    // gets its own manager, which shares ownership of the cached array.
+    template <typename ArrayT, typename Make>
+    ArrayT getCached(std::string const &cacheKey, Make make) {
+        std::shared_ptr<ArrayT const> cached;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto iter = cache.find(cacheKey);
+            if (iter != cache.end()) {
+                cached = std::static_pointer_cast<ArrayT const>(iter->second);
+            }
+        }
+        if (!cached) {
+            auto array = std::make_shared<ArrayT const>(make());
+            std::lock_guard<std::mutex> lock(mutex);
+            cached = std::static_pointer_cast<ArrayT const>(cache.emplace(cacheKey, array).first->second);
+        }
+        return ndarray::external(cached->getData(), cached->getShape(), cached->getStrides(), cached);
+    }
+
+    Schema schema;
+    std::size_t nRows;
+    std::size_t rowLength;
+    std::map<std::string, ColumnLayout> columns;  // keyed by TTYPEn
+    std::map<std::string, int> flagBits;          // keyed by TFLAGn
+    ColumnLayout const *flagColumn;                // null if there are no Flag fields
+    std::shared_ptr<FileMapping> mapping;
+    char const *data;  // the first row of the table in the mapping
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<void const>> cache;  // converted columns, keyed by field name
+};
+
+MappedFitsTable::Impl::Impl(std::string const &filename, int hdu) : flagColumn(nullptr), data(nullptr) {
+    fits::Fits fitsfile(filename, "r", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+    fitsfile.setHdu(hdu);
+    daf::base::PropertyList metadata;
+    fitsfile.readMetadata(metadata, false);
+    if (metadata.get("XTENSION", std::string()) != "BINTABLE") {
+        throw LSST_EXCEPT(fits::FitsError, (boost::format("HDU %d of '%s' is not a binary table") %
+                                            fitsfile.getHdu() % filename)
+                                                   .str());
+    }
+    nRows = metadata.get<int>("NAXIS2");
+    rowLength = metadata.get<int>("NAXIS1");
+
+    // Work out where each column is in a row, and index the columns and flag bits by name.
+    int const nColumns = metadata.get<int>("TFIELDS");
+    std::vector<ColumnLayout> layouts;
+    std::size_t offset = 0;
+    for (int n = 0; n < nColumns; ++n) {
+        layouts.push_back(parseColumnLayout(metadata, n, offset));
+        offset += layouts.back().getWidth();
+    }
+    if (offset != rowLength) {
+        throw LSST_EXCEPT(fits::FitsError,
+                          (boost::format("Column widths sum to %d bytes, but NAXIS1=%d") % offset % rowLength)
+                                  .str());
+    }
+    int const flagColumnNumber = metadata.get("FLAGCOL", 0) - 1;
+    for (int n = 0; n < nColumns; ++n) {
+        std::string const ttype = metadata.get("TTYPE" + std::to_string(n + 1), std::string());
+        if (n == flagColumnNumber) {
+            flagColumn = &columns.emplace("", layouts[n]).first->second;
+        } else if (!ttype.empty()) {
+            columns.emplace(ttype, layouts[n]);
+        }
+    }
+    if (flagColumn) {
+        for (int bit = 0; bit < flagColumn->repeat; ++bit) {
+            std::string const name = metadata.get("TFLAG" + std::to_string(bit + 1), std::string());
+            if (!name.empty()) {
+                flagBits.emplace(name, bit);
+            }
+        }
+    }
+    io::FitsSchemaInputMapper mapper(metadata, false);
+    schema = mapper.finalize();
+
+    // Map the header and the table data (but not the heap).  We check that the mapped header is the one
+    // cfitsio read, to catch compressed files, for which cfitsio's offsets are not offsets into the file.
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    fits_get_hduaddrll(reinterpret_cast<fitsfile *>(fitsfile.fptr), &headStart, &dataStart, &dataEnd,
+                       &fitsfile.status);
+    LSST_FITS_CHECK_STATUS(fitsfile, "Getting the location of the table data");
+    mapping = std::make_shared<FileMapping>(filename, headStart, dataStart - headStart + nRows * rowLength);
+    static char const expected[] = "XTENSION= 'BINTABLE'";
+    if (std::strncmp(mapping->getData(), expected, sizeof(expected) - 1) != 0) {
+        throw LSST_EXCEPT(fits::FitsError,
+                          (boost::format("Cannot map '%s'; only uncompressed FITS files can be mapped") %
+                           filename)
+                                  .str());
+    }
+    data = mapping->getData() + (dataStart - headStart);
+}
+
+template <typename T>
+ColumnLayout const &MappedFitsTable::Impl::findColumn(std::string const &name, int elementCount) const {
+    auto iter = columns.find(name);
+    if (iter == columns.end() || iter->first.empty()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          (boost::format("Field '%s' is not stored directly in a FITS column") % name).str());
+    }
+    ColumnLayout const &layout = iter->second;
+    if (layout.code != getFitsCode<T>() || layout.isVariableLength || layout.repeat != elementCount) {
+        throw LSST_EXCEPT(
+                pex::exceptions::LogicError,
+                (boost::format("Column '%s' does not hold %d elements of type %s") % name % elementCount %
+                 Field<T>::getTypeString())
+                        .str());
+    }
+    return layout;
+}
+
+MappedFitsTable::MappedFitsTable(std::string const &filename, int hdu)
+        : _impl(std::make_shared<Impl>(filename, hdu)) {}
+
+MappedFitsTable::~MappedFitsTable() = default;
+
+Schema MappedFitsTable::getSchema() const { return _impl->schema; }
+
+std::size_t MappedFitsTable::size() const { return _impl->nRows; }
+
+template <typename T>
+ndarray::Array<T const, 1> MappedFitsTable::operator[](Key<T> const &key) const {
+    std::string const name = _impl->schema.find(key).field.getName();
+    ColumnLayout const &layout = _impl->findColumn<T>(name, 1);
+    auto const zero = getZero<T>(layout, name);
+    if (_impl->isViewable<T>(layout, zero)) {
+        return ndarray::external(reinterpret_cast<T const *>(_impl->getCell(0, layout)),
+                                 ndarray::makeVector(_impl->nRows),
+                                 ndarray::makeVector(_impl->rowLength / sizeof(T)), _impl);
+    }
+    Impl const &impl = *_impl;
+    return _impl->getCached<ndarray::Array<T const, 1, 1>>(name, [&impl, &layout, zero]() {
+        ndarray::Array<T, 1, 1> result = ndarray::allocate(impl.nRows);
+        for (std::size_t row = 0; row < impl.nRows; ++row) {
+            result[row] = readElement<T>(impl.getCell(row, layout), zero);
+        }
+        return result;
+    });
+}
+
+template <typename T>
+ndarray::Array<T const, 2, 1> MappedFitsTable::operator[](Key<Array<T>> const &key) const {
+    if (key.isVariableLength()) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Variable-length array fields cannot be mapped");
+    }
+    std::string const name = _impl->schema.find(key).field.getName();
+    int const size = key.getSize();
+    ColumnLayout const &layout = _impl->findColumn<T>(name, size);
+    auto const zero = getZero<T>(layout, name);
+    if (_impl->isViewable<T>(layout, zero)) {
+        return ndarray::static_dimension_cast<1>(
+                ndarray::external(reinterpret_cast<T const *>(_impl->getCell(0, layout)),
+                                  ndarray::makeVector(_impl->nRows, static_cast<std::size_t>(size)),
+                                  ndarray::makeVector(_impl->rowLength / sizeof(T), std::size_t(1)), _impl));
+    }
+    Impl const &impl = *_impl;
+    return _impl->getCached<ndarray::Array<T const, 2, 2>>(name, [&impl, &layout, size, zero]() {
+        ndarray::Array<T, 2, 2> result = ndarray::allocate(impl.nRows, size);
+        for (std::size_t row = 0; row < impl.nRows; ++row) {
+            char const *cell = impl.getCell(row, layout);
+            for (int i = 0; i < size; ++i) {
+                result[row][i] = readElement<T>(cell + i * sizeof(typename ColumnTraits<T>::Stored), zero);
+            }
+        }
+        return result;
+    });
+}
+
+ndarray::Array<bool const, 1, 1> MappedFitsTable::operator[](Key<Flag> const &key) const {
+    std::string const name = _impl->schema.find(key).field.getName();
+    auto iter = _impl->flagBits.find(name);
+    if (!_impl->flagColumn || iter == _impl->flagBits.end()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          (boost::format("Flag field '%s' not found in FITS header") % name).str());
+    }
+    int const bit = iter->second;
+    Impl const &impl = *_impl;
+    return _impl->getCached<ndarray::Array<bool const, 1, 1>>(name, [&impl, bit]() {
+        // Bits are packed into bytes starting with the most significant bit of the first byte.
+        ndarray::Array<bool, 1, 1> result = ndarray::allocate(impl.nRows);
+        for (std::size_t row = 0; row < impl.nRows; ++row) {
+            std::uint8_t const byte = impl.getCell(row, *impl.flagColumn)[bit / 8];
+            result[row] = byte & (0x80 >> (bit % 8));
+        }
+        return result;
+    });
+}
+
+#define INSTANTIATE_COLUMN_ACCESSORS(r, data, T)                                                            \
+    template ndarray::Array<T const, 1> MappedFitsTable::operator[](Key<T> const &) const;                \
+    template ndarray::Array<T const, 2, 1> MappedFitsTable::operator[](Key<Array<T>> const &) const;
+
+BOOST_PP_SEQ_FOR_EACH(INSTANTIATE_COLUMN_ACCESSORS, _,
+                      (std::uint8_t)(std::uint16_t)(std::int32_t)(std::int64_t)(float)(double))
+
+template ndarray::Array<lsst::geom::Angle const, 1> MappedFitsTable::operator[](
+        Key<lsst::geom::Angle> const &) const;
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
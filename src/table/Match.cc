@@ -24,12 +24,20 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
 #include "lsst/geom/Angle.h"
 #include "lsst/afw/table/Match.h"
+#include "lsst/afw/table/detail/KdTree.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -53,12 +61,6 @@ bool operator<(RecordPos<Record1> const &s1, RecordPos<Record2> const &s2) {
     return (s1.dec < s2.dec);
 }
 
-struct CmpRecordPtr {
-    bool operator()(std::shared_ptr<SourceRecord> const s1, std::shared_ptr<SourceRecord> const s2) {
-        return s1->getY() < s2->getY();
-    }
-};
-
 /**
  * @internal Extract source positions from `set`, convert them to cartesian coordinates
  * (for faster distance checks) and sort the resulting array of `RecordPos`
@@ -141,6 +143,149 @@ lsst::geom::Angle fromUnitSphereDistanceSquared(double d2) noexcept {
     return 2.0 * std::asin(0.5 * std::sqrt(d2)) * lsst::geom::radians;
 }
 
+/**
+ * @internal Build a k-d tree of the unit vectors of an array of RecordPos.
+ *
+ * The indices of the points in the tree are their indices in `positions`.
+ */
+template <typename RecordT>
+detail::KdTree<3> makeRecordPosTree(RecordPos<RecordT> const *positions, size_t n) {
+    std::vector<detail::KdTree<3>::Point> points(n);
+    for (size_t i = 0; i < n; ++i) {
+        points[i] = {{positions[i].x, positions[i].y, positions[i].z}};
+    }
+    return detail::KdTree<3>(points);
+}
+
+/**
+ * @internal Find the indices of (and squared distances to) all positions in a tree strictly closer
+ * than a limit to a position.
+ *
+ * The candidates are sorted by index, so they are in the same order as the declination-sorted array
+ * the tree was built from.
+ */
+template <typename RecordT>
+void findCandidates(detail::KdTree<3> const &tree, RecordPos<RecordT> const &pos, double d2Limit,
+                    std::vector<std::pair<size_t, double> > &candidates) {
+    candidates.clear();
+    tree.forEachWithin({{pos.x, pos.y, pos.z}}, d2Limit,
+                       [&candidates](size_t j, double d2) { candidates.emplace_back(j, d2); });
+    std::sort(candidates.begin(), candidates.end());
+}
+
+/**
+ * @internal Divide `len` positions into bands that may be matched concurrently.
+ *
+ * Matching costs vary with source density, so we use several bands per thread to balance the load.
+ *
+ * @returns band boundaries; band i is [boundaries[i], boundaries[i + 1])
+ */
+std::vector<int> computeMatchBands(size_t len, int nThreads) {
+    int const nBands = (nThreads > 1) ? 8 * nThreads : 1;
+    std::vector<int> bands = math::detail::computeBandBoundaries(0, static_cast<int>(len), nBands);
+    if (bands.empty()) {
+        bands.push_back(0);
+    }
+    return bands;
+}
+
+/**
+ * @internal Concatenate per-band lists of matches, in band order.
+ */
+template <typename MatchT>
+std::vector<MatchT> concatenateBands(std::vector<std::vector<MatchT> > &bandMatches) {
+    size_t n = 0;
+    for (auto const &matches : bandMatches) {
+        n += matches.size();
+    }
+    std::vector<MatchT> result;
+    result.reserve(n);
+    for (auto &matches : bandMatches) {
+        std::move(matches.begin(), matches.end(), std::back_inserter(result));
+        std::vector<MatchT>().swap(matches);
+    }
+    return result;
+}
+
+/**
+ * @internal Return the indices of the records in `cat` with finite centroids, sorted by y
+ * (with ties broken by index).
+ */
+std::vector<size_t> makeSortedXyIndices(SourceCatalog const &cat) {
+    std::vector<size_t> indices;
+    indices.reserve(cat.size());
+    for (size_t i = 0; i < cat.size(); ++i) {
+        if (std::isfinite(cat[i].getX()) && std::isfinite(cat[i].getY())) {
+            indices.push_back(i);
+        }
+    }
+    std::stable_sort(indices.begin(), indices.end(),
+                     [&cat](size_t a, size_t b) { return cat[a].getY() < cat[b].getY(); });
+    return indices;
+}
+
+/**
+ * @internal A record found by a search of an XyIndex
+ */
+struct XyCandidate {
+    double y;
+    size_t index;
+    double d2;
+};
+
+/**
+ * @internal Order candidates by y, with ties broken by index: the order of makeSortedXyIndices.
+ */
+bool operator<(XyCandidate const &c1, XyCandidate const &c2) {
+    return c1.y < c2.y || (c1.y == c2.y && c1.index < c2.index);
+}
+
+/**
+ * @internal Find the indices of (and squared distances to) all records in an index strictly closer
+ * than a limit to a position, in the order of makeSortedXyIndices.
+ */
+void findXyCandidates(XyIndex const &index, SourceCatalog const &cat, double x, double y, double d2Limit,
+                      std::vector<XyCandidate> &candidates) {
+    candidates.clear();
+    index.getTree().forEachWithin({{x, y}}, d2Limit, [&candidates, &cat](size_t j, double d2) {
+        candidates.push_back({cat[j].getY(), j, d2});
+    });
+    std::sort(candidates.begin(), candidates.end());
+}
+
+/**
+ * @internal Self-match a catalog, given an index of it.
+ */
+SourceMatchVector matchXySelf(SourceCatalog const &cat, XyIndex const &index, double radius,
+                              MatchControl const &mc) {
+    double const r2 = radius * radius;
+    std::vector<size_t> const pos = makeSortedXyIndices(cat);
+
+    int const nThreads = math::detail::resolveNThreads(mc.nThreads);
+    std::vector<int> const bands = computeMatchBands(pos.size(), nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    std::vector<SourceMatchVector> bandMatches(nBands);
+    math::detail::parallelFor(nBands, nThreads, [&](int band) {
+        SourceMatchVector &bandResult = bandMatches[band];
+        std::vector<XyCandidate> candidates;
+        for (size_t i = bands[band]; i < static_cast<size_t>(bands[band + 1]); ++i) {
+            SourceRecord const &record = cat[pos[i]];
+            findXyCandidates(index, cat, record.getX(), record.getY(), r2, candidates);
+            // each pair is reported once, from the record that is first in y order
+            XyCandidate const self = {record.getY(), pos[i], 0.0};
+            for (auto j = std::upper_bound(candidates.begin(), candidates.end(), self);
+                 j != candidates.end(); ++j) {
+                double d = std::sqrt(j->d2);
+                bandResult.push_back(SourceMatch(cat.get(pos[i]), cat.get(j->index), d));
+                if (mc.symmetricMatch) {
+                    bandResult.push_back(SourceMatch(cat.get(j->index), cat.get(pos[i]), d));
+                }
+            }
+        }
+    });
+    return concatenateBands(bandMatches);
+}
+
 }  // namespace
 
 template <typename Cat1, typename Cat2>
@@ -184,45 +329,45 @@ std::vector<Match<typename Cat1::Record, typename Cat2::Record> > matchRaDec(Cat
     len1 = makeRecordPositions(cat1, pos1.get());
     len2 = makeRecordPositions(cat2, pos2.get());
     std::shared_ptr<typename Cat2::Record> nullRecord = std::shared_ptr<typename Cat2::Record>();
-
-    for (size_t i = 0, start = 0; i < len1; ++i) {
-        double minDec = pos1[i].dec - radius.asRadians();
-        while (start < len2 && pos2[start].dec < minDec) {
-            ++start;
-        }
-        if (start == len2) {
-            break;
-        }
-        double maxDec = pos1[i].dec + radius.asRadians();
-        size_t closestIndex = -1;    // Index of closest match (if any)
-        double d2Include = d2Limit;  // Squared distance for inclusion of match
-        bool found = false;          // Found anything?
-        size_t nMatches = 0;         // Number of matches
-        for (size_t j = start; j < len2 && pos2[j].dec <= maxDec; ++j) {
-            double dx = pos1[i].x - pos2[j].x;
-            double dy = pos1[i].y - pos2[j].y;
-            double dz = pos1[i].z - pos2[j].z;
-            double d2 = dx * dx + dy * dy + dz * dz;
-            if (d2 < d2Include) {
-                if (mc.findOnlyClosest) {
-                    d2Include = d2;
-                    closestIndex = j;
-                    found = true;
-                } else {
-                    matches.push_back(MatchT(pos1[i].src, pos2[j].src, fromUnitSphereDistanceSquared(d2)));
+    detail::KdTree<3> const tree = makeRecordPosTree(pos2.get(), len2);
+
+    // Bands of cat1 are matched independently and the results concatenated in order, and the
+    // candidates for each source are considered in declination order, so the result does not depend
+    // on the number of threads, and is the same as a scan of the declination-sorted cat2.
+    int const nThreads = math::detail::resolveNThreads(mc.nThreads);
+    std::vector<int> const bands = computeMatchBands(len1, nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    std::vector<std::vector<MatchT> > bandMatches(nBands);
+    math::detail::parallelFor(nBands, nThreads, [&](int band) {
+        std::vector<MatchT> &bandResult = bandMatches[band];
+        std::vector<std::pair<size_t, double> > candidates;
+        for (size_t i = bands[band]; i < static_cast<size_t>(bands[band + 1]); ++i) {
+            findCandidates(tree, pos1[i], d2Limit, candidates);
+            if (candidates.empty()) {
+                if (mc.includeMismatches) {
+                    bandResult.push_back(MatchT(pos1[i].src, nullRecord, NAN));
+                }
+                continue;
+            }
+            if (mc.findOnlyClosest) {
+                // the first of the closest candidates, as in a scan
+                auto closest = candidates.begin();
+                for (auto j = candidates.begin() + 1; j != candidates.end(); ++j) {
+                    if (j->second < closest->second) {
+                        closest = j;
+                    }
+                }
+                bandResult.push_back(MatchT(pos1[i].src, pos2[closest->first].src,
+                                            fromUnitSphereDistanceSquared(closest->second)));
+            } else {
+                for (auto const &candidate : candidates) {
+                    bandResult.push_back(MatchT(pos1[i].src, pos2[candidate.first].src,
+                                                fromUnitSphereDistanceSquared(candidate.second)));
                 }
-                ++nMatches;
             }
         }
-        if (mc.includeMismatches && nMatches == 0) {
-            matches.push_back(MatchT(pos1[i].src, nullRecord, NAN));
-        }
-        if (mc.findOnlyClosest && found) {
-            matches.push_back(
-                    MatchT(pos1[i].src, pos2[closestIndex].src, fromUnitSphereDistanceSquared(d2Include)));
-        }
-    }
-    return matches;
+    });
+    return concatenateBands(bandMatches);
 }
 
 #define LSST_MATCH_RADEC(RTYPE, C1, C2)                                         \
@@ -266,24 +411,30 @@ std::vector<Match<typename Cat::Record, typename Cat::Record> > matchRaDec(Cat c
     typedef RecordPos<typename Cat::Record> Pos;
     std::unique_ptr<Pos[]> pos(new Pos[len]);
     len = makeRecordPositions(cat, pos.get());
-
-    for (size_t i = 0; i < len; ++i) {
-        double maxDec = pos[i].dec + radius.asRadians();
-        for (size_t j = i + 1; j < len && pos[j].dec <= maxDec; ++j) {
-            double dx = pos[i].x - pos[j].x;
-            double dy = pos[i].y - pos[j].y;
-            double dz = pos[i].z - pos[j].z;
-            double d2 = dx * dx + dy * dy + dz * dz;
-            if (d2 < d2Limit) {
-                lsst::geom::Angle d = fromUnitSphereDistanceSquared(d2);
-                matches.push_back(MatchT(pos[i].src, pos[j].src, d));
+    detail::KdTree<3> const tree = makeRecordPosTree(pos.get(), len);
+
+    int const nThreads = math::detail::resolveNThreads(mc.nThreads);
+    std::vector<int> const bands = computeMatchBands(len, nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    std::vector<std::vector<MatchT> > bandMatches(nBands);
+    math::detail::parallelFor(nBands, nThreads, [&](int band) {
+        std::vector<MatchT> &bandResult = bandMatches[band];
+        std::vector<std::pair<size_t, double> > candidates;
+        for (size_t i = bands[band]; i < static_cast<size_t>(bands[band + 1]); ++i) {
+            findCandidates(tree, pos[i], d2Limit, candidates);
+            // each pair is reported once, from the source that is first in declination order
+            for (auto j = std::upper_bound(candidates.begin(), candidates.end(),
+                                           std::make_pair(i, std::numeric_limits<double>::infinity()));
+                 j != candidates.end(); ++j) {
+                lsst::geom::Angle d = fromUnitSphereDistanceSquared(j->second);
+                bandResult.push_back(MatchT(pos[i].src, pos[j->first].src, d));
                 if (mc.symmetricMatch) {
-                    matches.push_back(MatchT(pos[j].src, pos[i].src, d));
+                    bandResult.push_back(MatchT(pos[j->first].src, pos[i].src, d));
                 }
             }
         }
-    }
-    return matches;
+    });
+    return concatenateBands(bandMatches);
 }
 
 #define LSST_MATCH_RADEC(RTYPE, C)                                 \
@@ -305,79 +456,64 @@ SourceMatchVector matchXy(SourceCatalog const &cat1, SourceCatalog const &cat2,
 SourceMatchVector matchXy(SourceCatalog const &cat1, SourceCatalog const &cat2, double radius,
                           MatchControl const &mc) {
     if (&cat1 == &cat2) {
-        return matchXy(cat1, radius);
+        return matchXy(cat1, radius, mc);
     }
-    // setup match parameters
-    double const r2 = radius * radius;
+    return matchXy(cat1, cat2, XyIndex(cat2), radius, mc);
+}
 
-    // copy and sort array of pointers on y
-    size_t len1 = cat1.size();
-    size_t len2 = cat2.size();
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos1(new std::shared_ptr<SourceRecord>[len1]);
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos2(new std::shared_ptr<SourceRecord>[len2]);
-    std::shared_ptr<SourceRecord> nullRecord = std::shared_ptr<SourceRecord>();
-    size_t n = 0;
-    for (SourceCatalog::const_iterator i(cat1.begin()), e(cat1.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
-        }
-        pos1[n] = i;
-        ++n;
+SourceMatchVector matchXy(SourceCatalog const &cat1, SourceCatalog const &cat2, XyIndex const &index2,
+                          double radius, MatchControl const &mc) {
+    if (index2.size() != cat2.size()) {
+        std::ostringstream os;
+        os << "Index of " << index2.size() << " positions does not match catalog of " << cat2.size()
+           << " records";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
     }
-    len1 = n;
-    n = 0;
-    for (SourceCatalog::const_iterator i(cat2.begin()), e(cat2.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
-        }
-        pos2[n] = i;
-        ++n;
+    if (&cat1 == &cat2) {
+        return matchXySelf(cat1, index2, radius, mc);
     }
-    len2 = n;
-
-    std::sort(pos1.get(), pos1.get() + len1, CmpRecordPtr());
-    std::sort(pos2.get(), pos2.get() + len2, CmpRecordPtr());
+    // setup match parameters
+    double const r2 = radius * radius;
+    std::vector<size_t> const pos1 = makeSortedXyIndices(cat1);
+    std::shared_ptr<SourceRecord> nullRecord = std::shared_ptr<SourceRecord>();
 
-    SourceMatchVector matches;
-    for (size_t i = 0, start = 0; i < len1; ++i) {
-        double y = pos1[i]->getY();
-        double minY = y - radius;
-        while (start < len2 && pos2[start]->getY() < minY) {
-            ++start;
-        }
-        if (start == len2) {
-            break;
-        }
-        double x = pos1[i]->getX();
-        double maxY = y + radius;
-        double y2;
-        size_t closestIndex = -1;  // Index of closest match (if any)
-        double r2Include = r2;     // Squared radius for inclusion of match
-        bool found = false;        // Found anything?
-        size_t nMatches = 0;       // Number of matches
-        for (size_t j = start; j < len2 && (y2 = pos2[j]->getY()) <= maxY; ++j) {
-            double dx = x - pos2[j]->getX();
-            double dy = y - y2;
-            double d2 = dx * dx + dy * dy;
-            if (d2 < r2Include) {
-                if (mc.findOnlyClosest) {
-                    r2Include = d2;
-                    closestIndex = j;
-                    found = true;
-                } else {
-                    matches.push_back(SourceMatch(pos1[i], pos2[j], std::sqrt(d2)));
+    // As in matchRaDec, bands of cat1 are matched independently and concatenated in order, so the
+    // result does not depend on the number of threads.
+    int const nThreads = math::detail::resolveNThreads(mc.nThreads);
+    std::vector<int> const bands = computeMatchBands(pos1.size(), nThreads);
+    int const nBands = static_cast<int>(bands.size()) - 1;
+    std::vector<SourceMatchVector> bandMatches(nBands);
+    math::detail::parallelFor(nBands, nThreads, [&](int band) {
+        SourceMatchVector &bandResult = bandMatches[band];
+        std::vector<XyCandidate> candidates;
+        for (size_t i = bands[band]; i < static_cast<size_t>(bands[band + 1]); ++i) {
+            SourceRecord const &record = cat1[pos1[i]];
+            findXyCandidates(index2, cat2, record.getX(), record.getY(), r2, candidates);
+            if (candidates.empty()) {
+                if (mc.includeMismatches) {
+                    bandResult.push_back(SourceMatch(cat1.get(pos1[i]), nullRecord, NAN));
+                }
+                continue;
+            }
+            if (mc.findOnlyClosest) {
+                // the first of the closest candidates, as in a scan
+                auto closest = candidates.begin();
+                for (auto j = candidates.begin() + 1; j != candidates.end(); ++j) {
+                    if (j->d2 < closest->d2) {
+                        closest = j;
+                    }
+                }
+                bandResult.push_back(
+                        SourceMatch(cat1.get(pos1[i]), cat2.get(closest->index), std::sqrt(closest->d2)));
+            } else {
+                for (auto const &candidate : candidates) {
+                    bandResult.push_back(SourceMatch(cat1.get(pos1[i]), cat2.get(candidate.index),
+                                                     std::sqrt(candidate.d2)));
                 }
-                ++nMatches;
             }
         }
-        if (mc.includeMismatches && nMatches == 0) {
-            matches.push_back(SourceMatch(pos1[i], nullRecord, NAN));
-        }
-        if (mc.findOnlyClosest && found) {
-            matches.push_back(SourceMatch(pos1[i], pos2[closestIndex], std::sqrt(r2Include)));
-        }
-    }
-    return matches;
+    });
+    return concatenateBands(bandMatches);
 }
 
 SourceMatchVector matchXy(SourceCatalog const &cat, double radius, bool symmetric) {
@@ -388,44 +524,65 @@ SourceMatchVector matchXy(SourceCatalog const &cat, double radius, bool symmetri
 }
 
 SourceMatchVector matchXy(SourceCatalog const &cat, double radius, MatchControl const &mc) {
-    // setup match parameters
-    double const r2 = radius * radius;
+    return matchXySelf(cat, XyIndex(cat), radius, mc);
+}
 
-    // copy and sort array of pointers on y
-    size_t len = cat.size();
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos(new std::shared_ptr<SourceRecord>[len]);
-    size_t n = 0;
-    for (SourceCatalog::const_iterator i(cat.begin()), e(cat.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
+namespace {
+
+detail::KdTree<2> makeXyTree(size_t n, std::function<double(size_t)> const &getX,
+                             std::function<double(size_t)> const &getY) {
+    std::vector<detail::KdTree<2>::Point> points;
+    std::vector<size_t> indices;
+    points.reserve(n);
+    indices.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        double const x = getX(i);
+        double const y = getY(i);
+        if (std::isfinite(x) && std::isfinite(y)) {
+            points.push_back({{x, y}});
+            indices.push_back(i);
         }
-        pos[n] = i;
-        ++n;
     }
-    len = n;
-
-    std::sort(pos.get(), pos.get() + len, CmpRecordPtr());
-
-    SourceMatchVector matches;
-    for (size_t i = 0; i < len; ++i) {
-        double x = pos[i]->getX();
-        double y = pos[i]->getY();
-        double maxY = y + radius;
-        double y2;
-        for (size_t j = i + 1; j < len && (y2 = pos[j]->getY()) <= maxY; ++j) {
-            double dx = x - pos[j]->getX();
-            double dy = y - y2;
-            double d2 = dx * dx + dy * dy;
-            if (d2 < r2) {
-                double d = std::sqrt(d2);
-                matches.push_back(SourceMatch(pos[i], pos[j], d));
-                if (mc.symmetricMatch) {
-                    matches.push_back(SourceMatch(pos[j], pos[i], d));
-                }
-            }
-        }
+    return detail::KdTree<2>(points, indices);
+}
+
+size_t checkXySizes(ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        std::ostringstream os;
+        os << "Size of x (" << x.getSize<0>() << ") does not match size of y (" << y.getSize<0>() << ")";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
     }
-    return matches;
+    return x.getSize<0>();
+}
+
+}  // namespace
+
+XyIndex::XyIndex(SourceCatalog const &cat)
+        : _size(cat.size()),
+          _tree(makeXyTree(cat.size(), [&cat](size_t i) { return cat[i].getX(); },
+                           [&cat](size_t i) { return cat[i].getY(); })) {}
+
+XyIndex::XyIndex(ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y)
+        : _size(checkXySizes(x, y)),
+          _tree(makeXyTree(_size, [&x](size_t i) { return x[i]; }, [&y](size_t i) { return y[i]; })) {}
+
+std::vector<std::size_t> XyIndex::findWithin(lsst::geom::Point2D const &center, double radius) const {
+    std::vector<std::size_t> result;
+    _tree.forEachWithin({{center.getX(), center.getY()}}, radius * radius,
+                        [&result](std::size_t j, double) { result.push_back(j); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::size_t> XyIndex::findNearest(lsst::geom::Point2D const &center, std::size_t n) const {
+    std::vector<std::pair<double, std::size_t> > nearest;
+    _tree.findNearest({{center.getX(), center.getY()}}, n, nearest);
+    std::vector<std::size_t> result;
+    result.reserve(nearest.size());
+    for (auto const &item : nearest) {
+        result.push_back(item.second);
+    }
+    return result;
 }
 
 template <typename Record1, typename Record2>
@@ -18,8 +18,15 @@ Registry& getRegistry() {
 
 static FitsReader const baseFitsReader("BASE");
 
+// The approximate number of bytes of records to read at once.
+std::size_t const BLOCK_BYTES = 1 << 22;
+
 }  // namespace
 
+std::size_t FitsReader::_computeBlockSize(Schema const& schema) {
+    return std::max<std::size_t>(BLOCK_BYTES / std::max(schema.getRecordSize(), 1), 1);
+}
+
 std::shared_ptr<BaseTable> FitsReader::makeTable(FitsSchemaInputMapper& mapper,
                                                  std::shared_ptr<daf::base::PropertyList> metadata,
                                                  int ioFlags, bool stripMetadata) const {
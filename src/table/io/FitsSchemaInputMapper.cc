@@ -4,7 +4,9 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <set>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <cctype>
 
@@ -80,7 +82,7 @@ public:
     ByName &byName() { return inputs.get<2>(); }
     AsList &asList() { return inputs.get<3>(); }
 
-    Impl() : version(0), flagColumn(0), archiveHdu(-1) {}
+    Impl() : version(0), flagColumn(0), archiveHdu(-1), hasSelection(false) {}
 
     int version;
     std::string type;
@@ -92,6 +94,8 @@ public:
     std::unique_ptr<bool[]> flagWorkspace;
     std::shared_ptr<io::InputArchive> archive;
     InputContainer inputs;
+    bool hasSelection;                // if true, only columns in selection are mapped by finalize()
+    std::set<std::string> selection;  // names (ttypes) of the selected columns
 };
 
 FitsSchemaInputMapper::FitsSchemaInputMapper(daf::base::PropertyList &metadata, bool stripMetadata)
@@ -358,6 +362,24 @@ void FitsSchemaInputMapper::erase(int column) {
 
 void erase(int column);
 
+void FitsSchemaInputMapper::select(std::vector<std::string> const &ttypes) {
+    for (auto const &ttype : ttypes) {
+        if (_impl->byName().find(ttype) == _impl->byName().end()) {
+            throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                              (boost::format("Column '%s' not found in FITS table") % ttype).str());
+        }
+    }
+    _impl->hasSelection = true;
+    _impl->selection.insert(ttypes.begin(), ttypes.end());
+}
+
+void FitsSchemaInputMapper::require(Schema const &schema) {
+    if (_impl->hasSelection) {
+        std::set<std::string> names = schema.getNames();
+        _impl->selection.insert(names.begin(), names.end());
+    }
+}
+
 void FitsSchemaInputMapper::customize(std::unique_ptr<FitsColumnReader> reader) {
     _impl->readers.push_back(std::move(reader));
 }
@@ -380,6 +402,17 @@ public:
         fits.readTableArray(row, _column, _key.getElementCount(), record.getElement(_key));
     }
 
+    void readCells(std::vector<BaseRecord *> const &records, std::size_t firstRow, afw::fits::Fits &fits,
+                   std::shared_ptr<InputArchive> const &archive) const override {
+        // cfitsio continues onto the next row when we ask for more elements than a fixed-size cell holds
+        std::size_t const n = _key.getElementCount();
+        std::vector<typename Field<T>::Element> buffer(records.size() * n);
+        fits.readTableArray(firstRow, _column, buffer.size(), buffer.data());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            std::copy_n(buffer.begin() + i * n, n, records[i]->getElement(_key));
+        }
+    }
+
 private:
     int _column;
     Key<T> _key;
@@ -412,6 +445,15 @@ public:
         record.set(_key, tmp * lsst::geom::radians);
     }
 
+    void readCells(std::vector<BaseRecord *> const &records, std::size_t firstRow, afw::fits::Fits &fits,
+                   std::shared_ptr<InputArchive> const &archive) const override {
+        std::vector<double> buffer(records.size());
+        fits.readTableArray(firstRow, _column, buffer.size(), buffer.data());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            records[i]->set(_key, buffer[i] * lsst::geom::radians);
+        }
+    }
+
 private:
     int _column;
     Key<lsst::geom::Angle> _key;
@@ -453,15 +495,31 @@ public:
 
     void readCell(BaseRecord &record, std::size_t row, afw::fits::Fits &fits,
                   std::shared_ptr<InputArchive> const &archive) const override {
-        int size = fits.getTableArraySize(row, _column);
-        ndarray::Array<T, 1, 1> array = ndarray::allocate(size);
-        fits.readTableArray(row, _column, size, array.getData());
+        if (row == 0 || row + 1 >= _offsets.size()) {
+            _allocatePool(fits);
+        }
+        ndarray::Array<T, 1, 1> array = _pool[ndarray::view(_offsets[row], _offsets[row + 1])];
+        fits.readTableArray(row, _column, array.template getSize<0>(), array.getData());
         record.set(_key, array);
     }
 
 private:
+    // Rather than allocating an array for every row, read all the array sizes up front and allocate
+    // a single buffer for the whole column; each record then holds a view into that buffer.
+    void _allocatePool(afw::fits::Fits &fits) const {
+        std::vector<long> sizes = fits.getTableArraySizes(_column);
+        _offsets.assign(1, 0);
+        _offsets.reserve(sizes.size() + 1);
+        for (auto size : sizes) {
+            _offsets.push_back(_offsets.back() + size);
+        }
+        _pool = ndarray::allocate(_offsets.back());
+    }
+
     int _column;
     Key<Array<T>> _key;
+    mutable std::vector<std::size_t> _offsets;  // _pool[_offsets[row]:_offsets[row + 1]] holds row
+    mutable ndarray::Array<T, 1, 1> _pool;
 };
 
 // Read a 2-element FITS array column as separate x and y Schema fields (hence converting
@@ -737,6 +795,15 @@ std::string replace(std::string full, std::string const & from, std::string cons
 }  // namespace
 
 Schema FitsSchemaInputMapper::finalize() {
+    if (_impl->hasSelection) {
+        for (auto iter = _impl->asList().begin(); iter != _impl->asList().end();) {
+            if (_impl->selection.count(iter->ttype)) {
+                ++iter;
+            } else {
+                iter = _impl->asList().erase(iter);
+            }
+        }
+    }
     if (_impl->version == 0) {
         AliasMap &aliases = *_impl->schema.getAliasMap();
         for (auto iter = _impl->asList().begin(); iter != _impl->asList().end(); ++iter) {
@@ -826,17 +893,53 @@ Schema FitsSchemaInputMapper::finalize() {
     return _impl->schema;
 }
 
+namespace {
+
+// Return true if any Flag field is being read (some may not have been selected).
+bool hasFlags(std::vector<Key<Flag>> const &flagKeys) {
+    return std::any_of(flagKeys.begin(), flagKeys.end(), [](Key<Flag> const &key) { return key.isValid(); });
+}
+
+}  // namespace
+
 void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits, std::size_t row) {
-    if (!_impl->flagKeys.empty()) {
+    if (hasFlags(_impl->flagKeys)) {
         fits.readTableArray<bool>(row, _impl->flagColumn, _impl->flagKeys.size(), _impl->flagWorkspace.get());
         for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
-            record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            if (_impl->flagKeys[bit].isValid()) {
+                record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            }
         }
     }
     for (auto iter = _impl->readers.begin(); iter != _impl->readers.end(); ++iter) {
         (**iter).readCell(record, row, fits, _impl->archive);
     }
 }
+
+void FitsSchemaInputMapper::readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits,
+                                        std::size_t firstRow) {
+    if (records.empty()) {
+        return;
+    }
+    if (hasFlags(_impl->flagKeys)) {
+        // Read the packed bits of the whole block as bytes; the first flag is the most significant bit
+        // of the first byte of each row.
+        std::size_t const nBytes = (_impl->flagKeys.size() + 7) / 8;
+        std::vector<std::uint8_t> bytes(records.size() * nBytes);
+        fits.readTableArray(firstRow, _impl->flagColumn, bytes.size(), bytes.data());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            std::uint8_t const *rowBytes = bytes.data() + i * nBytes;
+            for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
+                if (_impl->flagKeys[bit].isValid()) {
+                    records[i]->set(_impl->flagKeys[bit], (rowBytes[bit / 8] & (0x80 >> (bit % 8))) != 0);
+                }
+            }
+        }
+    }
+    for (auto iter = _impl->readers.begin(); iter != _impl->readers.end(); ++iter) {
+        (**iter).readCells(records, firstRow, fits, _impl->archive);
+    }
+}
 }  // namespace io
 }  // namespace table
 }  // namespace afw
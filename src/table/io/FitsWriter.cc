@@ -1,6 +1,9 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/BaseTable.h"
@@ -122,68 +125,211 @@ void FitsWriter::_writeTable(std::shared_ptr<BaseTable const> const& table, std:
     metadata->remove("AFW_TABLE_VERSION");
     _row = -1;
     _fits->addRows(nRows);
-    _processor = std::make_shared<ProcessRecords>(_fits, schema, nFlags, _row);
+    _processor = std::make_shared<ProcessRecords>(_fits, schema, nFlags, nRows, _row);
 }
 
 //----- Code for writing FITS records -----------------------------------------------------------------------
 
-// The driver code is at the bottom of this section; it's easier to understand if you start there
-// and work your way up.
+// Rather than writing each field of each record with its own cfitsio call, we copy the fields of a block of
+// consecutive records into one buffer per column, and then write each column of the block with a single
+// call.  cfitsio still does all of the conversion to FITS (big-endian) form, so the file is the same as
+// the one we'd get by writing one cell at a time.
+
+namespace {
+
+// The approximate number of bytes of record data to buffer before writing a block of rows.
+std::size_t const BLOCK_BYTES = 1 << 22;
+
+// Holds the values of a single column for a block of consecutive rows.
+class ColumnBuffer {
+public:
+    // Copy the value for this column from a record in the given row; some columns write it immediately.
+    virtual void append(Fits& fits, BaseRecord const& record, std::size_t row) = 0;
+
+    // Write all buffered values, starting at the given row, and empty the buffer.
+    virtual void flush(Fits& fits, std::size_t firstRow) = 0;
+
+    virtual ~ColumnBuffer() = default;
+};
+
+// A buffer for a fixed-size column: scalars and fixed-length arrays.
+template <typename T>
+class FixedColumnBuffer : public ColumnBuffer {
+public:
+    FixedColumnBuffer(int col, Key<T> const& key, std::size_t blockSize) : _col(col), _key(key) {
+        _values.reserve(blockSize * key.getElementCount());
+    }
+
+    void append(Fits& fits, BaseRecord const& record, std::size_t row) override {
+        typename Field<T>::Element const* element = record.getElement(_key);
+        _values.insert(_values.end(), element, element + _key.getElementCount());
+    }
+
+    void flush(Fits& fits, std::size_t firstRow) override {
+        // For fixed-size columns cfitsio continues onto the next row when nElements exceeds the
+        // column's repeat count.
+        if (!_values.empty()) fits.writeTableArray(firstRow, _col, _values.size(), _values.data());
+        _values.clear();
+    }
+
+private:
+    int _col;
+    Key<T> _key;
+    std::vector<typename Field<T>::Element> _values;
+};
+
+// Variable-length arrays go to the heap in the order they are written, so we still write them one row at
+// a time, in the same order as the unbuffered writer did.
+template <typename T>
+class VariableLengthColumnBuffer : public ColumnBuffer {
+public:
+    VariableLengthColumnBuffer(int col, Key<Array<T>> const& key) : _col(col), _key(key) {}
+
+    void append(Fits& fits, BaseRecord const& record, std::size_t row) override {
+        ndarray::Array<T const, 1, 1> array = record.get(_key);
+        fits.writeTableArray(row, _col, array.template getSize<0>(), array.getData());
+    }
+
+    void flush(Fits& fits, std::size_t firstRow) override {}
+
+private:
+    int _col;
+    Key<Array<T>> _key;
+};
+
+// A buffer for a fixed-length string column.
+class StringColumnBuffer : public ColumnBuffer {
+public:
+    StringColumnBuffer(int col, Key<std::string> const& key, std::size_t blockSize) : _col(col), _key(key) {
+        _values.reserve(blockSize);
+    }
+
+    void append(Fits& fits, BaseRecord const& record, std::size_t row) override {
+        _values.push_back(record.get(_key));
+    }
+
+    void flush(Fits& fits, std::size_t firstRow) override {
+        if (!_values.empty()) fits.writeTableStrings(firstRow, _col, _values);
+        _values.clear();
+    }
 
-// A Schema::forEach functor that writes table data for a single record when it is called.
-// We instantiate one of these, then reuse it on all the records after updating the data
-// members that tell it which record and row number it's on.
+private:
+    int _col;
+    Key<std::string> _key;
+    std::vector<std::string> _values;
+};
+
+// Variable-length strings, like variable-length arrays, are written one row at a time.
+class VariableLengthStringColumnBuffer : public ColumnBuffer {
+public:
+    VariableLengthStringColumnBuffer(int col, Key<std::string> const& key) : _col(col), _key(key) {}
+
+    void append(Fits& fits, BaseRecord const& record, std::size_t row) override {
+        fits.writeTableScalar(row, _col, record.get(_key));
+    }
+
+    void flush(Fits& fits, std::size_t firstRow) override {}
+
+private:
+    int _col;
+    Key<std::string> _key;
+};
+
+// A buffer for the bit column that holds all Flag fields.
+//
+// We pack the bits ourselves, as the FITS standard lays them out for an 'X' column (the first bit in the
+// most significant bit of the first byte, with the last byte padded with zeros), and write them as bytes.
+class FlagColumnBuffer : public ColumnBuffer {
+public:
+    void addKey(Key<Flag> const& key) { _keys.push_back(key); }
+
+    void append(Fits& fits, BaseRecord const& record, std::size_t row) override {
+        std::size_t const offset = _bytes.size();
+        _bytes.resize(offset + (_keys.size() + 7) / 8, 0);
+        std::uint8_t* bytes = _bytes.data() + offset;
+        for (std::size_t bit = 0; bit < _keys.size(); ++bit) {
+            if (record.get(_keys[bit])) bytes[bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+
+    void flush(Fits& fits, std::size_t firstRow) override {
+        if (!_bytes.empty()) fits.writeTableArray(firstRow, 0, _bytes.size(), _bytes.data());
+        _bytes.clear();
+    }
+
+private:
+    std::vector<Key<Flag>> _keys;
+    std::vector<std::uint8_t> _bytes;
+};
+
+}  // namespace
+
+// A Schema::forEach functor that sets up a buffer for each column when it is constructed, and then
+// buffers or writes the fields of each record it is applied to, writing the buffers whenever a block of
+// rows is complete and after the last row.
 struct FitsWriter::ProcessRecords {
     template <typename T>
     void operator()(SchemaItem<T> const& item) const {
-        fits->writeTableArray(row, col, item.key.getElementCount(), record->getElement(item.key));
+        buffers.push_back(std::make_shared<FixedColumnBuffer<T>>(col, item.key, blockSize));
         ++col;
     }
 
     template <typename T>
     void operator()(SchemaItem<Array<T> > const& item) const {
         if (item.key.isVariableLength()) {
-            ndarray::Array<T const, 1, 1> array = record->get(item.key);
-            fits->writeTableArray(row, col, array.template getSize<0>(), array.getData());
+            buffers.push_back(std::make_shared<VariableLengthColumnBuffer<T>>(col, item.key));
         } else {
-            fits->writeTableArray(row, col, item.key.getElementCount(), record->getElement(item.key));
+            buffers.push_back(std::make_shared<FixedColumnBuffer<Array<T>>>(col, item.key, blockSize));
         }
         ++col;
     }
 
     void operator()(SchemaItem<std::string> const& item) const {
-        // Write fixed-length and variable-length strings the same way
-        fits->writeTableScalar(row, col, record->get(item.key));
+        if (item.key.isVariableLength()) {
+            buffers.push_back(std::make_shared<VariableLengthStringColumnBuffer>(col, item.key));
+        } else {
+            buffers.push_back(std::make_shared<StringColumnBuffer>(col, item.key, blockSize));
+        }
         ++col;
     }
 
-    void operator()(SchemaItem<Flag> const& item) const {
-        flags[bit] = record->get(item.key);
-        ++bit;
-    }
+    void operator()(SchemaItem<Flag> const& item) const { flags->addKey(item.key); }
 
-    ProcessRecords(Fits* fits_, Schema const& schema_, int nFlags_, std::size_t const& row_)
-            : row(row_), col(0), bit(0), nFlags(nFlags_), fits(fits_), schema(schema_) {
-        if (nFlags) flags.reset(new bool[nFlags]);
+    ProcessRecords(Fits* fits_, Schema const& schema, int nFlags, std::size_t nRows_, std::size_t const& row_)
+            : row(row_),
+              nRows(nRows_),
+              firstRow(0),
+              blockSize(std::max<std::size_t>(BLOCK_BYTES / std::max(schema.getRecordSize(), 1), 1)),
+              col(0),
+              fits(fits_) {
+        if (nFlags) {
+            flags = std::make_shared<FlagColumnBuffer>();
+            buffers.push_back(flags);
+            ++col;
+        }
+        schema.forEach(*this);
     }
 
-    void apply(BaseRecord const* r) {
-        record = r;
-        col = 0;
-        bit = 0;
-        if (nFlags) ++col;
-        schema.forEach(*this);
-        if (nFlags) fits->writeTableArray(row, 0, nFlags, flags.get());
+    void apply(BaseRecord const* record) {
+        for (auto const& buffer : buffers) {
+            buffer->append(*fits, *record, row);
+        }
+        if (row + 1 == nRows || row + 1 - firstRow == blockSize) {
+            for (auto const& buffer : buffers) {
+                buffer->flush(*fits, firstRow);
+            }
+            firstRow = row + 1;
+        }
     }
 
     std::size_t const& row;
+    std::size_t nRows;
+    std::size_t firstRow;  // the first row of the current block
+    std::size_t blockSize;
     mutable int col;
-    mutable int bit;
-    int nFlags;
     Fits* fits;
-    std::unique_ptr<bool[]> flags;
-    BaseRecord const* record;
-    Schema schema;
+    std::shared_ptr<FlagColumnBuffer> flags;
+    mutable std::vector<std::shared_ptr<ColumnBuffer>> buffers;  // in the order the columns are written
 };
 
 void FitsWriter::_writeRecord(BaseRecord const& record) {
@@ -657,6 +657,68 @@ class BackgroundTestCase(lsst.utils.tests.TestCase):
                 else:
                     self.assertTrue(np.isnan(val))
 
+    def testThreaded(self):
+        """Test that measuring and interpolating a background with several threads gives the same answer"""
+        rand = np.random.RandomState(12345)
+        mi = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(10, 20), lsst.geom.Extent2I(501, 403)))
+        mi.image.array[:] = 100.0 + rand.normal(0.0, 10.0, mi.image.array.shape)
+        mi.image.array[:, 0:60] = np.nan    # exercise REDUCE_INTERP_ORDER
+        mi.variance.array[:] = 100.0
+
+        sctrl = afwMath.StatisticsControl()
+        bctrl = afwMath.BackgroundControl(13, 11, sctrl, afwMath.MEANCLIP)
+        self.assertEqual(bctrl.getNThreads(), 1)
+        serial = afwMath.makeBackground(mi, bctrl)
+
+        for nThreads in (0, 4):
+            bctrl.setNThreads(nThreads)
+            self.assertEqual(bctrl.getNThreads(), nThreads)
+            threaded = afwMath.makeBackground(mi, bctrl)
+            self.assertImagesEqual(threaded.getStatsImage().image, serial.getStatsImage().image)
+            self.assertImagesEqual(threaded.getStatsImage().variance, serial.getStatsImage().variance)
+            for interpStyle in (afwMath.Interpolate.LINEAR, afwMath.Interpolate.AKIMA_SPLINE):
+                self.assertImagesEqual(threaded.getImageF(interpStyle, afwMath.REDUCE_INTERP_ORDER),
+                                       serial.getImageF(interpStyle, afwMath.REDUCE_INTERP_ORDER))
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            bctrl.setNThreads(-1)
+
+    def testInterpolationMatchesInterpolate(self):
+        """Test that getImage agrees with interpolating the statsImage using makeInterpolate
+
+        The background is computed by interpolating the columns of the statsImage in y, and then
+        each row of the result in x.
+        """
+        rand = np.random.RandomState(12345)
+        width, height = 97, 83
+        nx, ny = 7, 6
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-5, 3), lsst.geom.Extent2I(width, height))
+        statsImage = afwImage.MaskedImageF(nx, ny)
+        statsImage.image.array[:] = rand.uniform(10.0, 20.0, statsImage.image.array.shape)
+        bkgd = afwMath.BackgroundMI(bbox, statsImage)
+
+        def getCenters(size, nSample):
+            """Return the centers of the cells, as computed by Background"""
+            ends = [min(((i + 1)*size + nSample//2)//nSample, size) for i in range(nSample)]
+            starts = [0] + ends[:-1]
+            return [start + 0.5*(end - start) - 0.5 for start, end in zip(starts, ends)]
+
+        xcen = getCenters(width, nx)
+        ycen = getCenters(height, ny)
+        for interpStyle in (afwMath.Interpolate.LINEAR, afwMath.Interpolate.NATURAL_SPLINE,
+                            afwMath.Interpolate.CUBIC_SPLINE, afwMath.Interpolate.AKIMA_SPLINE):
+            columns = [afwMath.makeInterpolate(ycen, [float(v) for v in statsImage.image.array[:, iX]],
+                                               interpStyle).interpolate([float(y) for y in range(height)])
+                       for iX in range(nx)]
+            expected = np.empty((height, width))
+            for y in range(height):
+                row = afwMath.makeInterpolate(xcen, [columns[iX][y] for iX in range(nx)], interpStyle)
+                expected[y, :] = row.interpolate([float(x) for x in range(width)])
+
+            bkgdImage = bkgd.getImageF(interpStyle)
+            self.assertEqual(bkgdImage.getBBox(), bbox)
+            self.assertFloatsAlmostEqual(bkgdImage.array, expected, rtol=1e-6)
+
     def testBackgroundFromStatsImage(self):
         """Check that we can rebuild a Background from a BackgroundMI.getStatsImage()"""
         bgCtrl = afwMath.BackgroundControl(10, 10)
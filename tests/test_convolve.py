@@ -383,6 +383,151 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(
                 convControl.getMaxInterpolationDistance(), maxInterpDist)
 
+        self.assertEqual(convControl.getNThreads(), 1)
+        for nThreads in (0, 1, 4):
+            convControl.setNThreads(nThreads)
+            self.assertEqual(convControl.getNThreads(), nThreads)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            convControl.setNThreads(-1)
+
+        self.assertEqual(convControl.getMinFftKernelSize(), 0)
+        for minFftKernelSize in (0, 1, 31):
+            convControl.setMinFftKernelSize(minFftKernelSize)
+            self.assertEqual(convControl.getMinFftKernelSize(), minFftKernelSize)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            convControl.setMinFftKernelSize(-1)
+
+    def testFftConvolve(self):
+        """Test that FFT convolution matches direct convolution, including around non-finite pixels
+        """
+        rng = numpy.random.RandomState(3)
+        dims = lsst.geom.Extent2I(301, 283)  # more than one FFT tile
+        inMaskedImage = afwImage.MaskedImageD(dims)
+        inMaskedImage.setXY0(300, 200)
+        inMaskedImage.getImage().getArray()[:, :] = rng.normal(100.0, 10.0, (dims[1], dims[0]))
+        inMaskedImage.getVariance().getArray()[:, :] = rng.uniform(90.0, 110.0, (dims[1], dims[0]))
+        inMaskedImage.getMask().getArray()[50, 60] = 0x1
+        inMaskedImage.getMask().getArray()[200, 10:20] = 0x2
+        inMaskedImage.getImage().getArray()[100, 150] = numpy.nan
+        inMaskedImage.getVariance().getArray()[250, 30] = numpy.inf
+
+        kWidth = 41
+        kHeight = 37
+        gaussKernel = afwMath.AnalyticKernel(kWidth, kHeight, afwMath.GaussianFunction2D(4.0, 3.0, 0.5))
+        kernelImage = afwImage.ImageD(lsst.geom.Extent2I(kWidth, kHeight))
+        gaussKernel.computeImage(kernelImage, False)
+        kernelImage.getArray()[:, 0:5] = 0.0  # give the kernel some zero pixels
+        fixedKernel = afwMath.FixedKernel(kernelImage)
+        basisKernelList = makeGaussianKernelList(kWidth, kHeight, ((3.0, 3.0, 0.0), (5.0, 2.0, 0.3)))
+        lcKernel = afwMath.LinearCombinationKernel(basisKernelList, [0.7, 0.3])
+
+        for kernel in (fixedKernel, gaussKernel, lcKernel):
+            directControl = afwMath.ConvolutionControl()
+            fftControl = afwMath.ConvolutionControl()
+            fftControl.setMinFftKernelSize(kHeight)
+            for nThreads in (1, 4):
+                fftControl.setNThreads(nThreads)
+                directImage = afwImage.MaskedImageD(dims)
+                fftImage = afwImage.MaskedImageD(dims)
+                afwMath.convolve(directImage, inMaskedImage, kernel, directControl)
+                afwMath.convolve(fftImage, inMaskedImage, kernel, fftControl)
+                self.assertMaskedImagesAlmostEqual(fftImage, directImage, rtol=1e-10, atol=1e-10)
+
+                inImage = afwImage.makeImageFromArray(
+                    inMaskedImage.getImage().getArray().astype(numpy.float32))
+                directImage = afwImage.ImageF(dims)
+                fftImage = afwImage.ImageF(dims)
+                afwMath.convolve(directImage, inImage, kernel, directControl)
+                afwMath.convolve(fftImage, inImage, kernel, fftControl)
+                self.assertImagesAlmostEqual(fftImage, directImage, rtol=1e-6)
+
+        # kernels smaller than the threshold are convolved directly
+        fftControl.setMinFftKernelSize(kWidth + 1)
+        directImage = afwImage.MaskedImageD(dims)
+        fftImage = afwImage.MaskedImageD(dims)
+        afwMath.convolve(directImage, inMaskedImage, fixedKernel, directControl)
+        afwMath.convolve(fftImage, inMaskedImage, fixedKernel, fftControl)
+        self.assertMaskedImagesEqual(fftImage, directImage)
+
+    def testThreadedConvolve(self):
+        """Test that threaded convolution is bit-identical to serial convolution
+        """
+        rng = numpy.random.RandomState(5)
+        inMaskedImage = afwImage.MaskedImageF(lsst.geom.Extent2I(83, 97))
+        inMaskedImage.setXY0(300, 200)
+        inMaskedImage.getImage().getArray()[:, :] = rng.normal(100.0, 10.0, (97, 83))
+        inMaskedImage.getVariance().getArray()[:, :] = 100.0
+        inMaskedImage.getMask().getArray()[10, 10] = 1
+
+        sFunc = afwMath.PolynomialFunction2D(1)
+        sParams = (
+            (1.5, 0.5/83, 0.0),
+            (1.5, 0.0, 0.5/97),
+            (0.0, 0.0, 0.0),
+        )
+        gaussFunc1 = afwMath.GaussianFunction1D(1.0)
+        gaussFunc2 = afwMath.GaussianFunction2D(1.5, 1.5, 0.0)
+        varyingAnalyticKernel = afwMath.AnalyticKernel(7, 6, afwMath.GaussianFunction2D(1.0, 1.0, 0.0), sFunc)
+        varyingAnalyticKernel.setSpatialParameters(sParams)
+        varyingSeparableKernel = afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1, sFunc)
+        varyingSeparableKernel.setSpatialParameters(sParams[0:2])
+        kernelList = [
+            afwMath.AnalyticKernel(7, 6, gaussFunc2),
+            afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1),
+            afwMath.DeltaFunctionKernel(3, 3, lsst.geom.Point2I(2, 1)),
+            varyingAnalyticKernel,
+            varyingSeparableKernel,
+        ]
+
+        for kernel in kernelList:
+            for maxInterpDist in (0, 10):
+                convControl = afwMath.ConvolutionControl(True, True, maxInterpDist)
+                serialImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+                afwMath.convolve(serialImage, inMaskedImage, kernel, convControl)
+                for nThreads in (0, 2, 3, 16):
+                    convControl.setNThreads(nThreads)
+                    threadedImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+                    afwMath.convolve(threadedImage, inMaskedImage, kernel, convControl)
+                    self.assertMaskedImagesEqual(threadedImage, serialImage)
+
+    def testVectorizedConvolve(self):
+        """Test that convolution using SIMD instructions is bit-identical to scalar convolution
+        """
+        self.assertIn(mathDetail.getConvolveRowsInstructionSet(), ("AVX-512", "AVX2", "scalar"))
+
+        rng = numpy.random.RandomState(7)
+        inArray = rng.normal(100.0, 10.0, (61, 77))  # width is not a multiple of any vector length
+        inArray[20, 30] = numpy.nan
+        inArray[40, 5] = numpy.inf
+
+        gaussFunc1 = afwMath.GaussianFunction1D(1.0)
+        gaussKernel = afwMath.AnalyticKernel(9, 8, afwMath.GaussianFunction2D(2.0, 1.5, 0.3))
+        kernelImage = afwImage.ImageD(gaussKernel.getDimensions())
+        gaussKernel.computeImage(kernelImage, False)
+        kernelImage.getArray()[:, 0:2] = 0.0  # give the kernel some zero pixels
+        kernelList = [
+            afwMath.FixedKernel(kernelImage),
+            gaussKernel,
+            afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1),
+        ]
+
+        for outType, inType in ((numpy.float32, numpy.float32), (numpy.float64, numpy.float64),
+                                (numpy.float64, numpy.float32)):
+            inImage = afwImage.makeImageFromArray(inArray.astype(inType))
+            for kernel in kernelList:
+                for doNormalize in (False, True):
+                    convControl = afwMath.ConvolutionControl(doNormalize)
+                    try:
+                        mathDetail.setConvolveRowsSimdEnabled(False)
+                        self.assertEqual(mathDetail.getConvolveRowsInstructionSet(), "scalar")
+                        scalarImage = afwImage.makeImageFromArray(numpy.zeros_like(inArray, dtype=outType))
+                        afwMath.convolve(scalarImage, inImage, kernel, convControl)
+                    finally:
+                        mathDetail.setConvolveRowsSimdEnabled(True)
+                    simdImage = afwImage.makeImageFromArray(numpy.zeros_like(inArray, dtype=outType))
+                    afwMath.convolve(simdImage, inImage, kernel, convControl)
+                    self.assertImagesEqual(simdImage, scalarImage)
+
     @unittest.skipIf(dataDir is None, "afwdata not setup")
     def testUnityConvolution(self):
         """Verify that convolution with a centered delta function reproduces the original.
@@ -590,6 +590,46 @@ class ImageCompressionTestCase(lsst.utils.tests.TestCase):
             image = self.makeImage(cls)
             self.checkCompressedImage(cls, image, compression, scaling, atol=self.noise/quantize)
 
+    def testThreadedCompression(self):
+        """Test compressing tiles with multiple threads
+
+        With more than one thread, we compress the tiles ourselves rather
+        than letting cfitsio do it; the result should read back the same.
+        """
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(123, 456), lsst.geom.Extent2I(100, 77))
+        tilesList = ((16, 10), (0, 1), (0, 0), (-1, -1))
+        # Image class, compression algorithms and scaling BITPIX (0 for none).
+        # There is no 8-bit Image class, so 8-bit tiles are made by scaling.
+        cases = [(lsst.afw.image.ImageF, ("GZIP", "GZIP_SHUFFLE", "RICE"), 8),
+                 (lsst.afw.image.ImageU, ("GZIP", "GZIP_SHUFFLE", "RICE"), 0),
+                 (lsst.afw.image.ImageI, ("GZIP", "GZIP_SHUFFLE", "RICE"), 0),
+                 (lsst.afw.image.ImageF, ("GZIP", "GZIP_SHUFFLE"), 0),
+                 (lsst.afw.image.ImageD, ("GZIP", "GZIP_SHUFFLE"), 0),
+                 (lsst.afw.image.ImageF, ("GZIP_SHUFFLE", "RICE"), 16),
+                 (lsst.afw.image.ImageD, ("RICE",), 32)]
+        for (cls, algorithmList, bitpix), tiles in itertools.product(cases, tilesList):
+            image = self.makeImage(cls)
+            for algorithm in algorithmList:
+                with self.subTest(cls=cls, algorithm=algorithm, bitpix=bitpix, tiles=tiles):
+                    if bitpix:
+                        scaling = ImageScalingOptions(ImageScalingOptions.STDEV_BOTH, bitpix, fuzz=True)
+                    else:
+                        scaling = ImageScalingOptions()
+                    unpersisted = []
+                    for nThreads in (1, 4):
+                        compression = ImageCompressionOptions(
+                            lsst.afw.fits.compressionAlgorithmFromString(algorithm),
+                            np.array(tiles, dtype=np.int64), 0.0, nThreads)
+                        self.assertEqual(compression.nThreads, nThreads)
+                        options = lsst.afw.fits.ImageWriteOptions(compression, scaling)
+                        with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                            unpersisted.append(self.readWriteImage(cls, image, filename, options))
+                            checkAstropy(unpersisted[-1], filename, 1)
+                    self.assertEqual(unpersisted[1].getBBox(), image.getBBox())
+                    self.assertImagesEqual(unpersisted[1], unpersisted[0])
+                    if not bitpix:
+                        self.assertImagesEqual(unpersisted[1], image)
+
     def readWriteMaskedImage(self, image, filename, imageOptions, maskOptions, varianceOptions):
         """Read the MaskedImage after it has been written
 
@@ -732,6 +772,7 @@ def optionsToPropertySet(options):
     ps.set("compression.columns", options.compression.tiles[0])
     ps.set("compression.rows", options.compression.tiles[1])
     ps.set("compression.quantizeLevel", options.compression.quantizeLevel)
+    ps.set("compression.nThreads", options.compression.nThreads)
 
     ps.set("scaling.algorithm", lsst.afw.fits.scalingAlgorithmToString(options.scaling.algorithm))
     ps.set("scaling.bitpix", options.scaling.bitpix)
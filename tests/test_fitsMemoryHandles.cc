@@ -0,0 +1,51 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE fits - memory handles
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include <vector>
+
+#include "fitsio.h"
+
+#include "lsst/geom.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/image/ImageFitsReader.h"
+
+/*
+ * ExposureFitsReader reads HDUs concurrently through handles opened on one copy of a file in memory,
+ * each with its own MemFileManager.  Check that CFITSIO gives such handles independent internal state,
+ * so that reading an HDU through one leaves the other alone.
+ */
+BOOST_AUTO_TEST_CASE(testIndependentMemoryHandles) {
+    using namespace lsst::afw;
+
+    image::MaskedImage<float> maskedImage(lsst::geom::Extent2I(5, 4));
+    *maskedImage.getImage() = 1.5;
+    *maskedImage.getVariance() = 2.5;
+    fits::MemFileManager written;
+    maskedImage.writeFits(written);
+    std::vector<char> contents(static_cast<char *>(written.getData()),
+                               static_cast<char *>(written.getData()) + written.getLength());
+
+    fits::MemFileManager manager1(contents.data(), contents.size());
+    fits::MemFileManager manager2(contents.data(), contents.size());
+    fits::Fits fits1(manager1, "r", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+    fits::Fits fits2(manager2, "r", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+    BOOST_CHECK(reinterpret_cast<fitsfile *>(fits1.fptr)->Fptr !=
+                reinterpret_cast<fitsfile *>(fits2.fptr)->Fptr);
+
+    fits1.setHdu(1);  // image
+    fits2.setHdu(3);  // variance
+    image::ImageFitsReader varianceReader(&fits2);
+    auto variance = varianceReader.read<float>();
+    BOOST_CHECK_EQUAL(fits1.getHdu(), 1);
+    BOOST_CHECK_EQUAL(fits2.getHdu(), 3);
+    image::ImageFitsReader imageReader(&fits1);
+    auto image = imageReader.read<float>();
+    BOOST_CHECK_EQUAL(image(0, 0), 1.5);
+    BOOST_CHECK_EQUAL(variance(0, 0), 2.5);
+    BOOST_CHECK_EQUAL(fits2.getHdu(), 3);
+}
@@ -39,6 +39,7 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.geom as afwGeom
 import lsst.afw.geom.ellipses as afwGeomEllipses
 import lsst.afw.image as afwImage
@@ -1207,6 +1208,79 @@ class FootprintSetTestCase(unittest.TestCase):
 
         self.assertEqual(len(foot.getPeaks()), 5)
 
+    def testThreaded(self):
+        """Check that searching an image with several threads gives the same Footprints and peaks"""
+        rand = np.random.RandomState(12345)
+        mi = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(10, 20), lsst.geom.Extent2I(211, 307)))
+        mi.image.array[:] = rand.normal(0.0, 1.0, mi.image.array.shape)
+        mi.image.array[50:60, 100:110] = np.nan
+        mi.variance.array[:] = rand.uniform(0.5, 2.0, mi.variance.array.shape)
+
+        def getPeaks(fs):
+            """Return the peaks in each Footprint, with IDs relative to the set's first peak"""
+            peaks = [[(p.getId(), p.getIx(), p.getIy(), p.getPeakValue()) for p in foot.getPeaks()]
+                     for foot in fs.getFootprints()]
+            id0 = min(p[0] for footPeaks in peaks for p in footPeaks)
+            return [[(p[0] - id0,) + p[1:] for p in footPeaks] for footPeaks in peaks]
+
+        def assertFootprintSetsEqual(fs1, fs2):
+            self.assertEqual(len(fs1.getFootprints()), len(fs2.getFootprints()))
+            for foot1, foot2 in zip(fs1.getFootprints(), fs2.getFootprints()):
+                self.assertEqual(foot1.spans, foot2.spans)
+            self.assertEqual(getPeaks(fs1), getPeaks(fs2))
+
+        for threshold in (afwDetect.Threshold(1.0, afwDetect.Threshold.VALUE, True, 1.5),
+                          afwDetect.Threshold(1.0, afwDetect.Threshold.VALUE, False),
+                          afwDetect.Threshold(1.5, afwDetect.Threshold.PIXEL_STDEV)):
+            serial = afwDetect.FootprintSet(mi, threshold, "", 2)
+            self.assertGreater(len(serial.getFootprints()), 100)
+            for nThreads in (0, 4):
+                assertFootprintSetsEqual(serial,
+                                         afwDetect.FootprintSet(mi, threshold, "", 2, nThreads=nThreads))
+            assertFootprintSetsEqual(afwDetect.FootprintSet(mi.image, threshold, 2),
+                                     afwDetect.FootprintSet(mi.image, threshold, 2, nThreads=4))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwDetect.FootprintSet(mi, afwDetect.Threshold(1.0), nThreads=-1)
+
+    def testGrowThreaded(self):
+        """Check that growing a FootprintSet gives the Footprints detected in an image of the grown
+        Footprints, keeps every peak, and is the same for any number of threads"""
+        rand = np.random.RandomState(54321)
+        region = lsst.geom.Box2I(lsst.geom.Point2I(-5, 12), lsst.geom.Extent2I(157, 203))
+        image = afwImage.ImageF(region)
+        image.array[:] = rand.normal(0.0, 1.0, image.array.shape)
+        fs = afwDetect.FootprintSet(image, afwDetect.Threshold(2.0))
+        self.assertGreater(len(fs.getFootprints()), 50)
+        peakIds = {peak.getId() for foot in fs.getFootprints() for peak in foot.getPeaks()}
+
+        for isotropic, stencil in ((True, afwGeom.Stencil.CIRCLE), (False, afwGeom.Stencil.MANHATTAN)):
+            grown = afwDetect.FootprintSet(fs, 3, isotropic)
+
+            idImage = afwImage.ImageI(region)
+            for foot in fs.getFootprints():
+                foot.spans.dilated(3, stencil).clippedTo(region).setImage(idImage, 1)
+            detected = afwDetect.FootprintSet(idImage, afwDetect.Threshold(1), 1, False)
+            self.assertEqual([foot.spans for foot in grown.getFootprints()],
+                             [foot.spans for foot in detected.getFootprints()])
+            self.assertEqual({peak.getId() for foot in grown.getFootprints() for peak in foot.getPeaks()},
+                             peakIds)
+
+            for nThreads in (0, 4):
+                threaded = afwDetect.FootprintSet(fs, 3, isotropic, nThreads=nThreads)
+                self.assertEqual([foot.spans for foot in threaded.getFootprints()],
+                                 [foot.spans for foot in grown.getFootprints()])
+                self.assertEqual(
+                    [[peak.getId() for peak in foot.getPeaks()] for foot in threaded.getFootprints()],
+                    [[peak.getId() for peak in foot.getPeaks()] for foot in grown.getFootprints()])
+
+        merged = afwDetect.FootprintSet(fs)
+        merged.merge(fs, 1, 2)
+        threaded = afwDetect.FootprintSet(fs)
+        threaded.merge(fs, 1, 2, nThreads=4)
+        self.assertEqual([foot.spans for foot in threaded.getFootprints()],
+                         [foot.spans for foot in merged.getFootprints()])
+
 
 class MaskFootprintSetTestCase(unittest.TestCase):
     """A test case for generating FootprintSet from Masks"""
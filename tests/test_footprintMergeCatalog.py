@@ -298,6 +298,32 @@ class FootprintMergeCatalogTestCase(lsst.utils.tests.TestCase):
                     self.assertEqual(numPeak, 1)
                 peakIndex += 1
 
+    def testThreaded(self):
+        """Test that merging with multiple threads gives the same result as with one"""
+        catalogs = [self.catalog1, self.catalog2, self.catalog3]
+        names = ["1", "2", "3"]
+
+        def merge(nThreads):
+            schema = afwTable.SourceTable.makeMinimalSchema()
+            mergeList = afwDetect.FootprintMergeList(schema, names)
+            merged = mergeList.getMergedSourceCatalog(catalogs, names, 10, schema, self.idFactory,
+                                                      samePeakDist=40, nThreads=nThreads)
+            return [(list(record.getFootprint().getSpans()),
+                     [record.get("merge_footprint_" + name) for name in names],
+                     [(peak.getI(), [peak.get("merge_peak_" + name) for name in names])
+                      for peak in record.getFootprint().getPeaks()])
+                    for record in merged]
+
+        expected = merge(1)
+        self.assertEqual(len(expected), 19)
+        for nThreads in (0, 4):
+            self.assertEqual(merge(nThreads), expected)
+
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        mergeList = afwDetect.FootprintMergeList(schema, names)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            mergeList.addCatalog(self.table, self.catalog1, "1", nThreads=-1)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -137,6 +137,57 @@ class GaussianPsfTestCase(lsst.utils.tests.TestCase):
             # tolerance same as in self.testKernelImage
             self.assertFloatsAlmostEqual(image.getArray().sum(), 1.0, atol=1E-14)
 
+    def testCache(self):
+        def checkStatistics(hits, misses, evictions):
+            stats = self.psf.getCacheStatistics()
+            self.assertEqual((stats.hits, stats.misses, stats.evictions), (hits, misses, evictions))
+
+        checkStatistics(0, 0, 0)
+        image1 = self.psf.computeKernelImage()
+        image2 = self.psf.computeKernelImage()
+        self.assertImagesEqual(image1, image2)
+        checkStatistics(1, 1, 0)
+        # computeImage computes the kernel image too (which is the same everywhere for a GaussianPsf)
+        points = [lsst.geom.Point2D(x, 0.5*x) for x in (0.25, 1.5, 3.75)]
+        images = [self.psf.computeImage(point) for point in points]
+        checkStatistics(4, 4, 0)
+        for point, image in zip(points, images):
+            self.assertImagesEqual(self.psf.computeImage(point), image)
+        checkStatistics(7, 4, 0)
+
+        # Shrinking the cache keeps the most recently used images
+        self.psf.setCacheCapacity(2)
+        self.assertEqual(self.psf.getCacheCapacity(), 2)
+        checkStatistics(7, 4, 1)
+        self.psf.resetCacheStatistics()
+        self.assertImagesEqual(self.psf.computeImage(points[2]), images[2])
+        self.assertImagesEqual(self.psf.computeImage(points[0]), images[0])
+        checkStatistics(2, 1, 1)
+
+    def testBatch(self):
+        points = [lsst.geom.Point2D(x, 2.0*x - 3.0) for x in (-1.5, 0.0, 2.25, 10.0)]
+        images = self.psf.computeKernelImages(points)
+        self.assertEqual(len(images), len(points))
+        for point, image in zip(points, images):
+            self.assertImagesEqual(image, self.psf.computeKernelImage(point))
+        np.testing.assert_array_equal(self.psf.computeApertureFluxes(5.0, points),
+                                      [self.psf.computeApertureFlux(5.0, point) for point in points])
+        shapes = self.psf.computeShapes(points)
+        self.assertEqual(len(shapes), len(points))
+        for point, shape in zip(points, shapes):
+            self.assertEqual(shape, self.psf.computeShape(point))
+        self.assertEqual(len(self.psf.computeKernelImages([])), 0)
+
+        # A GaussianPsf is the same everywhere, so only one kernel image is computed
+        psf = lsst.afw.detection.GaussianPsf(self.kernelSize, self.kernelSize, 4.0)
+        psf.computeKernelImages(points, owner=lsst.afw.detection.Psf.INTERNAL)
+        self.assertEqual(psf.getCacheStatistics().misses, 1)
+
+        colors = [lsst.afw.image.Color()]*len(points)
+        self.assertEqual(len(self.psf.computeShapes(points, colors)), len(points))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            self.psf.computeApertureFluxes(5.0, points, colors[1:])
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
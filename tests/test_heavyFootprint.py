@@ -37,9 +37,11 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
 import lsst.afw.geom as afwGeom
+import lsst.afw.table as afwTable
 import lsst.afw.display.ds9 as ds9
 from lsst.log import Log
 
@@ -151,6 +153,55 @@ class HeavyFootprintTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsEqual(
             self.mi.getImage().getArray(), omi.getImage().getArray())
 
+    def testPooledStorage(self):
+        """Test that the HeavyFootprints of a FootprintSet share one buffer, including after persistence"""
+        mi = afwImage.MaskedImageF(40, 30)
+        rng = np.random.RandomState(12345)
+        mi.getImage().getArray()[:] = rng.uniform(-1.0, 3.0, size=(30, 40))
+        mi.getMask().getArray()[:] = rng.randint(0, 4, size=(30, 40))
+        mi.getVariance().getArray()[:] = rng.uniform(1.0, 2.0, size=(30, 40))
+        fs = afwDetect.FootprintSet(mi, afwDetect.Threshold(2))
+        fs.makeHeavy(mi)
+        heavies = fs.getFootprints()
+        self.assertGreater(len(heavies), 1)
+
+        def checkPooled(heavies):
+            for name in ("getImageArray", "getMaskArray", "getVarianceArray"):
+                arrays = [getattr(heavy, name)() for heavy in heavies]
+                for a, b in zip(arrays[:-1], arrays[1:]):
+                    self.assertEqual(a.__array_interface__["data"][0] + a.nbytes,
+                                     b.__array_interface__["data"][0])
+
+        def checkEqual(heavy1, heavy2):
+            self.assertEqual(list(heavy1.getSpans()), list(heavy2.getSpans()))
+            np.testing.assert_array_equal(heavy1.getImageArray(), heavy2.getImageArray())
+            np.testing.assert_array_equal(heavy1.getMaskArray(), heavy2.getMaskArray())
+            np.testing.assert_array_equal(heavy1.getVarianceArray(), heavy2.getVarianceArray())
+
+        checkPooled(heavies)
+        for heavy in heavies:
+            checkEqual(heavy, afwDetect.HeavyFootprintF(heavy, mi))
+
+        shared = afwDetect.HeavyFootprintF(heavies[0], heavies[0].getImageArray(),
+                                           heavies[0].getMaskArray(), heavies[0].getVarianceArray())
+        shared.getImageArray()[0] = -5.0
+        self.assertEqual(heavies[0].getImageArray()[0], -5.0)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwDetect.HeavyFootprintF(heavies[0], heavies[0].getImageArray()[:-1],
+                                      heavies[0].getMaskArray(), heavies[0].getVarianceArray())
+
+        cat = afwTable.SourceCatalog(afwTable.SourceTable.makeMinimalSchema())
+        for heavy in heavies:
+            cat.addNew().setFootprint(heavy)
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            cat.writeFits(filename)
+            cat2 = afwTable.SourceCatalog.readFits(filename)
+        heavies2 = [record.getFootprint() for record in cat2]
+        checkPooled(heavies2)
+        for heavy1, heavy2 in zip(heavies, heavies2):
+            self.assertTrue(heavy2.isHeavy())
+            checkEqual(heavy1, heavy2)
+
     def testXY0(self):
         """Test that inserting a HeavyFootprint obeys XY0"""
         fs = afwDetect.FootprintSet(self.mi, afwDetect.Threshold(1))
@@ -0,0 +1,105 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE detection - Psf threads
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "lsst/geom.h"
+#include "lsst/afw/detection/GaussianPsf.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace {
+
+using lsst::afw::detection::GaussianPsf;
+using lsst::afw::detection::Psf;
+
+bool imagesEqual(Psf::Image const& a, Psf::Image const& b) {
+    if (a.getBBox() != b.getBBox()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = 0; x < a.getWidth(); ++x) {
+            if (a(x, y) != b(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<lsst::geom::Point2D> makePositions() {
+    std::vector<lsst::geom::Point2D> positions;
+    for (int i = 0; i < 12; ++i) {
+        positions.emplace_back(10.0 + 3.25 * i, 20.0 - 1.5 * i);
+    }
+    return positions;
+}
+
+}  // namespace
+
+/*
+ * One Psf shared by many threads, with a cache small enough that images are evicted while other threads
+ * are copying them, must return the same images as a Psf used by a single thread.
+ */
+BOOST_AUTO_TEST_CASE(testConcurrentComputeImage) {
+    auto const positions = makePositions();
+    GaussianPsf reference(15, 17, 2.0);
+    std::vector<std::shared_ptr<Psf::Image>> images;
+    for (auto const& position : positions) {
+        images.push_back(reference.computeImage(position));
+    }
+    auto const kernelImage = reference.computeKernelImage();
+
+    GaussianPsf psf(15, 17, 2.0);
+    psf.setCacheCapacity(4);
+    std::atomic<int> nFailures(0);
+    int const n = 2000;
+    lsst::afw::math::detail::parallelFor(n, 8, [&](int i) {
+        std::size_t const j = i % positions.size();
+        if (!imagesEqual(*psf.computeImage(positions[j]), *images[j])) {
+            ++nFailures;
+        }
+        if (!imagesEqual(*psf.computeKernelImage(positions[j]), *kernelImage)) {
+            ++nFailures;
+        }
+        if (psf.getLocalKernel(positions[j])->getDimensions() != kernelImage->getDimensions()) {
+            ++nFailures;
+        }
+    });
+    BOOST_CHECK_EQUAL(nFailures.load(), 0);
+    // every call looks up at least one image (computing an image may look up its kernel image too)
+    auto const statistics = psf.getCacheStatistics();
+    BOOST_CHECK_GE(statistics.hits + statistics.misses, 3u * n);
+}
+
+/*
+ * The batch computeKernelImages, called concurrently on one Psf, must return the same images as
+ * computeKernelImage on a Psf used by a single thread.
+ */
+BOOST_AUTO_TEST_CASE(testConcurrentComputeKernelImages) {
+    auto const positions = makePositions();
+    GaussianPsf reference(15, 17, 2.0);
+    auto const kernelImage = reference.computeKernelImage();
+
+    GaussianPsf psf(15, 17, 2.0);
+    psf.setCacheCapacity(4);
+    std::atomic<int> nFailures(0);
+    lsst::afw::math::detail::parallelFor(500, 8, [&](int) {
+        auto const images = psf.computeKernelImages(positions);
+        if (images.size() != positions.size()) {
+            ++nFailures;
+            return;
+        }
+        for (auto const& image : images) {
+            if (!imagesEqual(*image, *kernelImage)) {
+                ++nFailures;
+            }
+        }
+    });
+    BOOST_CHECK_EQUAL(nFailures.load(), 0);
+}
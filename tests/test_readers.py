@@ -31,6 +31,7 @@ from lsst.afw.table import ExposureTable
 from lsst.afw.image import (Image, Mask, Exposure, LOCAL, PARENT, MaskPixel, VariancePixel,
                             ImageFitsReader, MaskFitsReader, MaskedImageFitsReader, ExposureFitsReader,
                             Filter, Calib, ApCorrMap, VisitInfo, TransmissionCurve, CoaddInputs)
+from lsst.afw.fits import Fits
 from lsst.afw.image.utils import defineFilter
 from lsst.afw.detection import GaussianPsf
 from lsst.afw.cameraGeom.testUtils import DetectorWrapper
@@ -201,6 +202,18 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
             reader, exposureIn, fileName, dtypesOut,
             compare=lambda a, b: self.assertMaskedImagesEqual(a.maskedImage, b.maskedImage)
         )
+        # Reading with threads uses independent file handles, but should give
+        # the same result.
+        for args in self.args:
+            with self.subTest(args=args, nThreads=4):
+                subIn = exposureIn.subset(*args) if args else exposureIn
+                exposure = ExposureFitsReader(fileName).read(*args, nThreads=4)
+                self.assertMaskedImagesEqual(subIn.maskedImage, exposure.maskedImage)
+                self.assertImagesEqual(exposureIn.getPsf().computeImage(),
+                                       exposure.getPsf().computeImage())
+                self.assertEqual(exposure.getInfo().getCoaddInputs().ccds[0].getPsf(), exposure.getPsf())
+                maskedImage = ExposureFitsReader(fileName).readMaskedImage(*args, nThreads=4)
+                self.assertMaskedImagesEqual(subIn.maskedImage, maskedImage)
 
     def testMultiPlaneFitsReaders(self):
         """Run tests for MaskedImageFitsReader and ExposureFitsReader.
@@ -251,6 +264,46 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
                     self.checkMaskedImageFitsReader(exposureIn, fileName, self.dtypes[n:])
                     self.checkExposureFitsReader(exposureIn, fileName, self.dtypes[n:])
 
+    def testThreadedMissingPlanes(self):
+        """Test that reading with threads replaces missing mask and variance
+        planes with default ones, as reading serially does.
+        """
+        imageIn = Image(self.bbox, dtype=np.float32)
+        imageIn.array[:, :] = np.random.randint(low=1, high=5, size=imageIn.array.shape)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            # An empty primary HDU and the image in HDU 1, as in an Exposure,
+            # but no mask or variance HDUs.
+            with Fits(fileName, "w") as fits:
+                fits.createEmpty()
+                imageIn.writeFits(fits)
+            for args in self.args:
+                with self.subTest(args=args):
+                    subIn = imageIn.subset(*args) if args else imageIn
+                    serial = ExposureFitsReader(fileName).readMaskedImage(*args)
+                    threaded = ExposureFitsReader(fileName).readMaskedImage(*args, nThreads=4)
+                    self.assertImagesEqual(threaded.image, subIn)
+                    self.assertMaskedImagesEqual(threaded, serial)
+                    self.assertTrue(np.all(threaded.mask.array == 0))
+                    self.assertTrue(np.all(threaded.variance.array == 0))
+                    exposure = ExposureFitsReader(fileName).read(*args, nThreads=4)
+                    self.assertMaskedImagesEqual(exposure.maskedImage, serial)
+
+    def testThreadedCompressedFile(self):
+        """Test that reading a gzipped file with threads falls back to
+        reading it serially, with the same result.
+        """
+        exposureIn = Exposure(self.bbox, dtype=np.float32)
+        shape = exposureIn.image.array.shape
+        exposureIn.image.array[:, :] = np.random.randint(low=1, high=5, size=shape)
+        exposureIn.mask.array[:, :] = np.random.randint(low=1, high=5, size=shape)
+        exposureIn.variance.array[:, :] = np.random.randint(low=1, high=5, size=shape)
+        with lsst.utils.tests.getTempFilePath(".fits.gz") as fileName:
+            exposureIn.writeFits(fileName)
+            with open(fileName, "rb") as stream:
+                self.assertEqual(stream.read(2), b"\x1f\x8b")
+            exposure = ExposureFitsReader(fileName).read(nThreads=4)
+            self.assertMaskedImagesEqual(exposure.maskedImage, exposureIn.maskedImage)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
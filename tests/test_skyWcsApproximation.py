@@ -0,0 +1,134 @@
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+
+import math
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.geom
+import lsst.pex.exceptions
+from lsst.afw.geom import (SkyWcsApproximation, makeSkyWcs, makeCdMatrix, makeModifiedWcs,
+                           makeRadialTransform)
+
+
+class SkyWcsApproximationTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.random = np.random.RandomState(1)
+        self.bbox = lsst.geom.Box2D(lsst.geom.Point2D(-10.0, -20.0), lsst.geom.Extent2D(2048.0, 4096.0))
+        self.scale = 0.2*lsst.geom.arcseconds
+        # a tangent point near RA = 0 exercises wrapping of the longitude
+        tanWcs = makeSkyWcs(crpix=lsst.geom.Point2D(1000.0, 1500.0),
+                            crval=lsst.geom.SpherePoint(0.01, -30.0, lsst.geom.degrees),
+                            cdMatrix=makeCdMatrix(scale=self.scale, orientation=20*lsst.geom.degrees))
+        self.wcs = makeModifiedWcs(pixelTransform=makeRadialTransform([0.0, 1.0, 0.0, 1E-9]),
+                                   wcs=tanWcs, modifyActualPixels=False)
+        self.maxError = 1E-4*lsst.geom.arcseconds
+        self.approx = SkyWcsApproximation(self.wcs, self.bbox, maxError=self.maxError)
+
+    def tearDown(self):
+        del self.wcs
+        del self.approx
+
+    def makeRandomPixels(self, n):
+        x = self.random.uniform(self.bbox.getMinX(), self.bbox.getMaxX(), n)
+        y = self.random.uniform(self.bbox.getMinY(), self.bbox.getMaxY(), n)
+        return x, y, [lsst.geom.Point2D(xi, yi) for xi, yi in zip(x, y)]
+
+    def testBasics(self):
+        self.assertEqual(self.approx.getBBox(), self.bbox)
+        self.assertLessEqual(self.approx.getMaxError(), self.maxError)
+        gridShape = self.approx.getGridShape()
+        self.assertGreaterEqual(gridShape.getX(), 5)
+        self.assertGreaterEqual(gridShape.getY(), 5)
+
+    def testPixelToSky(self):
+        x, y, pixels = self.makeRandomPixels(1000)
+        exact = self.wcs.pixelToSky(pixels)
+        approx = self.approx.pixelToSky(pixels)
+        maxSeparation = max(e.separation(a) for e, a in zip(exact, approx))
+        self.assertLessEqual(maxSeparation, self.approx.getMaxError())
+        for pixel, sky in zip(pixels[:10], approx[:10]):
+            self.assertSpherePointsAlmostEqual(self.approx.pixelToSky(pixel), sky,
+                                               maxSep=1E-12*lsst.geom.radians)
+
+        ra, dec = self.approx.pixelToSkyArray(x, y)
+        self.assertFloatsEqual(ra, np.array([sky.getLongitude().asRadians() for sky in approx]))
+        self.assertFloatsEqual(dec, np.array([sky.getLatitude().asRadians() for sky in approx]))
+        self.assertTrue(np.all(ra >= 0.0))
+        self.assertTrue(np.all(ra < 2*math.pi))
+
+    def testSkyToPixel(self):
+        x, y, pixels = self.makeRandomPixels(1000)
+        exact = self.wcs.pixelToSky(pixels)
+        approxPixels = self.approx.skyToPixel(exact)
+        # the position error is the angular error divided by the pixel scale
+        # (the radial distortion only changes the scale by a fraction of a percent)
+        maxPixelError = self.approx.getMaxError().asArcseconds()/(0.95*self.scale.asArcseconds())
+        for pixel, approxPixel in zip(pixels, approxPixels):
+            self.assertPairsAlmostEqual(pixel, approxPixel, maxDiff=maxPixelError)
+
+        # skyToPixel inverts the approximate pixelToSky to rounding error
+        for pixel, sky in zip(pixels[:100], self.approx.pixelToSky(pixels[:100])):
+            self.assertPairsAlmostEqual(pixel, self.approx.skyToPixel(sky), maxDiff=1E-7)
+
+        ra = np.array([sky.getLongitude().asRadians() for sky in exact])
+        dec = np.array([sky.getLatitude().asRadians() for sky in exact])
+        xApprox, yApprox = self.approx.skyToPixelArray(ra, dec)
+        self.assertFloatsEqual(xApprox, np.array([pixel.getX() for pixel in approxPixels]))
+        self.assertFloatsEqual(yApprox, np.array([pixel.getY() for pixel in approxPixels]))
+
+    def testNonFinite(self):
+        ra, dec = self.approx.pixelToSkyArray(np.array([np.nan, 5.0]), np.array([3.0, np.inf]))
+        self.assertTrue(np.all(np.isnan(ra)))
+        self.assertTrue(np.all(np.isnan(dec)))
+        # the far side of the sky cannot be projected onto the tangent plane
+        center = self.wcs.pixelToSky(self.bbox.getCenter())
+        antipode = lsst.geom.SpherePoint(center.getLongitude().asDegrees() + 180.0,
+                                         -center.getLatitude().asDegrees(), lsst.geom.degrees)
+        pixel = self.approx.skyToPixel(antipode)
+        self.assertTrue(math.isnan(pixel.getX()))
+        self.assertTrue(math.isnan(pixel.getY()))
+
+    def testErrors(self):
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            SkyWcsApproximation(self.wcs, lsst.geom.Box2D(lsst.geom.Point2D(0, 0), lsst.geom.Point2D(0, 10)))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            SkyWcsApproximation(self.wcs, self.bbox, maxError=0*lsst.geom.arcseconds)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            SkyWcsApproximation(self.wcs, self.bbox, maxGridSize=4)
+        with self.assertRaises(lsst.pex.exceptions.RuntimeError):
+            SkyWcsApproximation(self.wcs, self.bbox, maxError=1E-12*lsst.geom.arcseconds, maxGridSize=9)
+
+
+class MemoryTester(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
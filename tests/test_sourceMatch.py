@@ -307,6 +307,108 @@ class SourceMatchTestCase(lsst.utils.tests.TestCase):
                 catMismatches, cat2, 1.0*lsst.geom.arcseconds, mc)
             self.assertEqual(len(noMatches), 0)
 
+    def makeRandomCatalog(self, num, rng, firstId=0):
+        """Make a catalog with a dense clump of sources near the north pole and a sparse
+        distribution over the sky.
+        """
+        cat = afwTable.SourceCatalog(self.table)
+        coordKey = afwTable.SourceTable.getCoordKey()
+        for ii in range(num):
+            src = cat.addNew()
+            src.setId(firstId + ii)
+            if ii % 4 == 0:
+                ra = rng.uniform(0.0, 360.0)
+                dec = np.degrees(np.arcsin(rng.uniform(-1.0, 1.0)))
+            else:
+                ra = rng.uniform(0.0, 360.0)
+                dec = 90.0 - rng.uniform(0.0, 0.05)
+            src.set(coordKey.getRa(), ra*lsst.geom.degrees)
+            src.set(coordKey.getDec(), dec*lsst.geom.degrees)
+        return cat
+
+    def assertMatchListsEqual(self, matches1, matches2):
+        self.assertEqual(len(matches1), len(matches2))
+        for m1, m2 in zip(matches1, matches2):
+            self.assertEqual(m1.first.getId(), m2.first.getId())
+            if m1.second is None:
+                self.assertIsNone(m2.second)
+            else:
+                self.assertEqual(m1.second.getId(), m2.second.getId())
+            self.assertEqualFloat(m1.distance, m2.distance)
+
+    def testThreadedMatchRaDec(self):
+        """Test that matchRaDec gives the same result with any number of threads,
+        and finds all pairs within the match radius.
+        """
+        rng = np.random.RandomState(54321)
+        cat1 = self.makeRandomCatalog(800, rng)
+        cat2 = self.makeRandomCatalog(1200, rng, firstId=10000)
+        radius = 20.0*lsst.geom.arcseconds
+
+        def unitVectors(cat):
+            ra = np.array([src.getRa().asRadians() for src in cat])
+            dec = np.array([src.getDec().asRadians() for src in cat])
+            return np.array([np.cos(ra)*np.cos(dec), np.sin(ra)*np.cos(dec), np.sin(dec)]).T
+
+        def separations(v1, v2):
+            chord = np.sqrt(((v1[:, np.newaxis, :] - v2[np.newaxis, :, :])**2).sum(axis=2))
+            return 2.0*np.arcsin(0.5*chord)
+
+        ids1 = np.array([src.getId() for src in cat1])
+        ids2 = np.array([src.getId() for src in cat2])
+        v1 = unitVectors(cat1)
+        i1, i2 = np.nonzero(separations(v1, unitVectors(cat2)) < radius.asRadians())
+        expected = set(zip(ids1[i1], ids2[i2]))
+        self.assertGreater(len(expected), 0)
+        i1, i2 = np.nonzero(separations(v1, v1) < radius.asRadians())
+        nSelfPairs = np.sum(i1 < i2)
+
+        for closest, includeMismatches in ((False, False), (True, False), (True, True)):
+            mc = afwTable.MatchControl()
+            mc.findOnlyClosest = closest
+            mc.includeMismatches = includeMismatches
+            serial = afwTable.matchRaDec(cat1, cat2, radius, mc)
+            if not closest:
+                self.assertEqual(set((m.first.getId(), m.second.getId()) for m in serial), expected)
+            for nThreads in (0, 3):
+                mc.nThreads = nThreads
+                self.assertMatchListsEqual(afwTable.matchRaDec(cat1, cat2, radius, mc), serial)
+
+        for symmetric in (False, True):
+            mc = afwTable.MatchControl()
+            mc.symmetricMatch = symmetric
+            serial = afwTable.matchRaDec(cat1, radius, mc)
+            self.assertEqual(len(serial), (2 if symmetric else 1)*nSelfPairs)
+            mc.nThreads = 4
+            self.assertMatchListsEqual(afwTable.matchRaDec(cat1, radius, mc), serial)
+
+        mc = afwTable.MatchControl()
+        mc.nThreads = -1
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwTable.matchRaDec(cat1, cat2, radius, mc)
+
+    def testMismatchesBeyondCatalog(self):
+        """Test that sources beyond the declination range of the second catalog are
+        reported as mismatches.
+        """
+        coordKey = afwTable.SourceTable.getCoordKey()
+        cat1 = afwTable.SourceCatalog(self.table)
+        cat2 = afwTable.SourceCatalog(self.table)
+        for ii, dec in enumerate((10.0, 20.0, 30.0)):
+            src = cat1.addNew()
+            src.setId(ii)
+            src.set(coordKey, lsst.geom.SpherePoint(10.0, dec, lsst.geom.degrees))
+        src = cat2.addNew()
+        src.setId(100)
+        src.set(coordKey, lsst.geom.SpherePoint(10.0, 10.0, lsst.geom.degrees))
+        mc = afwTable.MatchControl()
+        mc.includeMismatches = True
+        matches = afwTable.matchRaDec(cat1, cat2, 1.0*lsst.geom.arcseconds, mc)
+        self.assertEqual([m.first.getId() for m in matches], [0, 1, 2])
+        self.assertEqual(matches[0].second.getId(), 100)
+        self.assertIsNone(matches[1].second)
+        self.assertIsNone(matches[2].second)
+
     def checkMatchToFromCatalog(self, matches, catalog):
         """Check the conversion of matches to and from a catalog
 
@@ -149,6 +149,42 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(bBox.getMinX(), -1)
         self.assertEqual(bBox.getMinY(), -1)
 
+    @staticmethod
+    def makeRandomSpanSet(rng, shape, fill):
+        """Return a SpanSet of randomly chosen pixels, and the set of their (x, y)
+        """
+        pixels = {(x, y) for y, x in zip(*np.nonzero(rng.uniform(size=shape) < fill))}
+        spans = [afwGeom.Span(y, x, x) for x, y in pixels]
+        return afwGeom.SpanSet(spans), pixels
+
+    @staticmethod
+    def getPixels(spanSet):
+        return {(point.getX(), point.getY()) for span in spanSet for point in span}
+
+    def testOperationsAgainstPixels(self):
+        """Compare the run-based operations with the same operations on sets of pixels
+        """
+        rng = np.random.RandomState(12345)
+        for fill in (0.3, 0.7, 0.95):
+            first, firstPixels = self.makeRandomSpanSet(rng, (20, 25), fill)
+            second, secondPixels = self.makeRandomSpanSet(rng, (25, 20), fill)
+            self.assertEqual(self.getPixels(first.intersect(second)), firstPixels & secondPixels)
+            self.assertEqual(self.getPixels(first.intersectNot(second)), firstPixels - secondPixels)
+            self.assertEqual(self.getPixels(first.union(second)), firstPixels | secondPixels)
+            for stencil in (afwGeom.Stencil.CIRCLE, afwGeom.Stencil.BOX, afwGeom.Stencil.MANHATTAN):
+                for radius in (1, 2, 3):
+                    kernel = self.getPixels(afwGeom.SpanSet.fromShape(radius, stencil))
+                    dilatedPixels = {(x + dx, y + dy) for x, y in firstPixels for dx, dy in kernel}
+                    erodedPixels = {(x, y) for x, y in firstPixels
+                                    if all((x + dx, y + dy) in firstPixels for dx, dy in kernel)}
+                    dilated = first.dilated(radius, stencil)
+                    eroded = first.eroded(radius, stencil)
+                    self.assertEqual(self.getPixels(dilated), dilatedPixels)
+                    self.assertEqual(self.getPixels(eroded), erodedPixels)
+                    # The results are normalized: one Span for each run of pixels
+                    self.assertEqual(dilated, afwGeom.SpanSet(list(dilated)))
+                    self.assertEqual(eroded, afwGeom.SpanSet(list(eroded)))
+
     def testFlatten(self):
         # Give an initial value to an input array
         inputArray = np.ones((6, 6)) * 9
@@ -405,6 +405,91 @@ class StackTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(stack.mask[1, 1, afwImage.LOCAL], clipped)
         self.assertEqual(stack.mask[1, 2, afwImage.LOCAL], rejected)
 
+    def makeRandomMaskedImages(self, bbox, num):
+        """Make a list of MaskedImages with random pixels, some of them masked."""
+        images = []
+        for i in range(num):
+            mimg = afwImage.MaskedImageF(bbox)
+            mimg.image.array[:, :] = np.random.normal(10.0, 1.0, mimg.image.array.shape)
+            mimg.image.array[np.random.uniform(size=mimg.image.array.shape) < 0.05] += 100.0
+            mimg.variance.array[:, :] = np.random.uniform(0.5, 2.0, mimg.variance.array.shape)
+            mimg.mask.array[np.random.uniform(size=mimg.mask.array.shape) < 0.1] = 0x1
+            images.append(mimg)
+        return images
+
+    def testThreadedStack(self):
+        """Test that threaded stacking gives exactly the same result as unthreaded stacking"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(5, -3), lsst.geom.Extent2I(self.nX, self.nY))
+        images = self.makeRandomMaskedImages(bbox, self.nImg)
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(0x1)
+        sctrl.setWeighted(True)
+        with self.assertRaises(pexEx.InvalidParameterError):
+            sctrl.setNThreads(-1)
+
+        for flag in (afwMath.MEAN, afwMath.MEANCLIP, afwMath.MEDIAN):
+            sctrl.setNThreads(1)
+            serial = afwMath.statisticsStack(images, flag, sctrl, clipped=0x2)
+            for nThreads in (0, 3, 2*self.nY):
+                sctrl.setNThreads(nThreads)
+                threaded = afwMath.statisticsStack(images, flag, sctrl, clipped=0x2)
+                self.assertMaskedImagesEqual(threaded, serial)
+
+        imgList = [mimg.image for mimg in images]
+        sctrl.setNThreads(1)
+        serial = afwMath.statisticsStack(imgList, afwMath.MEDIAN, sctrl)
+        sctrl.setNThreads(4)
+        threaded = afwMath.statisticsStack(imgList, afwMath.MEDIAN, sctrl)
+        self.assertImagesEqual(threaded, serial)
+
+    def testBlockReaderStack(self):
+        """Test stacking inputs that are read a block of rows at a time"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(5, -3), lsst.geom.Extent2I(self.nX, self.nY))
+        images = self.makeRandomMaskedImages(bbox, 5)
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(0x1)
+        maskMap = [(0x1, 0x4)]
+        expected = afwMath.statisticsStack(images, afwMath.MEANCLIP, sctrl, [], 0x2, maskMap)
+
+        requested = []
+
+        def makeReader(mimg):
+            def reader(box):
+                requested.append(box)
+                return afwImage.MaskedImageF(mimg, box, afwImage.PARENT, True)
+            return reader
+
+        sctrl.setNThreads(2)
+        for blockHeight in (1, 7, self.nY, 2*self.nY):
+            del requested[:]
+            out = afwImage.MaskedImageF(bbox)
+            afwMath.statisticsStack(out, [makeReader(mimg) for mimg in images], afwMath.MEANCLIP, sctrl,
+                                    [], 0x2, maskMap, blockHeight=blockHeight)
+            self.assertMaskedImagesEqual(out, expected)
+            nBlocks = (self.nY + blockHeight - 1)//blockHeight
+            self.assertEqual(len(requested), nBlocks*len(images))
+            self.assertTrue(all(bbox.contains(box) and box.getHeight() <= blockHeight for box in requested))
+
+        # Stream the inputs from FITS files
+        with lsst.utils.tests.getTempFilePath("_0.fits") as fileName0, \
+                lsst.utils.tests.getTempFilePath("_1.fits") as fileName1:
+            fileNames = [fileName0, fileName1]
+            for mimg, fileName in zip(images, fileNames):
+                mimg.writeFits(fileName)
+            readers = [lambda box, fileName=fileName: afwImage.MaskedImageF(fileName, bbox=box)
+                       for fileName in fileNames]
+            out = afwImage.MaskedImageF(bbox)
+            afwMath.statisticsStack(out, readers, afwMath.MEAN, sctrl, [], 0x2, maskMap, blockHeight=10)
+            expected = afwMath.statisticsStack(images[:2], afwMath.MEAN, sctrl, [], 0x2, maskMap)
+            self.assertMaskedImagesEqual(out, expected)
+
+        with self.assertRaises(pexEx.InvalidParameterError):
+            afwMath.statisticsStack(out, [makeReader(mimg) for mimg in images], afwMath.MEAN, sctrl,
+                                    [], 0x2, maskMap, blockHeight=0)
+        with self.assertRaises(pexEx.InvalidParameterError):
+            afwMath.statisticsStack(out, [lambda box: images[0]], afwMath.MEAN, sctrl, [], 0x2, maskMap,
+                                    blockHeight=8)
+
 #################################################################
 # Test suite boiler plate
 #################################################################
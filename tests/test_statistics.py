@@ -577,6 +577,42 @@ class StatisticsTestCase(lsst.utils.tests.TestCase):
             mask[1, 1] = maskVal
             self.assertEqual(afwMath.makeStatistics(image, mask, afwMath.NMASKED, ctrl).getValue(), 1)
 
+    def testLargeImageQuantiles(self):
+        """Test that the quantiles of large images, which are found without copying the pixels,
+        are identical to those found by sorting a copy"""
+        np.random.seed(12345)
+        maskVal = 0x1
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(maskVal)
+        for dtype, ImageClass in ((np.float32, afwImage.ImageF), (np.float64, afwImage.ImageD)):
+            for scale in (1.0, 1.0e-30):
+                image = ImageClass(150, 110)
+                values = np.random.normal(1000.0, 30.0, image.array.shape)
+                # bright objects, far outside the histogram range
+                bright = np.random.uniform(size=values.shape) < 0.05
+                values[bright] += np.random.uniform(0.0, 50000.0, bright.sum())
+                image.array[:] = (scale*values).astype(dtype)
+                mask = afwImage.Mask(image.getBBox())
+                mask.array[np.random.uniform(size=values.shape) < 0.1] = maskVal
+                good = image.array[mask.array == 0].astype(np.float64)
+
+                flags = afwMath.MEDIAN | afwMath.IQRANGE | afwMath.MEANCLIP | afwMath.STDEVCLIP
+                stats = afwMath.makeStatistics(image, mask, flags, ctrl)
+                median = afwMath.makeStatistics(image, mask, afwMath.MEDIAN, ctrl).getValue()
+                # without NaN checks, the pixels are copied and sorted
+                ctrl.setNanSafe(False)
+                sortedStats = afwMath.makeStatistics(image, mask, flags, ctrl)
+                sortedMedian = afwMath.makeStatistics(image, mask, afwMath.MEDIAN, ctrl).getValue()
+                ctrl.setNanSafe(True)
+
+                for prop in (afwMath.MEDIAN, afwMath.IQRANGE, afwMath.MEANCLIP, afwMath.STDEVCLIP):
+                    self.assertEqual(stats.getValue(prop), sortedStats.getValue(prop))
+                self.assertEqual(median, sortedMedian)
+                self.assertEqual(median, stats.getValue(afwMath.MEDIAN))
+                self.assertFloatsAlmostEqual(median, np.median(good), rtol=1e-12)
+                q1, q3 = np.percentile(good, [25, 75])
+                self.assertFloatsAlmostEqual(stats.getValue(afwMath.IQRANGE), q3 - q1, rtol=1e-10)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
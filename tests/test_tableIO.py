@@ -26,6 +26,7 @@ import numpy as np
 import astropy.io.fits
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.table
 import lsst.afw.image
@@ -69,6 +70,130 @@ class TableIoTestCase(lsst.utils.tests.TestCase):
             # python-accessible FITS header reader) returns a PropertySet, but we want a PropertyList
             # and it doesn't up-convert easily.
 
+    def testBlockedWriting(self):
+        """Test that records are written correctly when the writer buffers
+        columns in blocks of rows: with rows this large, each block holds
+        only about a hundred of them.
+        """
+        schema = lsst.afw.table.Schema()
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(11)]
+        intKey = schema.addField("i", type=np.int32, doc="int")
+        angleKey = schema.addField("a", type="Angle", doc="angle")
+        stringKey = schema.addField("s", type=str, size=8, doc="fixed-length string")
+        arrayKey = schema.addField("f", type="ArrayF", size=10000, doc="fixed-length array")
+        varArrayKey = schema.addField("v", type="ArrayI", size=0, doc="variable-length array")
+        varStringKey = schema.addField("vs", type=str, size=0, doc="variable-length string")
+        nRecords = 250
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for n in range(nRecords):
+            record = cat.addNew()
+            for i, flagKey in enumerate(flagKeys):
+                record.set(flagKey, (n + i) % 3 == 0)
+            record.set(intKey, n)
+            record.set(angleKey, n*lsst.geom.degrees)
+            record.set(stringKey, "s%d" % n)
+            record.set(arrayKey, np.arange(10000, dtype=np.float32) + n)
+            record.set(varArrayKey, np.arange(n % 7, dtype=np.int32))
+            record.set(varStringKey, "x"*(n % 5))
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            readCat = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+            with astropy.io.fits.open(tmpFile) as inFits:
+                astropyFlags = inFits[1].data["flags"]
+        self.assertEqual(len(readCat), nRecords)
+        for n, (record, readRecord) in enumerate(zip(cat, readCat)):
+            for i, flagKey in enumerate(flagKeys):
+                self.assertEqual(readRecord.get(flagKey), record.get(flagKey))
+                self.assertEqual(astropyFlags[n][i], record.get(flagKey))
+            self.assertEqual(readRecord.get(intKey), n)
+            self.assertEqual(readRecord.get(angleKey), record.get(angleKey))
+            self.assertEqual(readRecord.get(stringKey), record.get(stringKey))
+            self.assertFloatsEqual(readRecord.get(arrayKey), record.get(arrayKey))
+            self.assertFloatsEqual(readRecord.get(varArrayKey), record.get(varArrayKey))
+            self.assertEqual(readRecord.get(varStringKey), record.get(varStringKey))
+
+    def testColumnSelection(self):
+        """Test reading only some of the columns of a FITS table.
+        """
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        aKey = schema.addField("a", type=np.float64, doc="a")
+        bKey = schema.addField("b", type=np.int32, doc="b")
+        cKey = schema.addField("c", type="ArrayF", size=3, doc="c")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(3)]
+        cat = lsst.afw.table.SourceCatalog(schema)
+        for n in range(20):
+            record = cat.addNew()
+            record.set(aKey, 0.5*n)
+            record.set(bKey, n)
+            record.set(cKey, np.array([n, n + 1, n + 2], dtype=np.float32))
+            for i, flagKey in enumerate(flagKeys):
+                record.set(flagKey, (n + i) % 2 == 0)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            readCat = lsst.afw.table.SourceCatalog.readFits(tmpFile, columns=["a", "flag1"])
+            with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                lsst.afw.table.SourceCatalog.readFits(tmpFile, columns=["a", "nonexistent"])
+        # The fields of the minimal schema are always read.
+        names = lsst.afw.table.SourceTable.makeMinimalSchema().getNames() | {"a", "flag1"}
+        self.assertEqual(readCat.schema.getNames(), names)
+        self.assertEqual(len(readCat), len(cat))
+        readFlagKey = readCat.schema.find("flag1").key
+        for record, readRecord in zip(cat, readCat):
+            self.assertEqual(readRecord.getId(), record.getId())
+            self.assertEqual(readRecord.get("a"), record.get(aKey))
+            self.assertEqual(readRecord.get(readFlagKey), record.get(flagKeys[1]))
+
+    def testMappedFitsTable(self):
+        """Test column access through a memory-mapped FITS table.
+        """
+        schema = lsst.afw.table.Schema()
+        keys = {
+            "b": schema.addField("b", type=np.uint8, doc="uint8"),
+            "u": schema.addField("u", type=np.uint16, doc="uint16"),
+            "i": schema.addField("i", type=np.int32, doc="int32"),
+            "l": schema.addField("l", type=np.int64, doc="int64"),
+            "f": schema.addField("f", type=np.float32, doc="float"),
+            "d": schema.addField("d", type=np.float64, doc="double"),
+            "a": schema.addField("a", type="ArrayD", size=3, doc="array"),
+        }
+        angleKey = schema.addField("angle", type="Angle", doc="angle")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(10)]
+        varKey = schema.addField("v", type="ArrayI", size=0, doc="variable-length array")
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for n in range(50):
+            record = cat.addNew()
+            record.set(keys["b"], n)
+            record.set(keys["u"], 65000 - n)
+            record.set(keys["i"], -n)
+            record.set(keys["l"], n << 40)
+            record.set(keys["f"], 0.25*n)
+            record.set(keys["d"], 0.125*n)
+            record.set(keys["a"], np.array([n, 2*n, 3*n], dtype=np.float64))
+            record.set(angleKey, 0.01*n*lsst.geom.radians)
+            for i, flagKey in enumerate(flagKeys):
+                record.set(flagKey, (n + i) % 3 == 0)
+            record.set(varKey, np.arange(n % 4, dtype=np.int32))
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            mapped = lsst.afw.table.MappedFitsTable(tmpFile)
+        # The file is still mapped after it has been removed.
+        self.assertEqual(len(mapped), len(cat))
+        self.assertEqual(mapped.schema.getNames(), schema.getNames())
+        for name in keys:
+            self.assertFloatsEqual(mapped[name], cat[name])
+            self.assertFloatsEqual(mapped[schema.find(name).key], cat[name])
+        self.assertFloatsEqual(mapped["angle"], cat["angle"])
+        for flagKey in flagKeys:
+            self.assertTrue(np.all(mapped[flagKey] == cat[flagKey]))
+        column = mapped["d"]
+        del mapped
+        self.assertFloatsEqual(column, cat["d"])
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            mapped = lsst.afw.table.MappedFitsTable(tmpFile)
+            with self.assertRaises(lsst.pex.exceptions.LogicError):
+                mapped[varKey]
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
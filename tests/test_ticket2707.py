@@ -22,7 +22,10 @@
 
 import unittest
 
+import numpy as np
+
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.table as afwTable
 import lsst.utils.tests
 
@@ -153,6 +156,85 @@ class MatchXyTest(unittest.TestCase):
             # produces s1,s2 and s2,s1.
             self.assertEqual(len(matches), 2 if symmetric else 1)
 
+    def makeRandomCatalog(self, num, rng):
+        cat = afwTable.SourceCatalog(self.table)
+        centroidKey = afwTable.Point2DKey(self.schema["cen"])
+        for i in range(num):
+            record = cat.addNew()
+            record.setId(i)
+            # integer positions give many ties
+            x, y = rng.randint(0, 50, size=2)
+            if i % 17 == 0:
+                x = float('nan')
+            record.set(centroidKey, lsst.geom.Point2D(x, y))
+        return cat
+
+    def testXyIndex(self):
+        """Test radius and nearest-neighbor searches of an XyIndex"""
+        rng = np.random.RandomState(5)
+        cat = self.makeRandomCatalog(500, rng)
+        x = np.array([record.getX() for record in cat])
+        y = np.array([record.getY() for record in cat])
+        for index in (afwTable.XyIndex(cat), afwTable.XyIndex(x, y)):
+            self.assertEqual(len(index), len(cat))
+            for center in (lsst.geom.Point2D(10.0, 20.0), lsst.geom.Point2D(25.5, 3.25)):
+                d2 = (x - center.getX())**2 + (y - center.getY())**2
+                for radius in (0.5, 3.0, 7.0):
+                    expected = list(np.flatnonzero(d2 < radius**2))
+                    self.assertEqual(index.findWithin(center, radius), expected)
+                good = np.isfinite(d2)
+                order = np.lexsort((np.arange(len(d2))[good], d2[good]))
+                expected = list(np.flatnonzero(good)[order])
+                for n in (1, 5, 20):
+                    self.assertEqual(index.findNearest(center, n), expected[:n])
+                self.assertEqual(index.findNearest(center, 10000), expected)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwTable.XyIndex(x, y[1:])
+
+    def testMatchXyWithIndex(self):
+        """Test that matchXy gives the same results with a reused index and with threads"""
+        rng = np.random.RandomState(6)
+        cat1 = self.makeRandomCatalog(300, rng)
+        cat2 = self.makeRandomCatalog(400, rng)
+        index2 = afwTable.XyIndex(cat2)
+
+        def assertSameMatches(matches1, matches2):
+            self.assertEqual(len(matches1), len(matches2))
+            for m1, m2 in zip(matches1, matches2):
+                self.assertEqual(m1.first.getId(), m2.first.getId())
+                self.assertEqual(m1.second is None, m2.second is None)
+                if m1.second is not None:
+                    self.assertEqual(m1.second.getId(), m2.second.getId())
+                    self.assertEqual(m1.distance, m2.distance)
+
+        for closest, includeMismatches in ((True, False), (True, True), (False, False)):
+            mc = afwTable.MatchControl()
+            mc.findOnlyClosest = closest
+            mc.includeMismatches = includeMismatches
+            for radius in (0.5, 1.5):
+                matches = afwTable.matchXy(cat1, cat2, radius, mc)
+                self.assertGreater(len(matches), 0)
+                assertSameMatches(afwTable.matchXy(cat1, cat2, index2, radius, mc), matches)
+                mc.nThreads = 3
+                assertSameMatches(afwTable.matchXy(cat1, cat2, index2, radius, mc), matches)
+                mc.nThreads = 1
+                if not closest:
+                    pairs = set((m.first.getId(), m.second.getId()) for m in matches)
+                    expected = set((r1.getId(), r2.getId()) for r1 in cat1 for r2 in cat2
+                                   if (r1.getX() - r2.getX())**2 + (r1.getY() - r2.getY())**2 < radius**2)
+                    self.assertEqual(pairs, expected)
+
+        for symmetric in (True, False):
+            mc = afwTable.MatchControl()
+            mc.symmetricMatch = symmetric
+            matches = afwTable.matchXy(cat2, 1.5, mc)
+            assertSameMatches(afwTable.matchXy(cat2, cat2, index2, 1.5, mc), matches)
+            mc.nThreads = 0
+            assertSameMatches(afwTable.matchXy(cat2, 1.5, mc), matches)
+
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwTable.matchXy(cat2, cat1, index2, 1.5)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -235,6 +235,108 @@ class WarpExposureTestCase(lsst.utils.tests.TestCase):
                 self.assertEqual(
                     wc.getMaskWarpingKernel().getCacheSize(), newCacheSize)
 
+    def testWarpingControlNThreads(self):
+        """Test the nThreads parameter of WarpingControl
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getNThreads(), 1)
+        for nThreads in (0, 1, 4):
+            wc.setNThreads(nThreads)
+            self.assertEqual(wc.getNThreads(), nThreads)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            wc.setNThreads(-1)
+
+    def testLanczosTable(self):
+        """Test warping with Lanczos lookup tables against warping with exact Lanczos kernels
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getLanczosTableOversampling(), 0)
+        wc.setLanczosTableOversampling(1024)
+        self.assertEqual(wc.getLanczosTableOversampling(), 1024)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            wc.setLanczosTableOversampling(-1)
+
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees),
+        )
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(1000, 100, size=shape)
+        srcArrays[2][:] = np.random.normal(900, 90, size=shape)
+        srcArrays[1][:] = np.reshape(np.arange(0, shape[0]*shape[1], 1, dtype=np.uint16), shape)
+
+        for kernelName, maskKernelName in (("lanczos3", ""),
+                                           ("lanczos4", "lanczos2"),
+                                           ("lanczos5", "bilinear")):
+            exactControl = afwMath.WarpingControl(kernelName, maskKernelName)
+            exactImage = afwImage.MaskedImageF(110, 121)
+            exactNumGood = afwMath.warpImage(exactImage, destWcs, srcMaskedImage, srcWcs, exactControl)
+
+            maxErrors = []
+            for oversampling in (16, 1024):
+                tableControl = afwMath.WarpingControl(kernelName, maskKernelName)
+                tableControl.setLanczosTableOversampling(oversampling)
+                tableImage = afwImage.MaskedImageF(110, 121)
+                tableNumGood = afwMath.warpImage(tableImage, destWcs, srcMaskedImage, srcWcs, tableControl)
+                self.assertEqual(tableNumGood, exactNumGood)
+                self.assertMasksEqual(tableImage.getMask(), exactImage.getMask())
+                good = np.isfinite(exactImage.getImage().getArray())
+                maxErrors.append(np.max(np.abs(tableImage.getImage().getArray()[good] -
+                                               exactImage.getImage().getArray()[good])))
+            # each 1-d kernel value is in error by less than 5e-7 for oversampling = 1024
+            self.assertLess(maxErrors[1], 0.01)
+            self.assertLess(maxErrors[1], maxErrors[0])
+
+    def testThreadedWarp(self):
+        """Test that warping with several threads is bit-identical to warping with one thread
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees, orientation=12*lsst.geom.degrees),
+        )
+
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+        srcArrays[1][:] = np.reshape(np.arange(0, shape[0]*shape[1], 1, dtype=np.uint16), shape)
+        srcExposure = afwImage.ExposureF(srcMaskedImage, srcWcs)
+
+        for kernelName, maskKernelName, cacheSize in (("lanczos3", "bilinear", 0),
+                                                      ("lanczos4", "", 10000),
+                                                      ("bilinear", "", 0)):
+            for interpLength in (0, 1, 7):
+                warpControl = afwMath.WarpingControl(kernelName, maskKernelName, cacheSize, interpLength)
+                serialExposure = afwImage.ExposureF(afwImage.MaskedImageF(110, 121), destWcs)
+                serialNumGood = afwMath.warpExposure(serialExposure, srcExposure, warpControl)
+                serialImage = afwImage.ImageF(110, 121)
+                afwMath.warpImage(serialImage, destWcs, srcMaskedImage.getImage(), srcWcs, warpControl)
+                for nThreads in (0, 2, 3, 16):
+                    warpControl.setNThreads(nThreads)
+                    threadedExposure = afwImage.ExposureF(afwImage.MaskedImageF(110, 121), destWcs)
+                    threadedNumGood = afwMath.warpExposure(threadedExposure, srcExposure, warpControl)
+                    self.assertEqual(threadedNumGood, serialNumGood)
+                    self.assertMaskedImagesEqual(threadedExposure.getMaskedImage(),
+                                                 serialExposure.getMaskedImage())
+                    threadedImage = afwImage.ImageF(110, 121)
+                    afwMath.warpImage(threadedImage, destWcs, srcMaskedImage.getImage(), srcWcs, warpControl)
+                    self.assertImagesEqual(threadedImage, serialImage)
+
     def testWarpingControlError(self):
         """Test error handling of WarpingControl
         """